@@ -11,14 +11,44 @@
 
 #include "common.h"
 
+// Selects the layout of all ids at compile time. 32-bit ids have 24
+// index bits and 8 generation bits, ie 16M slots that can each be 
+// reused 255 times. 64-bit ids have 32 index bits and 32 generation 
+// bits, at the cost of twice the memory per stored id
+#if !defined(USE_64BIT_IDS)
+#define USE_64BIT_IDS       0
+#endif
+
 namespace muggy::id
 {
-    using id_type = uint32_t;
+    // Describes how an id is split into index and generation. The
+    // index is stored in the low bits
+    template <typename T, uint32_t GenerationBits>
+    struct id_layout
+    {
+        static_assert( std::is_unsigned<T>::value, "Ids must be unsigned" );
+        static_assert( GenerationBits > 0 && GenerationBits < sizeof( T ) * 8 );
+
+        using type = T;
+        static constexpr uint32_t generationBits{ GenerationBits };
+        static constexpr uint32_t indexBits{ sizeof( T ) * 8 - GenerationBits };
+    };
+
+    using id_layout_32 = id_layout<uint32_t, 8>;
+    using id_layout_64 = id_layout<uint64_t, 32>;
+
+#if USE_64BIT_IDS
+    using layout = id_layout_64;
+#else
+    using layout = id_layout_32;
+#endif
+
+    using id_type = layout::type;
 
     namespace detail // detail namespace
     {
-        constexpr uint32_t generationBits( 8 );
-        constexpr uint32_t indexBits( sizeof(id_type) * 8 - generationBits );
+        constexpr uint32_t generationBits( layout::generationBits );
+        constexpr uint32_t indexBits( layout::indexBits );
         constexpr id_type indexMask{ ( id_type(1) << indexBits ) - 1 };
         constexpr id_type generationMask{ ( id_type(1) << generationBits ) - 1 };
     } // detail namespace
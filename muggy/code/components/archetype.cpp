@@ -0,0 +1,577 @@
+//********************************************************************
+//  File:    archetype.cpp
+//  Date:    Fri, 16 Oct 2026: 23:05
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "archetype.h"
+#include "world.h"
+#include "observer.h"
+#include "entity.h"
+#include "idAllocator.h"
+#include <atomic>
+#include <mutex>
+
+namespace muggy::ecs
+{
+    namespace
+    {
+        // NOTE(klek): Component types are registered on first use, which
+        //             may happen on any thread. A fixed array is used so
+        //             readers never see it move
+        component_desc                      componentDescs[ max_component_types ];
+        std::atomic<uint32_t>               componentCount{ 0 };
+        std::mutex                          componentMutex;
+
+        constexpr uint32_t alignUp( uint32_t value, uint32_t alignment )
+        {
+            return ( value + alignment - 1 ) & ~( alignment - 1 );
+        }
+    } // namespace anonymous
+
+    namespace detail
+    {
+        // The chunk storage of a world
+        struct storage_state
+        {
+            ~storage_state()
+            {
+                for ( uint32_t i{ 0 }; i < archetypes.size(); i++ )
+                {
+                    delete archetypes[ i ];
+                }
+            }
+
+            utils::vector<archetype*>           archetypes;
+            std::unordered_map<component_mask, archetype_id> archetypeLookup;
+
+            // Indexed by entity index
+            utils::vector<entity_location>      locations;
+            utils::bitset                       occupancy;
+
+            std::atomic<uint32_t>               currentVersion{ 1 };
+        };
+
+        storage_state* createStorageState()
+        {
+            return new storage_state{};
+        }
+
+        void destroyState( storage_state* state )
+        {
+            delete state;
+        }
+    } // namespace detail
+
+    namespace
+    {
+        detail::storage_state& getStorage()
+        {
+            return getCurrentWorld().getStorageState();
+        }
+    } // namespace anonymous
+
+    component_type registerComponentType( const component_desc& desc )
+    {
+        std::lock_guard<std::mutex> lock{ componentMutex };
+        const component_type type{ componentCount.load( std::memory_order_relaxed ) };
+        // If this assert hits, the component mask has to be widened
+        assert( type < max_component_types );
+        assert( desc.size && desc.alignment <= column_alignment );
+        componentDescs[ type ] = desc;
+        componentCount.store( type + 1, std::memory_order_release );
+        return type;
+    }
+
+    const component_desc& getComponentDesc( component_type type )
+    {
+        assert( type < componentCount.load( std::memory_order_acquire ) );
+        return componentDescs[ type ];
+    }
+
+    uint32_t getComponentTypeCount()
+    {
+        return componentCount.load( std::memory_order_acquire );
+    }
+
+    archetype::archetype( component_mask mask )
+     :
+        m_Mask( mask )
+    {
+        for ( uint32_t i{ 0 }; i < max_component_types; i++ )
+        {
+            m_Offsets[ i ] = uint32_invalid_id;
+            m_VersionOffsets[ i ] = uint32_invalid_id;
+        }
+
+        // Start with the number of rows that would fit without any
+        // padding, then shrink until all columns fit after aligning
+        uint32_t rowSize{ sizeof( id::id_type ) };
+        for ( component_type type{ 0 }; type < max_component_types; type++ )
+        {
+            if ( hasComponent( type ) )
+            {
+                rowSize += getComponentDesc( type ).size + sizeof( uint32_t );
+            }
+        }
+
+        uint32_t capacity{ chunk_size / rowSize };
+        uint32_t offset{ 0 };
+        do
+        {
+            offset = alignUp( capacity * sizeof( id::id_type ), column_alignment );
+            for ( component_type type{ 0 }; type < max_component_types; type++ )
+            {
+                if ( hasComponent( type ) )
+                {
+                    m_Offsets[ type ] = offset;
+                    offset = alignUp( offset + capacity * getComponentDesc( type ).size,
+                                      column_alignment );
+                    m_VersionOffsets[ type ] = offset;
+                    offset = alignUp( offset + capacity * sizeof( uint32_t ),
+                                      column_alignment );
+                }
+            }
+        } while ( offset > chunk_size && --capacity );
+
+        // If this assert hits, a single row doesn't fit in a chunk
+        assert( capacity );
+        m_ChunkCapacity = capacity;
+    }
+
+    archetype::~archetype()
+    {
+        for ( uint32_t i{ 0 }; i < m_Chunks.size(); i++ )
+        {
+            delete m_Chunks[ i ];
+        }
+    }
+
+    void archetype::addChunks( uint32_t count )
+    {
+        m_Chunks.reserve( count );
+        while ( m_Chunks.size() < count )
+        {
+            m_Chunks.push_back( new chunk );
+        }
+        m_ChunkVersions.resize( (uint64_t)count * max_component_types, 0 );
+    }
+
+    uint32_t archetype::add( id::id_type id )
+    {
+        const uint32_t row{ m_Size };
+        const uint32_t chunkIndex{ row / m_ChunkCapacity };
+        if ( chunkIndex == m_Chunks.size() )
+        {
+            addChunks( chunkIndex + 1 );
+        }
+
+        m_Size++;
+        getEntities( chunkIndex )[ row % m_ChunkCapacity ] = id;
+        // New rows count as changed
+        for ( component_type type{ 0 }; type < max_component_types; type++ )
+        {
+            if ( hasComponent( type ) )
+            {
+                markChanged( row, 1, type );
+            }
+        }
+        return row;
+    }
+
+    uint32_t archetype::add( utils::span<const id::id_type> ids )
+    {
+        const uint32_t first{ m_Size };
+        const uint32_t count{ (uint32_t)ids.size() };
+        const uint32_t chunkCount{ ( first + count + m_ChunkCapacity - 1 ) / 
+                                   m_ChunkCapacity };
+        if ( chunkCount > m_Chunks.size() )
+        {
+            addChunks( chunkCount );
+        }
+
+        // Copy the ids in runs, one run per chunk
+        uint32_t row{ first };
+        uint32_t i{ 0 };
+        while ( i < count )
+        {
+            const uint32_t slot{ row % m_ChunkCapacity };
+            const uint32_t run{ std::min( m_ChunkCapacity - slot, count - i ) };
+            memcpy( getEntities( row / m_ChunkCapacity ) + slot,
+                    ids.data() + i, run * sizeof( id::id_type ) );
+            row += run;
+            i += run;
+        }
+
+        m_Size += count;
+        for ( component_type type{ 0 }; type < max_component_types; type++ )
+        {
+            if ( hasComponent( type ) )
+            {
+                markChanged( first, count, type );
+            }
+        }
+        return first;
+    }
+
+    void archetype::copyRow( uint32_t dstRow, uint32_t srcRow )
+    {
+        chunk *const dst{ m_Chunks[ dstRow / m_ChunkCapacity ] };
+        const chunk *const src{ m_Chunks[ srcRow / m_ChunkCapacity ] };
+        const uint32_t dstSlot{ dstRow % m_ChunkCapacity };
+        const uint32_t srcSlot{ srcRow % m_ChunkCapacity };
+        ( (id::id_type*)dst->data )[ dstSlot ] = ( (const id::id_type*)src->data )[ srcSlot ];
+
+        for ( component_type type{ 0 }; type < max_component_types; type++ )
+        {
+            if ( hasComponent( type ) )
+            {
+                const uint32_t size{ getComponentDesc( type ).size };
+                memcpy( dst->data + m_Offsets[ type ] + dstSlot * size,
+                        src->data + m_Offsets[ type ] + srcSlot * size,
+                        size );
+                setVersion( dstRow, type, getVersion( srcRow, type ) );
+            }
+        }
+    }
+
+    id::id_type archetype::remove( uint32_t row )
+    {
+        assert( row < m_Size );
+        const uint32_t last{ m_Size - 1 };
+        id::id_type moved{ id::invalid_id };
+
+        if ( row != last )
+        {
+            // Move the last row into the hole
+            copyRow( row, last );
+            moved = getEntities( row / m_ChunkCapacity )[ row % m_ChunkCapacity ];
+        }
+
+        m_Size--;
+        // Release the last chunk once it has been emptied. We keep the
+        // memory for one extra chunk around to avoid thrashing when
+        // an entity is repeatedly added and removed on the boundary
+        if ( m_Chunks.size() > getChunkCount() + 1 )
+        {
+            delete m_Chunks.back();
+            m_Chunks.resize( m_Chunks.size() - 1 );
+            m_ChunkVersions.resize( m_Chunks.size() * max_component_types );
+        }
+
+        return moved;
+    }
+
+    void archetype::swap( uint32_t rowA, uint32_t rowB )
+    {
+        assert( rowA < m_Size && rowB < m_Size );
+        if ( rowA == rowB )
+        {
+            return;
+        }
+
+        chunk *const a{ m_Chunks[ rowA / m_ChunkCapacity ] };
+        chunk *const b{ m_Chunks[ rowB / m_ChunkCapacity ] };
+        const uint32_t slotA{ rowA % m_ChunkCapacity };
+        const uint32_t slotB{ rowB % m_ChunkCapacity };
+        std::swap( ( (id::id_type*)a->data )[ slotA ],
+                   ( (id::id_type*)b->data )[ slotB ] );
+
+        for ( component_type type{ 0 }; type < max_component_types; type++ )
+        {
+            if ( hasComponent( type ) )
+            {
+                const uint32_t size{ getComponentDesc( type ).size };
+                uint8_t *const dataA{ a->data + m_Offsets[ type ] + slotA * size };
+                std::swap_ranges( dataA, dataA + size, 
+                                  b->data + m_Offsets[ type ] + slotB * size );
+                const uint32_t versionA{ getVersion( rowA, type ) };
+                setVersion( rowA, type, getVersion( rowB, type ) );
+                setVersion( rowB, type, versionA );
+            }
+        }
+    }
+
+    void* archetype::writeColumn( uint32_t chunkIndex, component_type type )
+    {
+        markChanged( chunkIndex * m_ChunkCapacity, getChunkSize( chunkIndex ), type );
+        return getColumn( chunkIndex, type );
+    }
+
+    void* archetype::writeComponent( uint32_t row, component_type type )
+    {
+        markChanged( row, 1, type );
+        return getComponent( row, type );
+    }
+
+    void archetype::markChanged( uint32_t row, uint32_t count, component_type type )
+    {
+        assert( row + count <= m_Size && hasComponent( type ) );
+        const uint32_t version{ ecs::getVersion() };
+        const uint32_t end{ row + count };
+        while ( row < end )
+        {
+            const uint32_t chunkIndex{ row / m_ChunkCapacity };
+            const uint32_t slot{ row % m_ChunkCapacity };
+            const uint32_t run{ std::min( m_ChunkCapacity - slot, end - row ) };
+            uint32_t *const versions{ (uint32_t*)( m_Chunks[ chunkIndex ]->data + 
+                                                   m_VersionOffsets[ type ] ) };
+            std::fill( versions + slot, versions + slot + run, version );
+            m_ChunkVersions[ chunkIndex * max_component_types + type ] = version;
+            row += run;
+        }
+    }
+
+    const uint32_t* archetype::getVersions( uint32_t chunkIndex, 
+                                            component_type type ) const
+    {
+        assert( chunkIndex < m_Chunks.size() && hasComponent( type ) );
+        return (const uint32_t*)( m_Chunks[ chunkIndex ]->data + m_VersionOffsets[ type ] );
+    }
+
+    uint32_t archetype::getVersion( uint32_t row, component_type type ) const
+    {
+        assert( row < m_Size );
+        return getVersions( row / m_ChunkCapacity, type )[ row % m_ChunkCapacity ];
+    }
+
+    void archetype::setVersion( uint32_t row, component_type type, uint32_t version )
+    {
+        assert( row < m_Size && hasComponent( type ) );
+        const uint32_t chunkIndex{ row / m_ChunkCapacity };
+        ( (uint32_t*)( m_Chunks[ chunkIndex ]->data + m_VersionOffsets[ type ] ) )
+            [ row % m_ChunkCapacity ] = version;
+        // NOTE(klek): The chunk version must stay at least as new as
+        //             every row in it, or the chunk could be skipped
+        uint32_t& chunkVersion{ m_ChunkVersions[ chunkIndex * max_component_types + type ] };
+        if ( isNewer( version, chunkVersion ) )
+        {
+            chunkVersion = version;
+        }
+    }
+
+    void* archetype::getColumn( uint32_t chunkIndex, component_type type ) const
+    {
+        assert( chunkIndex < m_Chunks.size() && hasComponent( type ) );
+        return m_Chunks[ chunkIndex ]->data + m_Offsets[ type ];
+    }
+
+    id::id_type* archetype::getEntities( uint32_t chunkIndex ) const
+    {
+        assert( chunkIndex < m_Chunks.size() );
+        return (id::id_type*)m_Chunks[ chunkIndex ]->data;
+    }
+
+    void* archetype::getComponent( uint32_t row, component_type type ) const
+    {
+        assert( row < m_Size );
+        const uint32_t slot{ row % m_ChunkCapacity };
+        return (uint8_t*)getColumn( row / m_ChunkCapacity, type ) +
+               slot * getComponentDesc( type ).size;
+    }
+
+    archetype_id getArchetype( component_mask mask )
+    {
+        detail::storage_state& storage{ getStorage() };
+        auto it{ storage.archetypeLookup.find( mask ) };
+        if ( it != storage.archetypeLookup.end() )
+        {
+            return it->second;
+        }
+
+        const archetype_id id{ (archetype_id)storage.archetypes.size() };
+        storage.archetypes.push_back( new archetype( mask ) );
+        storage.archetypeLookup[ mask ] = id;
+        return id;
+    }
+
+    archetype& getArchetypeFromId( archetype_id id )
+    {
+        detail::storage_state& storage{ getStorage() };
+        assert( id < storage.archetypes.size() );
+        return *storage.archetypes[ id ];
+    }
+
+    uint32_t getArchetypeCount()
+    {
+        detail::storage_state& storage{ getStorage() };
+        return (uint32_t)storage.archetypes.size();
+    }
+
+    void addEntity( id::id_type id, component_mask mask )
+    {
+        detail::storage_state& storage{ getStorage() };
+        const id::id_type index{ id::index( id ) };
+        if ( index >= storage.locations.size() )
+        {
+            storage.locations.resize( index + 1 );
+            storage.occupancy.resize( index + 1 );
+        }
+
+        entity_location& location{ storage.locations[ index ] };
+        assert( location.archetype == invalid_archetype );
+        location.archetype = getArchetype( mask );
+        location.row = storage.archetypes[ location.archetype ]->add( id );
+        storage.occupancy.set( index );
+        game_entity::detail::getIdAllocator().setStored( index, true );
+        detail::queueCreated( utils::span<const id::id_type>{ &id, 1 }, mask );
+    }
+
+    void addEntities( utils::span<const id::id_type> ids, component_mask mask )
+    {
+        detail::storage_state& storage{ getStorage() };
+        if ( ids.empty() )
+        {
+            return;
+        }
+
+        id::id_type maxIndex{ 0 };
+        for ( id::id_type id : ids )
+        {
+            maxIndex = std::max( maxIndex, id::index( id ) );
+        }
+        if ( maxIndex >= storage.locations.size() )
+        {
+            storage.locations.resize( maxIndex + 1 );
+            storage.occupancy.resize( maxIndex + 1 );
+        }
+
+        const archetype_id archetypeId{ getArchetype( mask ) };
+        const uint32_t first{ storage.archetypes[ archetypeId ]->add( ids ) };
+        id::id_allocator& allocator{ game_entity::detail::getIdAllocator() };
+        for ( uint32_t i{ 0 }; i < ids.size(); i++ )
+        {
+            entity_location& location{ storage.locations[ id::index( ids[ i ] ) ] };
+            assert( location.archetype == invalid_archetype );
+            location.archetype = archetypeId;
+            location.row = first + i;
+            storage.occupancy.set( id::index( ids[ i ] ) );
+            allocator.setStored( id::index( ids[ i ] ), true );
+        }
+        detail::queueCreated( ids, mask );
+    }
+
+    void removeEntity( id::id_type id )
+    {
+        detail::storage_state& storage{ getStorage() };
+        assert( hasEntity( id ) );
+        entity_location& location{ storage.locations[ id::index( id ) ] };
+        const id::id_type moved{ storage.archetypes[ location.archetype ]->remove( location.row ) };
+        if ( id::isValid( moved ) )
+        {
+            // The last row of the archetype was moved into the hole
+            storage.locations[ id::index( moved ) ].row = location.row;
+        }
+        location = {};
+        storage.occupancy.reset( id::index( id ) );
+        game_entity::detail::getIdAllocator().setStored( id::index( id ), false );
+        detail::queueRemoved( id );
+    }
+
+    void moveEntity( id::id_type id, component_mask mask )
+    {
+        detail::storage_state& storage{ getStorage() };
+        entity_location& location{ storage.locations[ id::index( id ) ] };
+        assert( hasEntity( id ) );
+        const archetype& src{ *storage.archetypes[ location.archetype ] };
+        if ( src.getMask() == mask )
+        {
+            return;
+        }
+
+        const archetype_id dstId{ getArchetype( mask ) };
+        archetype& dst{ *storage.archetypes[ dstId ] };
+        const uint32_t row{ dst.add( id ) };
+
+        // Copy the columns both archetypes have in common. Their
+        // versions are kept, new columns count as changed
+        const component_mask shared{ src.getMask() & mask };
+        for ( component_type type{ 0 }; type < max_component_types; type++ )
+        {
+            if ( ( shared >> type ) & 1 )
+            {
+                memcpy( dst.getComponent( row, type ), 
+                        src.getComponent( location.row, type ),
+                        getComponentDesc( type ).size );
+                dst.setVersion( row, type, src.getVersion( location.row, type ) );
+            }
+        }
+
+        const id::id_type moved{ storage.archetypes[ location.archetype ]->remove( location.row ) };
+        if ( id::isValid( moved ) )
+        {
+            storage.locations[ id::index( moved ) ].row = location.row;
+        }
+        location.archetype = dstId;
+        location.row = row;
+        detail::queueComponentsAdded( id, mask & ~src.getMask() );
+    }
+
+    void swapRows( archetype_id id, uint32_t rowA, uint32_t rowB )
+    {
+        detail::storage_state& storage{ getStorage() };
+        assert( id < storage.archetypes.size() );
+        archetype& a{ *storage.archetypes[ id ] };
+        a.swap( rowA, rowB );
+        // The ids have been swapped along with the rest of the rows
+        storage.locations[ id::index( a.getEntities( rowA / a.getChunkCapacity() )
+                                [ rowA % a.getChunkCapacity() ] ) ].row = rowA;
+        storage.locations[ id::index( a.getEntities( rowB / a.getChunkCapacity() )
+                                [ rowB % a.getChunkCapacity() ] ) ].row = rowB;
+    }
+
+    uint32_t getVersion()
+    {
+        detail::storage_state& storage{ getStorage() };
+        return storage.currentVersion.load( std::memory_order_relaxed );
+    }
+
+    uint32_t advanceVersion()
+    {
+        detail::storage_state& storage{ getStorage() };
+        return storage.currentVersion.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    void* writeComponent( id::id_type id, component_type type )
+    {
+        detail::storage_state& storage{ getStorage() };
+        const entity_location& location{ getLocation( id ) };
+        return storage.archetypes[ location.archetype ]->writeComponent( location.row, type );
+    }
+
+    component_mask getComponentMask( id::id_type id )
+    {
+        detail::storage_state& storage{ getStorage() };
+        return storage.archetypes[ getLocation( id ).archetype ]->getMask();
+    }
+
+    bool hasEntity( id::id_type id )
+    {
+        detail::storage_state& storage{ getStorage() };
+        const id::id_type index{ id::index( id ) };
+        return ( index < storage.locations.size() &&
+                 storage.locations[ index ].archetype != invalid_archetype );
+    }
+
+    const utils::bitset& getOccupancy()
+    {
+        detail::storage_state& storage{ getStorage() };
+        return storage.occupancy;
+    }
+
+    const entity_location& getLocation( id::id_type id )
+    {
+        detail::storage_state& storage{ getStorage() };
+        assert( hasEntity( id ) );
+        return storage.locations[ id::index( id ) ];
+    }
+
+    void* getComponent( id::id_type id, component_type type )
+    {
+        detail::storage_state& storage{ getStorage() };
+        const entity_location& location{ getLocation( id ) };
+        return storage.archetypes[ location.archetype ]->getComponent( location.row, type );
+    }
+} // namespace muggy::ecs
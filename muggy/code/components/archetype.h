@@ -0,0 +1,353 @@
+//********************************************************************
+//  File:    archetype.h
+//  Date:    Fri, 16 Oct 2026: 22:41
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(ARCHETYPE_H)
+#define ARCHETYPE_H
+
+#include "componentsCommon.h"
+#include "../utilities/bitset.h"
+#include <algorithm>
+
+namespace muggy::ecs
+{
+    // Size in bytes of a single chunk of component storage
+    constexpr uint32_t chunk_size{ 16 * 1024 };
+    // Every column in a chunk starts on a cache line boundary
+    constexpr uint32_t column_alignment{ 64 };
+    // Component masks are 64-bit, so this is the maximum number of
+    // component types that can be registered
+    constexpr uint32_t max_component_types{ 64 };
+
+    using component_type = uint32_t;
+    using component_mask = uint64_t;
+    using archetype_id   = uint32_t;
+
+    constexpr component_type invalid_component_type{ uint32_invalid_id };
+    constexpr archetype_id   invalid_archetype{ uint32_invalid_id };
+
+    // Returns true if "version" is newer than "since". The versions are
+    // allowed to wrap around as long as they are less than 2^31 apart
+    [[nodiscard]] constexpr bool isNewer( uint32_t version, uint32_t since )
+    {
+        return (int32_t)( version - since ) > 0;
+    }
+
+    struct component_desc
+    {
+        uint32_t    size{ 0 };
+        uint32_t    alignment{ 0 };
+        const char* name{ nullptr };
+    };
+
+    // Where the components of an entity are stored. The row is the
+    // running index within the archetype, ie it is split into chunk
+    // and slot by the archetype chunk capacity
+    struct entity_location
+    {
+        archetype_id    archetype{ invalid_archetype };
+        uint32_t        row{ uint32_invalid_id };
+    };
+
+    // A component type can either be the data itself or a descriptor
+    // struct that names the stored data with a "column_type" alias.
+    // The descriptor variant allows several columns of the same data
+    // type (such as position and scale) to be told apart.
+    template <typename T, typename = void>
+    struct component_traits
+    {
+        using value_type = T;
+    };
+
+    template <typename T>
+    struct component_traits<T, std::void_t<typename T::column_type>>
+    {
+        using value_type = typename T::column_type;
+    };
+
+    template <typename T>
+    using component_value_t = typename component_traits<T>::value_type;
+
+    component_type registerComponentType( const component_desc& desc );
+    const component_desc& getComponentDesc( component_type type );
+    // Number of component types registered so far
+    uint32_t getComponentTypeCount();
+
+    // Returns the component type for T, registering it on first use
+    template <typename T>
+    component_type componentType()
+    {
+        using value_type = component_value_t<T>;
+        // NOTE(klek): Rows are moved around within and between chunks
+        //             with memcpy, so the stored data can't rely on
+        //             its destructor being called
+        static_assert( std::is_trivially_destructible<value_type>::value,
+                       "Component data must be trivially destructible" );
+        static const component_type type{
+            registerComponentType( { sizeof( value_type ),
+                                     alignof( value_type ),
+                                     typeid( T ).name() } ) };
+        return type;
+    }
+
+    template <typename... T>
+    component_mask componentMask()
+    {
+        return ( component_mask{ 0 } | ... |
+                 ( component_mask{ 1 } << componentType<T>() ) );
+    }
+
+    // Fixed size block of memory holding the SoA columns of an
+    // archetype. The first column is always the entity ids, and every
+    // component column is followed by a column with the version each
+    // row was last written in
+    struct alignas( column_alignment ) chunk
+    {
+        uint8_t data[ chunk_size ];
+    };
+
+    class archetype
+    {
+    public:
+        explicit archetype( component_mask mask );
+        ~archetype();
+
+        archetype( const archetype& ) = delete;
+        archetype& operator=( const archetype& ) = delete;
+
+        // Adds a row at the end of the archetype for the entity id
+        // and returns the row index. Component data is left
+        // uninitialized
+        uint32_t add( id::id_type id );
+        // Adds rows for all ids at once and returns the row of the
+        // first one. The rows are contiguous
+        uint32_t add( utils::span<const id::id_type> ids );
+        // Removes the row by moving the last row into its place.
+        // Returns the id of the entity that was moved or invalid_id
+        // if the removed row was the last one
+        id::id_type remove( uint32_t row );
+        // Exchanges the contents of two rows, entity ids included
+        void swap( uint32_t rowA, uint32_t rowB );
+
+        // Returns the column of the chunk and marks all of its rows as
+        // changed in the current version
+        [[nodiscard]] void* writeColumn( uint32_t chunkIndex, component_type type );
+        // Returns the component of the row and marks it as changed in
+        // the current version
+        [[nodiscard]] void* writeComponent( uint32_t row, component_type type );
+        // Marks "count" rows starting at "row" as changed in the current
+        // version. The rows can span several chunks
+        void markChanged( uint32_t row, uint32_t count, component_type type );
+
+        [[nodiscard]] void* getColumn( uint32_t chunkIndex,
+                                       component_type type ) const;
+        [[nodiscard]] id::id_type* getEntities( uint32_t chunkIndex ) const;
+        [[nodiscard]] void* getComponent( uint32_t row,
+                                          component_type type ) const;
+
+        template <typename T>
+        [[nodiscard]] component_value_t<T>* getColumn( uint32_t chunkIndex ) const
+        {
+            return static_cast<component_value_t<T>*>(
+                        getColumn( chunkIndex, componentType<T>() ) );
+        }
+
+        template <typename T>
+        [[nodiscard]] component_value_t<T>* writeColumn( uint32_t chunkIndex )
+        {
+            return static_cast<component_value_t<T>*>(
+                        writeColumn( chunkIndex, componentType<T>() ) );
+        }
+
+        // Per row change versions of the component in the chunk
+        [[nodiscard]] const uint32_t* getVersions( uint32_t chunkIndex, 
+                                                   component_type type ) const;
+        // Newest change version of the component among the rows of the
+        // chunk, which allows skipping whole chunks that didn't change
+        [[nodiscard]] uint32_t getChunkVersion( uint32_t chunkIndex, 
+                                                component_type type ) const
+        {
+            assert( chunkIndex < m_Chunks.size() && hasComponent( type ) );
+            return m_ChunkVersions[ chunkIndex * max_component_types + type ];
+        }
+        [[nodiscard]] uint32_t getVersion( uint32_t row, component_type type ) const;
+        // Sets the version of a single row, which is used to keep the
+        // version when a row is copied between chunks or archetypes
+        void setVersion( uint32_t row, component_type type, uint32_t version );
+
+        [[nodiscard]] constexpr bool hasComponent( component_type type ) const
+        {
+            return ( m_Mask >> type ) & 1;
+        }
+
+        // Number of rows that fit in a single chunk
+        [[nodiscard]] constexpr uint32_t getChunkCapacity() const
+        {
+            return m_ChunkCapacity;
+        }
+
+        // Number of rows used in the specified chunk. Only the last
+        // chunk can be partially filled
+        [[nodiscard]] constexpr uint32_t getChunkSize( uint32_t chunkIndex ) const
+        {
+            assert( chunkIndex < getChunkCount() );
+            const uint32_t first{ chunkIndex * m_ChunkCapacity };
+            return std::min( m_ChunkCapacity, m_Size - first );
+        }
+
+        [[nodiscard]] constexpr uint32_t getChunkCount() const
+        {
+            return ( m_Size + m_ChunkCapacity - 1 ) / m_ChunkCapacity;
+        }
+
+        [[nodiscard]] constexpr component_mask getMask() const
+        {
+            return m_Mask;
+        }
+
+        [[nodiscard]] constexpr uint32_t getSize() const
+        {
+            return m_Size;
+        }
+
+    private:
+        // Adds chunks until there are "count" of them
+        void addChunks( uint32_t count );
+        // Copies the row from one slot to another, versions included
+        void copyRow( uint32_t dstRow, uint32_t srcRow );
+
+        component_mask          m_Mask{ 0 };
+        uint32_t                m_ChunkCapacity{ 0 };
+        uint32_t                m_Size{ 0 };
+        // Offset in bytes from the start of a chunk for each column and
+        // its version column. Set to uint32_invalid_id for components
+        // not in this archetype
+        uint32_t                m_Offsets[ max_component_types ];
+        uint32_t                m_VersionOffsets[ max_component_types ];
+        utils::vector<chunk*>   m_Chunks;
+        // max_component_types versions per chunk
+        utils::vector<uint32_t> m_ChunkVersions;
+    };
+
+    // Returns the archetype with the specified mask, creating it if it
+    // does not exist yet
+    archetype_id getArchetype( component_mask mask );
+    archetype& getArchetypeFromId( archetype_id id );
+    uint32_t getArchetypeCount();
+
+    // Places the entity in the archetype of the mask. The entity must
+    // not already be stored
+    void addEntity( id::id_type id, component_mask mask );
+    // Same as addEntity() but for many entities, which all end up in
+    // contiguous rows of the same archetype
+    void addEntities( utils::span<const id::id_type> ids, component_mask mask );
+    // Removes the entity from its archetype, compacting the storage
+    void removeEntity( id::id_type id );
+    // Moves the entity to the archetype of the new mask. Columns that
+    // are in both archetypes are copied, new columns are left 
+    // uninitialized
+    void moveEntity( id::id_type id, component_mask mask );
+    // Exchanges two rows of the archetype and updates the locations of
+    // the two entities, which is used to reorder the storage
+    void swapRows( archetype_id id, uint32_t rowA, uint32_t rowB );
+    // Version that writes are currently stamped with. It starts at 1
+    // and only changes with advanceVersion()
+    uint32_t getVersion();
+    // Returns the current version and starts a new one. A system that
+    // processes changes keeps the returned value and next time asks
+    // for everything newer than it, which includes changes made while
+    // it was running
+    uint32_t advanceVersion();
+
+    // Returns the component mask of the entity, ie its archetype mask
+    component_mask getComponentMask( id::id_type id );
+    bool hasEntity( id::id_type id );
+    // Bit i is set if an entity with index i is stored. The bitset is
+    // resized when entities with new indices are added
+    const utils::bitset& getOccupancy();
+    const entity_location& getLocation( id::id_type id );
+    void* getComponent( id::id_type id, component_type type );
+
+    template <typename T>
+    component_value_t<T>* getComponent( id::id_type id )
+    {
+        return static_cast<component_value_t<T>*>(
+                    getComponent( id, componentType<T>() ) );
+    }
+
+    // Same as getComponent() but marks the component of the entity as
+    // changed in the current version
+    void* writeComponent( id::id_type id, component_type type );
+
+    template <typename T>
+    component_value_t<T>* writeComponent( id::id_type id )
+    {
+        return static_cast<component_value_t<T>*>(
+                    writeComponent( id, componentType<T>() ) );
+    }
+
+    template <typename T>
+    [[nodiscard]] bool hasComponent( id::id_type id )
+    {
+        return ( getComponentMask( id ) >> componentType<T>() ) & 1;
+    }
+
+    // Adds the component T to the entity, moving it to another 
+    // archetype, and initializes it with "value"
+    template <typename T>
+    component_value_t<T>* addComponent( id::id_type id, 
+                                        const component_value_t<T>& value )
+    {
+        assert( !hasComponent<T>( id ) );
+        moveEntity( id, getComponentMask( id ) | 
+                        ( component_mask{ 1 } << componentType<T>() ) );
+        return new ( getComponent<T>( id ) ) component_value_t<T>( value );
+    }
+
+    // Removes the component T from the entity, moving it to another
+    // archetype
+    template <typename T>
+    void removeComponent( id::id_type id )
+    {
+        assert( hasComponent<T>( id ) );
+        moveEntity( id, getComponentMask( id ) & 
+                        ~( component_mask{ 1 } << componentType<T>() ) );
+    }
+
+    // Calls func( archetype, chunkIndex, count ) for every non-empty
+    // chunk of every archetype that contains all components in mask
+    // and none in exclude. Since rows are kept densely packed, this 
+    // visits only live entities
+    template <typename F>
+    void forEachChunk( component_mask mask, component_mask exclude, F&& func )
+    {
+        const uint32_t count{ getArchetypeCount() };
+        for ( archetype_id id{ 0 }; id < count; id++ )
+        {
+            archetype& a{ getArchetypeFromId( id ) };
+            if ( ( a.getMask() & mask ) != mask || ( a.getMask() & exclude ) )
+            {
+                continue;
+            }
+
+            const uint32_t chunkCount{ a.getChunkCount() };
+            for ( uint32_t c{ 0 }; c < chunkCount; c++ )
+            {
+                func( a, c, a.getChunkSize( c ) );
+            }
+        }
+    }
+
+    template <typename F>
+    void forEachChunk( component_mask mask, F&& func )
+    {
+        forEachChunk( mask, 0, std::forward<F>( func ) );
+    }
+} // namespace muggy::ecs
+
+
+#endif
@@ -0,0 +1,289 @@
+//********************************************************************
+//  File:    commandBuffer.cpp
+//  Date:    Sat, 17 Oct 2026: 20:35
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "commandBuffer.h"
+#include "entity.h"
+#include "world.h"
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace muggy::ecs::detail
+{
+    // Owns the per-thread buffers, which outlive their threads so
+    // commands recorded just before a thread ends are still applied
+    struct command_state
+    {
+        ~command_state()
+        {
+            for ( game_entity::command_buffer* buffer : buffers )
+            {
+                delete buffer;
+            }
+        }
+
+        // In the order the threads first asked for them
+        utils::deque<game_entity::command_buffer*>  buffers;
+        std::unordered_map<std::thread::id, game_entity::command_buffer*> threadBuffers;
+        std::mutex                                  mutex;
+    };
+
+    command_state* createCommandState()
+    {
+        return new command_state{};
+    }
+
+    void destroyState( command_state* state )
+    {
+        delete state;
+    }
+} // namespace muggy::ecs::detail
+
+namespace muggy::game_entity
+{
+    namespace
+    {
+        // NOTE(klek): Caches the buffer of the world the thread used
+        //             last, so getCommandBuffer() only has to lock
+        //             when a thread switches between worlds
+        struct thread_buffer
+        {
+            uint64_t            worldSerial{ 0 };
+            command_buffer*     buffer{ nullptr };
+        };
+
+        thread_local thread_buffer  threadBuffer;
+
+        struct sort_item
+        {
+            id::id_type         id;
+            ecs::component_type type;
+            // Value to copy or nullptr for removal
+            const uint8_t*      data;
+        };
+    } // namespace anonymous
+
+    command_buffer::command_buffer()
+     :
+        m_World( &ecs::getCurrentWorld() )
+    {}
+
+    entity command_buffer::create( const transform::init_info& info, ecs::tag_mask tags )
+    {
+        const entity e{ reserveGameEntity() };
+        m_Creates.push_back( { e, info, tags } );
+        return e;
+    }
+
+    void command_buffer::remove( entity e )
+    {
+        assert( e.isValid() );
+        m_Removes.push_back( e );
+    }
+
+    void command_buffer::addComponent( entity e, ecs::component_type type,
+                                       const void* data )
+    {
+        assert( e.isValid() && data );
+        const uint32_t size{ ecs::getComponentDesc( type ).size };
+        const uint32_t offset{ (uint32_t)m_Data.size() };
+        m_Data.resize( offset + size );
+        memcpy( m_Data.data() + offset, data, size );
+        m_Components.push_back( { e.getId(), type, offset } );
+    }
+
+    void command_buffer::removeComponent( entity e, ecs::component_type type )
+    {
+        assert( e.isValid() );
+        // The transform columns are part of every entity
+        assert( !( ( transform::getComponentMask() >> type ) & 1 ) );
+        m_Components.push_back( { e.getId(), type, uint32_invalid_id } );
+    }
+
+    void command_buffer::flush()
+    {
+        command_buffer* self{ this };
+        flush( utils::span<command_buffer* const>{ &self, 1 } );
+    }
+
+    void command_buffer::clear()
+    {
+        // If this assert hits, the buffer was created in another world
+        assert( m_World == &ecs::getCurrentWorld() );
+        for ( uint32_t i{ 0 }; i < m_Creates.size(); i++ )
+        {
+            cancelReservedGameEntity( m_Creates[ i ].e );
+        }
+        reset();
+    }
+
+    void command_buffer::reset()
+    {
+        m_Creates.clear();
+        m_Removes.clear();
+        m_Components.clear();
+        m_Data.clear();
+    }
+
+    void command_buffer::flush( utils::span<command_buffer* const> buffers )
+    {
+        // DEBUG: Check that all buffers record for the current world
+        DEBUG_OP( for ( const command_buffer* buffer : buffers ) 
+                  { assert( buffer->m_World == &ecs::getCurrentWorld() ); } );
+
+        // Create all recorded entities in one batch, in the order of
+        // the buffers and of the commands within each buffer
+        utils::vector<entity_info> infos;
+        utils::vector<entity> created;
+        for ( const command_buffer* buffer : buffers )
+        {
+            for ( uint32_t i{ 0 }; i < buffer->m_Creates.size(); i++ )
+            {
+                // NOTE(klek): The infos point into the buffers, which
+                //             don't change until they are reset below
+                const create_command& c{ buffer->m_Creates[ i ] };
+                infos.push_back( { const_cast<transform::init_info*>( &c.info ), c.tags } );
+                created.push_back( c.e );
+            }
+        }
+        createReservedGameEntities( infos, created );
+
+        // Sort the component commands by entity. The sort is stable,
+        // so commands for the same entity keep the order they were
+        // recorded in
+        utils::vector<sort_item> items;
+        for ( const command_buffer* buffer : buffers )
+        {
+            for ( uint32_t i{ 0 }; i < buffer->m_Components.size(); i++ )
+            {
+                const component_command& c{ buffer->m_Components[ i ] };
+                items.push_back( { c.id, c.type,
+                                   c.offset == uint32_invalid_id ?
+                                   nullptr : buffer->m_Data.data() + c.offset } );
+            }
+        }
+        if ( !items.empty() )
+        {
+            std::stable_sort( items.begin(), items.end(),
+                              []( const sort_item& a, const sort_item& b )
+                              {
+                                  return a.id < b.id;
+                              } );
+        }
+
+        // Work out the final mask of each entity first, so an entity
+        // moves to another archetype only once no matter how many
+        // components are added or removed
+        const uint32_t itemCount{ (uint32_t)items.size() };
+        uint32_t first{ 0 };
+        while ( first < itemCount )
+        {
+            const id::id_type id{ items[ first ].id };
+            uint32_t last{ first };
+            while ( last < itemCount && items[ last ].id == id )
+            {
+                last++;
+            }
+
+            // Skip entities that were removed before the flush
+            if ( isAlive( entity{ entity_id{ id } } ) )
+            {
+                ecs::component_mask mask{ ecs::getComponentMask( id ) };
+                for ( uint32_t i{ first }; i < last; i++ )
+                {
+                    const ecs::component_mask bit{ ecs::component_mask{ 1 } << items[ i ].type };
+                    mask = items[ i ].data ? ( mask | bit ) : ( mask & ~bit );
+                }
+                ecs::moveEntity( id, mask );
+
+                // Copy the values, the last one recorded for a type wins.
+                // Values of components that were removed afterwards are
+                // skipped
+                for ( uint32_t i{ first }; i < last; i++ )
+                {
+                    const sort_item& item{ items[ i ] };
+                    if ( item.data && ( ( mask >> item.type ) & 1 ) )
+                    {
+                        memcpy( ecs::writeComponent( id, item.type ), item.data,
+                                ecs::getComponentDesc( item.type ).size );
+                    }
+                }
+            }
+            first = last;
+        }
+
+        // Remove entities last, so commands recorded for them before
+        // the removal don't refer to dead entities. The same entity may
+        // be removed from several buffers, so drop duplicates
+        utils::vector<entity> removed;
+        for ( const command_buffer* buffer : buffers )
+        {
+            for ( uint32_t i{ 0 }; i < buffer->m_Removes.size(); i++ )
+            {
+                removed.push_back( buffer->m_Removes[ i ] );
+            }
+        }
+        if ( !removed.empty() )
+        {
+            std::sort( removed.begin(), removed.end(),
+                       []( const entity a, const entity b )
+                       {
+                           return a.getId() < b.getId();
+                       } );
+        }
+        uint32_t count{ 0 };
+        for ( uint32_t i{ 0 }; i < removed.size(); i++ )
+        {
+            if ( ( !count || removed[ i ].getId() != removed[ count - 1 ].getId() ) &&
+                 isAlive( removed[ i ] ) )
+            {
+                removed[ count++ ] = removed[ i ];
+            }
+        }
+        removeGameEntities( utils::span<const entity>{ removed.data(), count } );
+
+        for ( command_buffer* buffer : buffers )
+        {
+            buffer->reset();
+        }
+    }
+
+    command_buffer& getCommandBuffer()
+    {
+        ecs::world& world{ ecs::getCurrentWorld() };
+        if ( threadBuffer.worldSerial != world.getSerial() )
+        {
+            ecs::detail::command_state& state{ world.getCommandState() };
+            std::lock_guard<std::mutex> lock{ state.mutex };
+            command_buffer*& buffer{ state.threadBuffers[ std::this_thread::get_id() ] };
+            if ( !buffer )
+            {
+                buffer = new command_buffer{};
+                state.buffers.push_back( buffer );
+            }
+            threadBuffer = { world.getSerial(), buffer };
+        }
+        return *threadBuffer.buffer;
+    }
+
+    void flushCommandBuffers()
+    {
+        ecs::detail::command_state& state{ ecs::getCurrentWorld().getCommandState() };
+        std::lock_guard<std::mutex> lock{ state.mutex };
+        utils::vector<command_buffer*> buffers;
+        for ( command_buffer* buffer : state.buffers )
+        {
+            if ( !buffer->empty() )
+            {
+                buffers.push_back( buffer );
+            }
+        }
+        command_buffer::flush( buffers );
+    }
+} // namespace muggy::game_entity
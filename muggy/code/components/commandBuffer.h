@@ -0,0 +1,116 @@
+//********************************************************************
+//  File:    commandBuffer.h
+//  Date:    Sat, 17 Oct 2026: 20:10
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(COMMAND_BUFFER_H)
+#define COMMAND_BUFFER_H
+
+#include "componentsCommon.h"
+#include "archetype.h"
+#include "tags.h"
+#include "transform.h"
+
+namespace muggy::ecs
+{
+    class world;
+} // namespace muggy::ecs
+
+namespace muggy::game_entity
+{
+    // Records structural changes (creating and removing entities, and
+    // adding and removing components) so they can be applied later,
+    // at a point where nothing iterates the storage.
+    // Recording only touches the buffer itself and the id allocator,
+    // so every thread can record into its own buffer without locking.
+    // A buffer records for the world bound to the thread that created
+    // it, and must be flushed or cleared in that world before it is
+    // destroyed
+    class command_buffer
+    {
+    public:
+        command_buffer();
+
+        command_buffer( const command_buffer& ) = delete;
+        command_buffer& operator=( const command_buffer& ) = delete;
+
+        // Returns the entity right away so later commands can refer
+        // to it, but it has no components or tags until the buffer is
+        // flushed.
+        // NOTE(klek): A parent has to be recorded before its children
+        entity create( const transform::init_info& info, ecs::tag_mask tags = 0 );
+        void remove( entity e );
+        // Adds the component or, if the entity already has it,
+        // overwrites its value
+        void addComponent( entity e, ecs::component_type type, const void* data );
+        void removeComponent( entity e, ecs::component_type type );
+
+        template <typename T>
+        void addComponent( entity e, const ecs::component_value_t<T>& value )
+        {
+            addComponent( e, ecs::componentType<T>(), &value );
+        }
+
+        template <typename T>
+        void removeComponent( entity e )
+        {
+            removeComponent( e, ecs::componentType<T>() );
+        }
+
+        // Applies the commands of this buffer and clears it
+        void flush();
+        // Drops all commands. Entities recorded for creation are given
+        // back to the id allocator
+        void clear();
+
+        [[nodiscard]] bool empty() const
+        {
+            return m_Creates.empty() && m_Removes.empty() && m_Components.empty();
+        }
+
+        // Applies the commands of all buffers in one go and clears them.
+        // Entities are created in one batch, component changes are
+        // sorted per entity so each entity moves archetype at most once,
+        // and removals are done last in one batch
+        static void flush( utils::span<command_buffer* const> buffers );
+
+    private:
+        struct create_command
+        {
+            entity                  e;
+            transform::init_info    info;
+            ecs::tag_mask           tags;
+        };
+
+        struct component_command
+        {
+            id::id_type             id;
+            ecs::component_type     type;
+            // Offset of the value in m_Data, or uint32_invalid_id when
+            // the component is removed
+            uint32_t                offset;
+        };
+
+        void reset();
+
+        ecs::world*                         m_World{ nullptr };
+        utils::vector<create_command>       m_Creates;
+        utils::vector<entity>               m_Removes;
+        utils::vector<component_command>    m_Components;
+        utils::vector<uint8_t>              m_Data;
+    };
+
+    // Returns the command buffer of the calling thread for the current
+    // world. These buffers live until their world is destroyed
+    command_buffer& getCommandBuffer();
+    // Flushes the buffers of all threads for the current world. Must
+    // be called while no thread records commands or uses the storage
+    // of that world
+    void flushCommandBuffers();
+} // namespace muggy::game_entity
+
+
+#endif
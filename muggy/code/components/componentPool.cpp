@@ -0,0 +1,74 @@
+//********************************************************************
+//  File:    componentPool.cpp
+//  Date:    Sat, 17 Oct 2026: 01:02
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "componentPool.h"
+#include "world.h"
+
+namespace muggy::ecs
+{
+    namespace detail
+    {
+        struct pool_state
+        {
+            utils::vector<component_pool_base*> pools;
+        };
+
+        pool_state* createPoolState()
+        {
+            return new pool_state{};
+        }
+
+        void destroyState( pool_state* state )
+        {
+            // If this assert hits, a pool outlived its world
+            assert( state->pools.empty() );
+            delete state;
+        }
+    } // namespace detail
+
+    // NOTE(klek): Pools are often globals themselves, getCurrentWorld()
+    //             creates the default world on first use so it doesn't
+    //             depend on the initialization order between files
+    component_pool_base::component_pool_base()
+     :
+        m_World( &getCurrentWorld() )
+    {}
+
+    void registerPool( component_pool_base* pool )
+    {
+        assert( pool );
+        pool->getWorld().getPoolState().pools.push_back( pool );
+    }
+
+    void unregisterPool( component_pool_base* pool )
+    {
+        utils::vector<component_pool_base*>& pools{ pool->getWorld().getPoolState().pools };
+        for ( uint32_t i{ 0 }; i < pools.size(); i++ )
+        {
+            if ( pools[ i ] == pool )
+            {
+                utils::erase_unordered( pools, i );
+                return;
+            }
+        }
+        // If this assert hits, the pool was never registered
+        assert( false );
+    }
+
+    void removeFromPools( id::id_type id )
+    {
+        utils::vector<component_pool_base*>& pools{ getCurrentWorld().getPoolState().pools };
+        for ( uint32_t i{ 0 }; i < pools.size(); i++ )
+        {
+            if ( pools[ i ]->contains( id ) )
+            {
+                pools[ i ]->remove( id );
+            }
+        }
+    }
+} // namespace muggy::ecs
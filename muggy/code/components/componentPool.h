@@ -0,0 +1,124 @@
+//********************************************************************
+//  File:    componentPool.h
+//  Date:    Sat, 17 Oct 2026: 00:48
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(COMPONENT_POOL_H)
+#define COMPONENT_POOL_H
+
+#include "componentsCommon.h"
+#include "../utilities/sparseset.h"
+
+namespace muggy::ecs
+{
+    class world;
+
+    // Common interface for all component pools, so that the entity
+    // code can clean up every pool an entity might be in without
+    // knowing the component types
+    class component_pool_base
+    {
+    public:
+        // The pool belongs to the world bound to the creating thread
+        component_pool_base();
+        virtual ~component_pool_base() = default;
+        virtual bool contains( id::id_type id ) const = 0;
+        virtual void remove( id::id_type id ) = 0;
+
+        [[nodiscard]] world& getWorld() const
+        {
+            return *m_World;
+        }
+
+    private:
+        world*      m_World{ nullptr };
+    };
+
+    // Registered pools are cleaned by removeFromPools() of their world
+    void registerPool( component_pool_base* pool );
+    void unregisterPool( component_pool_base* pool );
+    // Removes the entity from every pool of the current world that
+    // contains it
+    void removeFromPools( id::id_type id );
+
+    // Storage for components that live outside of the archetype
+    // chunks. Suitable for components that are frequently added to
+    // and removed from entities, since that doesn't move the entity
+    // to another archetype. Values are kept densely packed so systems
+    // iterate only the entities that actually have the component
+    template <typename T>
+    class component_pool final : public component_pool_base
+    {
+    public:
+        component_pool()
+        {
+            registerPool( this );
+        }
+
+        explicit component_pool( uint32_t count ) 
+         : 
+            m_Set( count )
+        {
+            registerPool( this );
+        }
+
+        ~component_pool() override
+        {
+            unregisterPool( this );
+        }
+
+        component_pool( const component_pool& ) = delete;
+        component_pool& operator=( const component_pool& ) = delete;
+
+        template <typename... params>
+        T& add( id::id_type id, params&&... p )
+        {
+            return m_Set.add( id, std::forward<params>( p )... );
+        }
+
+        void remove( id::id_type id ) override
+        {
+            m_Set.remove( id );
+        }
+
+        [[nodiscard]] bool contains( id::id_type id ) const override
+        {
+            return m_Set.contains( id );
+        }
+
+        [[nodiscard]] T& get( id::id_type id )
+        {
+            return m_Set[ id ];
+        }
+
+        [[nodiscard]] const T& get( id::id_type id ) const
+        {
+            return m_Set[ id ];
+        }
+
+        [[nodiscard]] uint32_t size() const
+        {
+            return m_Set.size();
+        }
+
+        // Dense arrays, the entity at position i owns the component at
+        // position i
+        [[nodiscard]] T* data() { return m_Set.data(); }
+        [[nodiscard]] const T* data() const { return m_Set.data(); }
+        [[nodiscard]] const id::id_type* entities() const { return m_Set.ids(); }
+
+        [[nodiscard]] T* begin() { return m_Set.begin(); }
+        [[nodiscard]] T* end() { return m_Set.end(); }
+        [[nodiscard]] const T* begin() const { return m_Set.begin(); }
+        [[nodiscard]] const T* end() const { return m_Set.end(); }
+
+    private:
+        utils::sparse_set<T>    m_Set;
+    };
+} // namespace muggy::ecs
+
+
+#endif
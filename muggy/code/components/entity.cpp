@@ -8,19 +8,48 @@
 
 #include "entity.h"
 #include "transform.h"
+#include "archetype.h"
+#include "componentPool.h"
+#include "idAllocator.h"
+#include "names.h"
+#include "world.h"
+
+namespace muggy::ecs::detail
+{
+    // The entity registry of a world.
+    // NOTE(klek): Ids are handed out without locking, but the chunk
+    //             storage and the transform hierarchy aren't thread
+    //             safe, so changing them is serialized with the mutex
+    struct registry_state
+    {
+        id::id_allocator    ids;
+        std::mutex          storageMutex;
+    };
+
+    registry_state* createRegistryState()
+    {
+        return new registry_state{};
+    }
+
+    void destroyState( registry_state* state )
+    {
+        delete state;
+    }
+} // namespace muggy::ecs::detail
 
 namespace muggy::game_entity
 {
     namespace 
     {
-        utils::vector<transform::component> transforms;
-        
-        utils::vector<id::generation_type>  generations;
-        utils::deque<entity_id>             freeIds;
+        ecs::detail::registry_state& getRegistry()
+        {
+            return ecs::getCurrentWorld().getRegistryState();
+        }
     } // namespace anonymous
     
     entity createGameEntity( const entity_info& info )
     {
+        ecs::detail::registry_state& registry{ getRegistry() };
         // Check that the entity info contains a transform
         // which all entities must have
         assert( info.transform );
@@ -30,89 +59,263 @@ namespace muggy::game_entity
             return {};
         }
 
-        entity_id id;
-
-        // Check if we should reuse slots or create new slots
-        if ( freeIds.size() > id::min_deleted_elements )
-        {
-            // Reusing available slots
-            id = freeIds.front();
-            assert( !isAlive( entity( id ) ) );
-            freeIds.pop_front();
-            id = entity_id{ id::newGeneration( id ) };
-            ++generations[ id::index( id ) ];
-            //generations[ id::index( id ) ];
-        }
-        else 
-        {
-            // Add new slots
-            id = entity_id{ (id::id_type)generations.size() };
-            generations.push_back( 0 );
-            // Why not use emplace_back here?
-            //generations.emplace_back( id );
-
-            // Resize components
-            // NOTE(klek): Here we call emplace_back instead of resize()
-            //             to keep the number of memory allocations low
-            transforms.emplace_back();
-        }
-
+        // Recycled ids come with their generation already bumped
+        const entity_id id{ registry.ids.allocate() };
         const entity newEntity{ id };
-        const id::id_type index{ id::index(id) };
+
+        std::lock_guard<std::mutex> lock{ registry.storageMutex };
+        // Place the entity in the chunk storage of its archetype. All
+        // entities have a transform, so that is the base of the mask
+        ecs::addEntity( id, transform::getComponentMask() );
 
         // Create transform compontent
-        assert( !transforms[ index ].isValid() );
-        transforms[ index ] = transform::createTransform( *info.transform, 
-                                                           newEntity );
-        if ( !transforms[ index ].isValid() )
+        const transform::component t{ 
+            transform::createTransform( *info.transform, newEntity ) };
+        if ( !t.isValid() )
         {
+            // The index is only handed out again once the row is gone
+            ecs::removeEntity( id );
+            registry.ids.retire( id );
+            registry.ids.recycle( id );
             // Return a default entity (ie invalid)
             return {};
         }
+        if ( info.tags )
+        {
+            ecs::setTags( id, info.tags );
+        }
 
         return newEntity;
     }
 
     void removeGameEntity( entity e )
     {
+        ecs::detail::registry_state& registry{ getRegistry() };
         const entity_id id{ e.getId() };
-        const id::id_type index{ id::index( id ) };
         // Check that this entity is alive
         assert( isAlive(e) );
-        if ( isAlive(e) )
+        // Retiring the id makes the entity stale right away. If two
+        // threads remove the same entity, only the first one gets here
+        if ( e.isValid() && registry.ids.retire( id ) )
+        {
+            {
+                std::lock_guard<std::mutex> lock{ registry.storageMutex };
+                // Remove transforms
+                transform::removeTransform( 
+                    transform::component{ transform::transform_id{ id } } );
+                // Release the row in the chunk storage, this moves the last
+                // entity of the archetype into the hole
+                ecs::removeEntity( id );
+                // Remove any components stored outside of the chunks
+                ecs::removeFromPools( id );
+                ecs::setTags( id, 0 );
+                detail::removeName( id );
+            }
+            // NOTE(klek): Another thread may create an entity with the
+            //             index as soon as it is recycled, so that has to
+            //             wait until the old entity is out of the storage
+            registry.ids.recycle( id );
+        }
+    }
+
+    void createGameEntities( utils::span<const entity_info> infos,
+                             utils::span<entity> entities )
+    {
+        assert( infos.size() == entities.size() );
+        const uint32_t count{ (uint32_t)infos.size() };
+        for ( uint32_t i{ 0 }; i < count; i++ )
         {
-            // Remove transforms
-            transform::removeTransform( transforms[ index ] );
-            // Replace the slot with a default component (ie invalid)
-            transforms[ index ] = {};
-            freeIds.push_back( id );
+            // Check that every entity info contains a transform
+            assert( infos[ i ].transform );
+            if ( !infos[ i ].transform )
+            {
+                // Return default entities (ie invalid)
+                for ( entity& e : entities )
+                {
+                    e = {};
+                }
+                return;
+            }
         }
+
+        // Recycles ids where possible and reserves fresh ones for the
+        // rest
+        utils::vector<id::id_type> newIds( count );
+        getRegistry().ids.allocate( newIds );
+        for ( uint32_t i{ 0 }; i < count; i++ )
+        {
+            entities[ i ] = entity{ entity_id{ newIds[ i ] } };
+        }
+
+        createReservedGameEntities( infos, entities );
     }
 
+    entity reserveGameEntity()
+    {
+        return entity{ entity_id{ getRegistry().ids.allocate() } };
+    }
+
+    void cancelReservedGameEntity( entity e )
+    {
+        ecs::detail::registry_state& registry{ getRegistry() };
+        assert( e.isValid() );
+        const bool released{ registry.ids.release( e.getId() ) };
+        assert( released );
+        (void)released;
+    }
+
+    void createReservedGameEntities( utils::span<const entity_info> infos,
+                                     utils::span<const entity> entities )
+    {
+        assert( infos.size() == entities.size() );
+        if ( entities.empty() )
+        {
+            return;
+        }
+
+        utils::vector<id::id_type> entityIds( entities.size() );
+        for ( uint32_t i{ 0 }; i < entities.size(); i++ )
+        {
+            // Every entity info has to contain a transform
+            assert( infos[ i ].transform );
+            entityIds[ i ] = entities[ i ].getId();
+        }
+
+        // Place all entities in contiguous rows of the storage and 
+        // fill their transform columns
+        std::lock_guard<std::mutex> lock{ getRegistry().storageMutex };
+        ecs::addEntities( entityIds, transform::getComponentMask() );
+        transform::createTransforms( infos, entities );
+        for ( uint32_t i{ 0 }; i < entities.size(); i++ )
+        {
+            if ( infos[ i ].tags )
+            {
+                ecs::setTags( entityIds[ i ], infos[ i ].tags );
+            }
+        }
+    }
+
+    void removeGameEntities( utils::span<const entity> entities )
+    {
+        ecs::detail::registry_state& registry{ getRegistry() };
+        struct sort_item
+        {
+            uint64_t    key;
+            id::id_type id;
+        };
+
+        // Remove entities in order of their storage row, highest row
+        // first. That way entities at the end of an archetype are 
+        // popped without moving any other row, and the rows of the
+        // entities still to be removed are never changed by the moves
+        utils::vector<sort_item> items;
+        items.reserve( entities.size() );
+        utils::vector<id::id_type> removedIds;
+        removedIds.reserve( entities.size() );
+        std::unique_lock<std::mutex> lock{ registry.storageMutex };
+        for ( const entity e : entities )
+        {
+            // Check that this entity is alive
+            assert( isAlive( e ) );
+            const ecs::entity_location& location{ ecs::getLocation( e.getId() ) };
+            items.push_back( { ( (uint64_t)location.archetype << 32 ) | location.row,
+                               e.getId() } );
+        }
+        if ( items.empty() )
+        {
+            return;
+        }
+        std::sort( items.begin(), items.end(), 
+                   []( const sort_item& a, const sort_item& b ) 
+                   { 
+                       return a.key > b.key; 
+                   } );
+
+        for ( const sort_item& item : items )
+        {
+            // Skip entities that were already removed, for instance
+            // when they're in the list twice
+            if ( !registry.ids.retire( item.id ) )
+            {
+                continue;
+            }
+            transform::removeTransform( 
+                transform::component{ transform::transform_id{ item.id } } );
+            ecs::removeEntity( item.id );
+            ecs::removeFromPools( item.id );
+            ecs::setTags( item.id, 0 );
+            detail::removeName( item.id );
+            removedIds.push_back( item.id );
+        }
+        lock.unlock();
+
+        // The indices can be reused now that none of them are stored
+        registry.ids.recycle( removedIds );
+    }
+
+    uint32_t areAlive( utils::span<const entity> entities, utils::bitset& alive )
+    {
+        ecs::detail::registry_state& registry{ getRegistry() };
+        const uint64_t count{ entities.size() };
+        alive.resize( count );
+        uint64_t *const words{ alive.words() };
+        uint32_t aliveCount{ 0 };
+        for ( uint64_t i{ 0 }; i < alive.wordCount(); i++ )
+        {
+            const uint64_t first{ i * utils::bitset::word_bits };
+            const uint64_t last{ std::min( first + utils::bitset::word_bits, count ) };
+            // NOTE(klek): entity is just a wrapped id, so the handles can
+            //             be checked in place
+            static_assert( sizeof( entity ) == sizeof( id::id_type ) );
+            const uint64_t word{ registry.ids.areStored( (const id::id_type*)( entities.data() + first ),
+                                                 (uint32_t)( last - first ) ) };
+            words[ i ] = word;
+            aliveCount += utils::popCount( word );
+        }
+        return aliveCount;
+    }
+
+    namespace detail
+    {
+        id::id_allocator& getIdAllocator()
+        {
+            return getRegistry().ids;
+        }
+
+        void getCurrentIds( id::id_type first, uint64_t bits, id::id_type* entityIds )
+        {
+            getRegistry().ids.getCurrentIds( first, bits, entityIds );
+        }
+
+        std::mutex& getStorageMutex()
+        {
+            return getRegistry().storageMutex;
+        }
+    } // namespace detail
+
     bool isAlive( entity e )
     {
+        ecs::detail::registry_state& registry{ getRegistry() };
         // DEBUG: Check that the entity is valid
         assert( e.isValid() );
         const entity_id id{ e.getId() };
-        const id::id_type index{ id::index( id ) };
-        // DEBUG: Check that index is withing the size of generations
-        assert( index < generations.size() );
-        // DEBUG: Check that the current generation is as expected
-        //assert( generations[ index ] == id::generation( id ) );
-
-        // If the current generation for this index is equal to the expected
-        // generation and the transform for this entity is valid, then this 
-        // entity is alive
-        return ( generations[ index ] == id::generation( id ) && 
-                 transforms[ index ].isValid()                  );
+        // DEBUG: Check that index is withing the range of handed out ids
+        assert( id::index( id ) < registry.ids.getIndexCount() );
+
+        // The generation is bumped when an entity is removed, so if the
+        // current generation for this index is equal to the expected 
+        // generation and the entity is in the storage, then it is alive.
+        // Both are read from the id allocator, so this is safe while
+        // other threads create entities
+        return registry.ids.isStored( id );
     }
 
     transform::component entity::getTransform() const
     {
         // DEBUG: Check that the entity is valid
         assert( isAlive( *this ) );
-        const id::id_type index{ id::index( m_Id ) };
-        return transforms[ index ];
+        // The transform shares id with the entity
+        return transform::component{ transform::transform_id{ m_Id } };
     }
 
 } // namespace muggy::entity
@@ -10,6 +10,9 @@
 #define ENTITY_H
 
 #include "componentsCommon.h"
+#include "archetype.h"
+#include "tags.h"
+#include <mutex>
 
 namespace muggy
 {
@@ -19,6 +22,12 @@ namespace muggy
     {
         struct init_info;
     } // namespace transform
+
+    // Forward declaration of the id allocator
+    namespace id
+    {
+        class id_allocator;
+    } // namespace id
     // ***************************************************************
 
     namespace game_entity
@@ -27,12 +36,105 @@ namespace muggy
         {
             // should contain a transform
             transform::init_info* transform{ nullptr };
+            // Tags the entity starts with, see ecs::tagMask()
+            ecs::tag_mask         tags{ 0 };
         };
     
         entity createGameEntity( const entity_info& info );
         void removeGameEntity( entity e );
+        // Returns true if the entity was created and not removed yet, ie
+        // if forEachAlive() visits it. Reserved entities are not alive
         bool isAlive( entity e );
 
+        // Sets bit i of "alive" if entities[ i ] is alive and returns the
+        // number of alive entities. Unlike isAlive() invalid handles are
+        // allowed and reported as dead. The bits are built 64 at a time
+        uint32_t areAlive( utils::span<const entity> entities, 
+                           utils::bitset& alive );
+
+        // Creates one entity per info and writes them to "entities",
+        // which must be of the same size as "infos". Ids are recycled
+        // and the component storage is filled in bulk
+        void createGameEntities( utils::span<const entity_info> infos,
+                                 utils::span<entity> entities );
+        // Removes all entities, which all have to be alive
+        void removeGameEntities( utils::span<const entity> entities );
+
+        // Reserves an id for an entity that is created later on with
+        // createReservedGameEntities(). Unlike the other functions this
+        // doesn't touch the storage, so it can be called from any thread.
+        // NOTE(klek): A reserved entity isn't alive until it is created,
+        //             same as for forEachAlive()
+        entity reserveGameEntity();
+        // Gives back a reserved entity that was never created
+        void cancelReservedGameEntity( entity e );
+        // Places reserved entities in the storage, one per info
+        void createReservedGameEntities( utils::span<const entity_info> infos,
+                                         utils::span<const entity> entities );
+
+        namespace detail
+        {
+            // The allocator of all entity ids, used to save and restore
+            // the id state in snapshots
+            id::id_allocator& getIdAllocator();
+            // Writes the current id of index first + i for each bit i set
+            // in "bits" to "ids", see id_allocator::getCurrentIds()
+            void getCurrentIds( id::id_type first, uint64_t bits, id::id_type* ids );
+            // Must be held while changing the chunk storage or the
+            // transform hierarchy from code that may run concurrently
+            // with entity creation and removal
+            std::mutex& getStorageMutex();
+
+            // Calls func( entity ) for every bit set in "words", where bit
+            // i stands for the entity with index i. Words without bits
+            // set are skipped
+            template <typename F>
+            void forEachInWords( const uint64_t* words, uint64_t wordCount, F&& func )
+            {
+                id::id_type ids[ utils::bitset::word_bits ];
+                for ( uint64_t i{ 0 }; i < wordCount; i++ )
+                {
+                    const uint64_t bits{ words[ i ] };
+                    if ( !bits )
+                    {
+                        continue;
+                    }
+                    getCurrentIds( (id::id_type)( i * utils::bitset::word_bits ), bits, ids );
+                    const uint32_t count{ utils::popCount( bits ) };
+                    for ( uint32_t j{ 0 }; j < count; j++ )
+                    {
+                        func( entity{ entity_id{ ids[ j ] } } );
+                    }
+                }
+            }
+        } // namespace detail
+
+        // Calls func( entity ) for every entity in the storage, ie every
+        // created entity that hasn't been removed, in order of its index.
+        // Unused indices are skipped 64 at a time.
+        // NOTE(klek): Entities must not be created while iterating. The
+        //             visited entity may be removed, but no others
+        template <typename F>
+        void forEachAlive( F&& func )
+        {
+            const utils::bitset& occupancy{ ecs::getOccupancy() };
+            detail::forEachInWords( occupancy.words(), occupancy.wordCount(), 
+                                    std::forward<F>( func ) );
+        }
+
+        // Calls func( entity ) for every entity that has all tags of
+        // "all" and none of "none", in order of its index. The filter
+        // is done up front with ecs::filterTags(), so the same rules as
+        // for forEachAlive() apply
+        template <typename F>
+        void forEachTagged( ecs::tag_mask all, ecs::tag_mask none, F&& func )
+        {
+            utils::bitset tagged;
+            ecs::filterTags( all, none, tagged );
+            detail::forEachInWords( tagged.words(), tagged.wordCount(), 
+                                    std::forward<F>( func ) );
+        }
+
     } // namespace game_entity
     
     
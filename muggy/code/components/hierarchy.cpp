@@ -0,0 +1,390 @@
+//********************************************************************
+//  File:    hierarchy.cpp
+//  Date:    Sat, 17 Oct 2026: 11:52
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "hierarchy.h"
+#include "transform.h"
+#include "world.h"
+#include "../utilities/bitset.h"
+
+namespace muggy::ecs::detail
+{
+    // The nodes are kept in a flat array where every parent comes
+    // before its children, which means the world matrices can be
+    // updated in a single linear pass.
+    // Removed nodes are only marked as removed and reparenting can
+    // break the ordering, in both cases the arrays are rebuilt 
+    // (sorted by depth) at the start of the next update
+    struct hierarchy_state
+    {
+        utils::vector<id::id_type>      nodeEntities;
+        utils::vector<uint32_t>         nodeParents;
+        utils::vector<math::fmat4>      worldMatrices;
+        utils::bitset                   dirty;
+
+        // Indexed by entity index
+        utils::vector<uint32_t>         nodeIndices;
+
+        uint32_t                        removedCount{ 0 };
+        bool                            needsSort{ false };
+        // Change version of the transform columns at the last update
+        uint32_t                        updateVersion{ 0 };
+    };
+
+    hierarchy_state* createHierarchyState()
+    {
+        return new hierarchy_state{};
+    }
+
+    void destroyState( hierarchy_state* state )
+    {
+        delete state;
+    }
+} // namespace muggy::ecs::detail
+
+namespace muggy::transform
+{
+    namespace
+    {
+        ecs::detail::hierarchy_state& getHierarchy()
+        {
+            return ecs::getCurrentWorld().getHierarchyState();
+        }
+
+        uint32_t getNode( const ecs::detail::hierarchy_state& hierarchy,
+                          id::id_type id )
+        {
+            const id::id_type index{ id::index( id ) };
+            assert( index < hierarchy.nodeIndices.size() && 
+                    hierarchy.nodeIndices[ index ] != uint32_invalid_id );
+            const uint32_t node{ hierarchy.nodeIndices[ index ] };
+            assert( hierarchy.nodeEntities[ node ] == id );
+            return node;
+        }
+
+        // Sorts the nodes by depth and drops removed nodes. Children of
+        // removed nodes become root nodes
+        void rebuild( ecs::detail::hierarchy_state& hierarchy )
+        {
+            const uint32_t count{ (uint32_t)hierarchy.nodeEntities.size() };
+            utils::vector<uint32_t> depths( count, uint32_invalid_id );
+            utils::vector<uint32_t> stack;
+            uint32_t maxDepth{ 0 };
+            uint32_t liveCount{ 0 };
+
+            for ( uint32_t i{ 0 }; i < count; i++ )
+            {
+                if ( !id::isValid( hierarchy.nodeEntities[ i ] ) )
+                {
+                    continue;
+                }
+                liveCount++;
+
+                // Walk up until we find a node with a known depth
+                uint32_t node{ i };
+                while ( depths[ node ] == uint32_invalid_id )
+                {
+                    const uint32_t parent{ hierarchy.nodeParents[ node ] };
+                    if ( parent != uint32_invalid_id && 
+                         !id::isValid( hierarchy.nodeEntities[ parent ] ) )
+                    {
+                        // The parent was removed, detach this node
+                        hierarchy.nodeParents[ node ] = uint32_invalid_id;
+                        hierarchy.dirty.set( node );
+                    }
+
+                    if ( hierarchy.nodeParents[ node ] == uint32_invalid_id )
+                    {
+                        depths[ node ] = 0;
+                        break;
+                    }
+                    stack.push_back( node );
+                    node = hierarchy.nodeParents[ node ];
+                }
+
+                // Then assign depths on the way back down
+                uint32_t depth{ depths[ node ] };
+                while ( !stack.empty() )
+                {
+                    depths[ stack.back() ] = ++depth;
+                    utils::erase_unordered( stack, stack.size() - 1 );
+                }
+                maxDepth = std::max( maxDepth, depth );
+            }
+
+            // Counting sort by depth, which keeps the relative order of
+            // nodes at the same depth
+            utils::vector<uint32_t> offsets( maxDepth + 2, 0 );
+            for ( uint32_t i{ 0 }; i < count; i++ )
+            {
+                if ( depths[ i ] != uint32_invalid_id )
+                {
+                    offsets[ depths[ i ] + 1 ]++;
+                }
+            }
+            for ( uint32_t d{ 1 }; d < offsets.size(); d++ )
+            {
+                offsets[ d ] += offsets[ d - 1 ];
+            }
+
+            utils::vector<uint32_t> newIndices( count, uint32_invalid_id );
+            for ( uint32_t i{ 0 }; i < count; i++ )
+            {
+                if ( depths[ i ] != uint32_invalid_id )
+                {
+                    newIndices[ i ] = offsets[ depths[ i ] ]++;
+                }
+            }
+
+            utils::vector<id::id_type> entities( liveCount );
+            utils::vector<uint32_t> parents( liveCount );
+            utils::vector<math::fmat4> worlds( liveCount );
+            utils::bitset newDirty( liveCount );
+            for ( uint32_t i{ 0 }; i < count; i++ )
+            {
+                const uint32_t n{ newIndices[ i ] };
+                if ( n == uint32_invalid_id )
+                {
+                    continue;
+                }
+
+                const uint32_t parent{ hierarchy.nodeParents[ i ] };
+                entities[ n ] = hierarchy.nodeEntities[ i ];
+                parents[ n ] = ( parent == uint32_invalid_id ) ? 
+                                    uint32_invalid_id : newIndices[ parent ];
+                worlds[ n ] = hierarchy.worldMatrices[ i ];
+                if ( hierarchy.dirty.test( i ) )
+                {
+                    newDirty.set( n );
+                }
+                hierarchy.nodeIndices[ id::index( entities[ n ] ) ] = n;
+            }
+
+            hierarchy.nodeEntities = entities;
+            hierarchy.nodeParents = parents;
+            hierarchy.worldMatrices = worlds;
+            hierarchy.dirty = newDirty;
+            hierarchy.removedCount = 0;
+            hierarchy.needsSort = false;
+        }
+
+        // Marks the nodes whose position, rotation or scale was written
+        // since the last update as dirty. Whole chunks are skipped when
+        // none of their rows changed
+        void markChangedNodes( ecs::detail::hierarchy_state& hierarchy )
+        {
+            const uint32_t since{ hierarchy.updateVersion };
+            hierarchy.updateVersion = ecs::advanceVersion();
+            const ecs::component_type types[]{ ecs::componentType<position>(),
+                                               ecs::componentType<rotation>(),
+                                               ecs::componentType<scale>() };
+            ecs::forEachChunk( getComponentMask(), 
+                [since, &types, &hierarchy]( ecs::archetype& a, uint32_t chunk, uint32_t count )
+                {
+                    for ( const ecs::component_type type : types )
+                    {
+                        if ( !ecs::isNewer( a.getChunkVersion( chunk, type ), since ) )
+                        {
+                            continue;
+                        }
+
+                        const id::id_type *const ids{ a.getEntities( chunk ) };
+                        const uint32_t *const versions{ a.getVersions( chunk, type ) };
+                        for ( uint32_t i{ 0 }; i < count; i++ )
+                        {
+                            const id::id_type index{ id::index( ids[ i ] ) };
+                            if ( ecs::isNewer( versions[ i ], since ) && 
+                                 index < hierarchy.nodeIndices.size() &&
+                                 hierarchy.nodeIndices[ index ] != uint32_invalid_id )
+                            {
+                                hierarchy.dirty.set( hierarchy.nodeIndices[ index ] );
+                            }
+                        }
+                    }
+                } );
+        }
+    } // namespace anonymous
+
+    namespace detail
+    {
+        void addNode( id::id_type id, id::id_type parent )
+        {
+            ecs::detail::hierarchy_state& hierarchy{ getHierarchy() };
+            const id::id_type index{ id::index( id ) };
+            if ( index >= hierarchy.nodeIndices.size() )
+            {
+                hierarchy.nodeIndices.resize( index + 1, uint32_invalid_id );
+            }
+            assert( hierarchy.nodeIndices[ index ] == uint32_invalid_id );
+
+            // NOTE(klek): Since the parent already exists, appending the
+            //             node keeps parents before their children
+            const uint32_t node{ (uint32_t)hierarchy.nodeEntities.size() };
+            hierarchy.nodeEntities.push_back( id );
+            hierarchy.nodeParents.push_back( id::isValid( parent ) ? 
+                                   getNode( hierarchy, parent ) : uint32_invalid_id );
+            hierarchy.worldMatrices.push_back( math::fmat4::identity() );
+            hierarchy.dirty.resize( node + 1 );
+            hierarchy.dirty.set( node );
+            hierarchy.nodeIndices[ index ] = node;
+        }
+
+        void addNodes( utils::span<const id::id_type> ids,
+                       utils::span<const id::id_type> parents )
+        {
+            assert( parents.empty() || parents.size() == ids.size() );
+            if ( ids.empty() )
+            {
+                return;
+            }
+            ecs::detail::hierarchy_state& hierarchy{ getHierarchy() };
+
+            // Grow the arrays once instead of once per node
+            id::id_type maxIndex{ 0 };
+            for ( const id::id_type id : ids )
+            {
+                maxIndex = std::max( maxIndex, id::index( id ) );
+            }
+            if ( maxIndex >= hierarchy.nodeIndices.size() )
+            {
+                hierarchy.nodeIndices.resize( maxIndex + 1, uint32_invalid_id );
+            }
+            const uint32_t first{ (uint32_t)hierarchy.nodeEntities.size() };
+            const uint32_t count{ (uint32_t)ids.size() };
+            hierarchy.nodeEntities.reserve( first + count );
+            hierarchy.nodeParents.reserve( first + count );
+            hierarchy.worldMatrices.reserve( first + count );
+            hierarchy.dirty.resize( first + count );
+
+            for ( uint32_t i{ 0 }; i < count; i++ )
+            {
+                const id::id_type index{ id::index( ids[ i ] ) };
+                assert( hierarchy.nodeIndices[ index ] == uint32_invalid_id );
+                const id::id_type parent{ parents.empty() ? 
+                                          id::invalid_id : parents[ i ] };
+                hierarchy.nodeEntities.push_back( ids[ i ] );
+                hierarchy.nodeParents.push_back( id::isValid( parent ) ? 
+                                       getNode( hierarchy, parent ) : uint32_invalid_id );
+                hierarchy.worldMatrices.push_back( math::fmat4::identity() );
+                hierarchy.dirty.set( first + i );
+                hierarchy.nodeIndices[ index ] = first + i;
+            }
+        }
+
+        void removeNode( id::id_type id )
+        {
+            ecs::detail::hierarchy_state& hierarchy{ getHierarchy() };
+            const uint32_t node{ getNode( hierarchy, id ) };
+            hierarchy.nodeEntities[ node ] = id::invalid_id;
+            hierarchy.nodeIndices[ id::index( id ) ] = uint32_invalid_id;
+            hierarchy.dirty.reset( node );
+            hierarchy.removedCount++;
+        }
+    } // namespace detail
+
+    bool setParent( component child, component parent )
+    {
+        assert( child.isValid() );
+        ecs::detail::hierarchy_state& hierarchy{ getHierarchy() };
+        const uint32_t node{ getNode( hierarchy, child.getId() ) };
+        uint32_t parentNode{ uint32_invalid_id };
+        if ( parent.isValid() )
+        {
+            parentNode = getNode( hierarchy, parent.getId() );
+            // NOTE(klek): A cycle would make rebuild() walk up forever,
+            //             so it is refused in release builds as well.
+            //             The links above a removed node are cut in the
+            //             next rebuild(), so the walk stops there
+            for ( uint32_t p{ parentNode }; 
+                  p != uint32_invalid_id && id::isValid( hierarchy.nodeEntities[ p ] );
+                  p = hierarchy.nodeParents[ p ] )
+            {
+                if ( p == node )
+                {
+                    return false;
+                }
+            }
+        }
+
+        hierarchy.nodeParents[ node ] = parentNode;
+        if ( parentNode != uint32_invalid_id && parentNode > node )
+        {
+            hierarchy.needsSort = true;
+        }
+        hierarchy.dirty.set( node );
+        return true;
+    }
+
+    component getParent( component child )
+    {
+        assert( child.isValid() );
+        const ecs::detail::hierarchy_state& hierarchy{ getHierarchy() };
+        const uint32_t parent{ hierarchy.nodeParents[ getNode( hierarchy, child.getId() ) ] };
+        if ( parent == uint32_invalid_id || !id::isValid( hierarchy.nodeEntities[ parent ] ) )
+        {
+            return {};
+        }
+        return component{ transform_id{ hierarchy.nodeEntities[ parent ] } };
+    }
+
+    void updateWorldMatrices()
+    {
+        ecs::detail::hierarchy_state& hierarchy{ getHierarchy() };
+        if ( hierarchy.needsSort || hierarchy.removedCount )
+        {
+            rebuild( hierarchy );
+        }
+        markChangedNodes( hierarchy );
+
+        if ( !hierarchy.dirty.any() )
+        {
+            return;
+        }
+
+        const uint32_t count{ (uint32_t)hierarchy.nodeEntities.size() };
+        for ( uint32_t i{ 0 }; i < count; i++ )
+        {
+            // Parents are always processed before their children, so a
+            // dirty parent propagates to the whole subtree in this pass
+            const uint32_t parent{ hierarchy.nodeParents[ i ] };
+            if ( parent != uint32_invalid_id && hierarchy.dirty.test( parent ) )
+            {
+                hierarchy.dirty.set( i );
+            }
+
+            if ( !hierarchy.dirty.test( i ) )
+            {
+                continue;
+            }
+
+            const id::id_type id{ hierarchy.nodeEntities[ i ] };
+            const math::fmat4 local{ math::fmat4::transformation( 
+                                        *ecs::getComponent<position>( id ),
+                                        *ecs::getComponent<rotation>( id ),
+                                        *ecs::getComponent<scale>( id ) ) };
+            if ( parent != uint32_invalid_id )
+            {
+                hierarchy.worldMatrices[ i ] = hierarchy.worldMatrices[ parent ];
+                hierarchy.worldMatrices[ i ].multiply( local );
+            }
+            else
+            {
+                hierarchy.worldMatrices[ i ] = local;
+            }
+        }
+
+        hierarchy.dirty.clearAll();
+    }
+
+    math::fmat4 component::getWorldMatrix() const
+    {
+        // DEBUG: Check that this component is valid
+        assert( isValid() );
+        const ecs::detail::hierarchy_state& hierarchy{ getHierarchy() };
+        return hierarchy.worldMatrices[ getNode( hierarchy, m_Id ) ];
+    }
+} // namespace muggy::transform
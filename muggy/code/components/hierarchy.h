@@ -0,0 +1,32 @@
+//********************************************************************
+//  File:    hierarchy.h
+//  Date:    Sat, 17 Oct 2026: 11:48
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(HIERARCHY_H)
+#define HIERARCHY_H
+
+#include "componentsCommon.h"
+
+// NOTE(klek): These functions are used by the transform component to
+//             keep the hierarchy in sync with the transform storage.
+//             The public part of the hierarchy is declared in 
+//             transform.h
+namespace muggy::transform::detail
+{
+    // Adds a node for the transform with the specified parent, which
+    // can be invalid_id for a root transform. The parent must exist
+    void addNode( id::id_type id, id::id_type parent );
+    // Same as addNode() for many transforms at once, where parents[i]
+    // is the parent of ids[i]. Parents must either exist already or
+    // come earlier in "ids". An empty "parents" makes all of them roots
+    void addNodes( utils::span<const id::id_type> ids, 
+                   utils::span<const id::id_type> parents );
+    void removeNode( id::id_type id );
+} // namespace muggy::transform::detail
+
+
+#endif
@@ -0,0 +1,543 @@
+//********************************************************************
+//  File:    idAllocator.cpp
+//  Date:    Sat, 17 Oct 2026: 19:20
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "idAllocator.h"
+#include "../utilities/bitset.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace muggy::id
+{
+    namespace
+    {
+        // The last index is reserved, since id::index() treats it as
+        // invalid
+        constexpr uint64_t max_indices{ detail::indexMask };
+
+        // Cache slot that the current thread tries first. Assigned
+        // round robin, so threads spread out over the slots
+        std::atomic<uint32_t>   nextCacheHint{ 0 };
+        thread_local uint32_t   cacheHint{ uint32_invalid_id };
+    } // namespace anonymous
+
+    id_allocator::id_allocator()
+     :
+        m_PageCount( (uint32_t)( ( max_indices + page_size - 1 ) / page_size ) ),
+        m_FullBatches( queue_capacity ),
+        m_EmptyBatches( spare_batch_count )
+    {
+        // NOTE(klek): With 64-bit ids the table has room for 64K pages.
+        //             calloc() gets it as zeroed memory from the OS, so
+        //             only the part that is used takes up physical memory
+        static_assert( std::atomic<id_page*>::is_always_lock_free &&
+                       sizeof( std::atomic<id_page*> ) == sizeof( id_page* ),
+                       "A zeroed atomic pointer must be a null pointer" );
+        m_Pages = static_cast<std::atomic<id_page*>*>( 
+                        calloc( m_PageCount, sizeof( std::atomic<id_page*> ) ) );
+        assert( m_Pages );
+        for ( uint32_t i{ 0 }; i < cache_count; i++ )
+        {
+            m_Caches[ i ].store( nullptr, std::memory_order_relaxed );
+        }
+    }
+
+    id_allocator::~id_allocator()
+    {
+        for ( uint32_t i{ 0 }; i < m_PageCount; i++ )
+        {
+            delete m_Pages[ i ].load( std::memory_order_relaxed );
+        }
+        free( m_Pages );
+        for ( uint32_t i{ 0 }; i < cache_count; i++ )
+        {
+            delete m_Caches[ i ].load( std::memory_order_relaxed );
+        }
+
+        // Every batch is in one of the queues when nobody allocates
+        while ( batch* b{ popFull() } )
+        {
+            delete b;
+        }
+        batch* b;
+        while ( m_EmptyBatches.pop( b ) )
+        {
+            delete b;
+        }
+    }
+
+    id_type id_allocator::allocate()
+    {
+        cache& c{ lockCache() };
+        if ( !c.allocCount )
+        {
+            refill( c );
+        }
+        const id_type id{ c.allocIds[ --c.allocCount ] };
+        unlockCache( c );
+        return id;
+    }
+
+    void id_allocator::allocate( utils::span<id_type> ids )
+    {
+        // Hold on to the same cache for all ids instead of looking it
+        // up once per id
+        cache& c{ lockCache() };
+        for ( id_type& id : ids )
+        {
+            if ( !c.allocCount )
+            {
+                refill( c );
+            }
+            id = c.allocIds[ --c.allocCount ];
+        }
+        unlockCache( c );
+    }
+
+    bool id_allocator::retire( id_type id )
+    {
+        assert( isValid( id ) );
+        const id_type index{ id::index( id ) };
+        assert( index < getIndexCount() );
+        id_page* page{ getPage( index ) };
+        assert( page );
+
+        // Bump the generation, but only if nobody else did so already.
+        // This makes sure that every id is recycled exactly once
+        generation_type expected{ (generation_type)generation( id ) };
+        return page->generations[ index % page_size ].compare_exchange_strong(
+                    expected, (generation_type)generation( newGeneration( id ) ),
+                    std::memory_order_acq_rel );
+    }
+
+    void id_allocator::recycle( id_type id )
+    {
+        recycle( utils::span<const id_type>{ &id, 1 } );
+    }
+
+    void id_allocator::recycle( utils::span<const id_type> ids )
+    {
+        cache& c{ lockCache() };
+        for ( const id_type id : ids )
+        {
+            const id_type next{ newGeneration( id ) };
+            assert( isCurrent( next ) );
+            c.freeIds[ c.freeCount++ ] = next;
+            if ( c.freeCount == batch_size )
+            {
+                flush( c );
+            }
+        }
+        unlockCache( c );
+    }
+
+    bool id_allocator::release( id_type id )
+    {
+        if ( !retire( id ) )
+        {
+            return false;
+        }
+        recycle( id );
+        return true;
+    }
+
+    bool id_allocator::isCurrent( id_type id ) const
+    {
+        assert( isValid( id ) );
+        const id_type index{ id::index( id ) };
+        if ( index >= getIndexCount() )
+        {
+            return false;
+        }
+        // NOTE(klek): The page of a freshly reserved block is made
+        //             right after the index count is bumped, so it may
+        //             still be missing for ids that were never handed out
+        const id_page* page{ getPage( index ) };
+        return ( page &&
+                 page->generations[ index % page_size ].load( std::memory_order_acquire ) ==
+                 generation( id ) );
+    }
+
+    generation_type id_allocator::getGeneration( id_type index ) const
+    {
+        assert( index < getIndexCount() );
+        const id_page* page{ getPage( index ) };
+        return page ? page->generations[ index % page_size ].load( std::memory_order_acquire ) : 0;
+    }
+
+    void id_allocator::setStored( id_type index, bool stored )
+    {
+        assert( index < getIndexCount() );
+        id_page* page{ getPage( index ) };
+        assert( page );
+        const uint64_t bit{ uint64_t{ 1 } << ( index % 64 ) };
+        std::atomic<uint64_t>& word{ page->stored[ ( index % page_size ) / 64 ] };
+        if ( stored )
+        {
+            word.fetch_or( bit, std::memory_order_release );
+        }
+        else
+        {
+            word.fetch_and( ~bit, std::memory_order_release );
+        }
+    }
+
+    bool id_allocator::isStored( id_type id ) const
+    {
+        assert( isValid( id ) );
+        const id_type index{ id::index( id ) };
+        if ( index >= getIndexCount() )
+        {
+            return false;
+        }
+        const id_page* page{ getPage( index ) };
+        const uint32_t slot{ (uint32_t)( index % page_size ) };
+        return ( page &&
+                 page->generations[ slot ].load( std::memory_order_acquire ) == generation( id ) &&
+                 ( ( page->stored[ slot / 64 ].load( std::memory_order_acquire ) >> 
+                     ( slot % 64 ) ) & 1 ) );
+    }
+
+    uint64_t id_allocator::areStored( const id_type* ids, uint32_t count ) const
+    {
+        assert( count <= 64 );
+        const id_type indexCount{ getIndexCount() };
+        // Ids in a list are often close to each other, so keep the page
+        // of the previous one around
+        const id_page* page{ nullptr };
+        id_type pageIndex{ invalid_id };
+        uint64_t result{ 0 };
+        for ( uint32_t i{ 0 }; i < count; i++ )
+        {
+            const id_type id{ ids[ i ] };
+            if ( !isValid( id ) )
+            {
+                continue;
+            }
+            const id_type index{ id::index( id ) };
+            if ( index >= indexCount )
+            {
+                continue;
+            }
+            if ( index / page_size != pageIndex )
+            {
+                pageIndex = index / page_size;
+                page = getPage( index );
+            }
+            // NOTE(klek): Dead ids are mixed in at random, so the result
+            //             bit is set without a branch
+            const uint32_t slot{ (uint32_t)( index % page_size ) };
+            const bool stored{ page && 
+                               page->generations[ slot ].load( std::memory_order_acquire ) == 
+                               generation( id ) &&
+                               ( ( page->stored[ slot / 64 ].load( std::memory_order_acquire ) >>
+                                   ( slot % 64 ) ) & 1 ) };
+            result |= (uint64_t)stored << i;
+        }
+        return result;
+    }
+
+    void id_allocator::getCurrentIds( id_type first, uint64_t bits, id_type* ids ) const
+    {
+        static_assert( page_size % 64 == 0 );
+        assert( first % 64 == 0 );
+        if ( !bits )
+        {
+            return;
+        }
+        // All 64 indices are on the same page
+        const id_page* page{ getPage( first ) };
+        assert( page );
+        for ( ; bits; bits &= bits - 1 )
+        {
+            const id_type index{ first + utils::countTrailingZeros( bits ) };
+            assert( index < getIndexCount() );
+            const id_type gen{ page->generations[ index % page_size ].load( std::memory_order_acquire ) };
+            *ids++ = ( gen << detail::indexBits ) | index;
+        }
+    }
+
+    void id_allocator::restore( utils::span<const generation_type> generations,
+                                utils::span<const id_type> freeIds )
+    {
+        assert( generations.size() <= max_indices );
+
+        // Forget every id in the caches and in the queue
+        for ( uint32_t i{ 0 }; i < cache_count; i++ )
+        {
+            cache* c{ m_Caches[ i ].load( std::memory_order_relaxed ) };
+            if ( c )
+            {
+                assert( !c->busy.load( std::memory_order_relaxed ) );
+                c->allocCount = 0;
+                c->freeCount = 0;
+            }
+        }
+        while ( batch* b{ popFull() } )
+        {
+            b->count = 0;
+            if ( !m_EmptyBatches.push( b ) )
+            {
+                delete b;
+            }
+        }
+        m_QueuedIds.store( 0, std::memory_order_relaxed );
+
+        // Clear the pages that are already there and set the restored
+        // generations
+        for ( uint32_t i{ 0 }; i < m_PageCount; i++ )
+        {
+            id_page* page{ m_Pages[ i ].load( std::memory_order_relaxed ) };
+            for ( uint32_t j{ 0 }; page && j < page_size; j++ )
+            {
+                page->generations[ j ].store( 0, std::memory_order_relaxed );
+            }
+            for ( uint32_t j{ 0 }; page && j < page_size / 64; j++ )
+            {
+                page->stored[ j ].store( 0, std::memory_order_relaxed );
+            }
+        }
+        const id_type count{ (id_type)generations.size() };
+        for ( id_type index{ 0 }; index < count; index++ )
+        {
+            id_page* page{ ( index % page_size ) ? getPage( index ) : makePage( index ) };
+            page->generations[ index % page_size ].store( generations[ index ],
+                                             std::memory_order_relaxed );
+        }
+        m_NextIndex.store( count, std::memory_order_release );
+
+        // Queue the free ids in the same order as they were given
+        uint64_t first{ 0 };
+        while ( first < freeIds.size() )
+        {
+            const uint32_t n{ (uint32_t)std::min<uint64_t>( batch_size,
+                                                            freeIds.size() - first ) };
+            batch* b{ getBatch() };
+            for ( uint32_t i{ 0 }; i < n; i++ )
+            {
+                assert( id::index( freeIds[ first + i ] ) < count );
+                b->ids[ i ] = freeIds[ first + i ];
+            }
+            b->count = n;
+            m_QueuedIds.fetch_add( n, std::memory_order_relaxed );
+            pushFull( b );
+            first += n;
+        }
+    }
+
+    id_allocator::cache& id_allocator::lockCache()
+    {
+        if ( cacheHint == uint32_invalid_id )
+        {
+            cacheHint = nextCacheHint.fetch_add( 1, std::memory_order_relaxed );
+        }
+
+        // Try the preferred slot first and move on to the next one if
+        // it is busy. A thread that is preempted while holding a slot
+        // can't block the others
+        for ( uint32_t i{ cacheHint }; ; i++ )
+        {
+            cache& c{ getCache( i % cache_count ) };
+            if ( !c.busy.load( std::memory_order_relaxed ) &&
+                 !c.busy.exchange( true, std::memory_order_acquire ) )
+            {
+                return c;
+            }
+        }
+    }
+
+    id_allocator::cache& id_allocator::getCache( uint32_t slot )
+    {
+        std::atomic<cache*>& c{ m_Caches[ slot ] };
+        cache* existing{ c.load( std::memory_order_acquire ) };
+        if ( existing )
+        {
+            return *existing;
+        }
+
+        // Caches are made when a thread first uses the slot, so a world
+        // that is only used by a few threads only has a few of them.
+        // Another thread may be making the same one, the one that loses
+        // the race throws its cache away
+        cache* newCache{ new cache };
+        if ( !c.compare_exchange_strong( existing, newCache,
+                                         std::memory_order_acq_rel ) )
+        {
+            delete newCache;
+            return *existing;
+        }
+        return *newCache;
+    }
+
+    void id_allocator::unlockCache( cache& c )
+    {
+        c.busy.store( false, std::memory_order_release );
+    }
+
+    void id_allocator::refill( cache& c )
+    {
+        assert( !c.allocCount );
+
+        // Only reuse ids when enough of them are queued, so that each
+        // index is reused as seldom as possible. This keeps the
+        // generations from wrapping around
+        batch* b{ m_QueuedIds.load( std::memory_order_relaxed ) > min_deleted_elements ?
+                  popFull() : nullptr };
+        if ( b )
+        {
+            m_QueuedIds.fetch_sub( b->count, std::memory_order_relaxed );
+            // Ids are taken from the back of the cache, so store them
+            // reversed to hand them out in the order they were freed
+            for ( uint32_t i{ 0 }; i < b->count; i++ )
+            {
+                c.allocIds[ i ] = b->ids[ b->count - 1 - i ];
+            }
+            c.allocCount = b->count;
+            b->count = 0;
+            if ( !m_EmptyBatches.push( b ) )
+            {
+                delete b;
+            }
+            return;
+        }
+
+        // Reserve a block of fresh indices
+        const id_type first{ m_NextIndex.fetch_add( batch_size,
+                                                    std::memory_order_acq_rel ) };
+        if ( first >= max_indices )
+        {
+            // NOTE(klek): Handing out an index twice would silently
+            //             corrupt the world, so stop here instead
+            fprintf( stderr, "id_allocator: out of entity indices, "
+                             "consider the 64-bit id layout\n" );
+            std::abort();
+        }
+        const uint32_t count{ (uint32_t)std::min<uint64_t>( batch_size,
+                                                            max_indices - first ) };
+        // The block only spans two pages when the index count was
+        // restored to a value that isn't a multiple of the batch size
+        makePage( first );
+        makePage( first + count - 1 );
+        for ( uint32_t i{ 0 }; i < count; i++ )
+        {
+            c.allocIds[ i ] = first + count - 1 - i;
+        }
+        c.allocCount = count;
+    }
+
+    void id_allocator::flush( cache& c )
+    {
+        assert( c.freeCount );
+        batch* b{ getBatch() };
+        memcpy( b->ids, c.freeIds, c.freeCount * sizeof( id_type ) );
+        b->count = c.freeCount;
+        m_QueuedIds.fetch_add( c.freeCount, std::memory_order_relaxed );
+        c.freeCount = 0;
+        pushFull( b );
+    }
+
+    id_allocator::batch* id_allocator::getBatch()
+    {
+        batch* b;
+        if ( m_EmptyBatches.pop( b ) )
+        {
+            return b;
+        }
+        return new batch{};
+    }
+
+    void id_allocator::pushFull( batch* b )
+    {
+        // Once batches have spilled over, the newer ones go after them
+        // to keep the order
+        if ( !m_OverflowCount.load( std::memory_order_acquire ) &&
+             m_FullBatches.push( b ) )
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock{ m_OverflowMutex };
+        m_Overflow.push_back( b );
+        m_OverflowCount.store( (uint32_t)m_Overflow.size() - m_OverflowHead,
+                               std::memory_order_release );
+    }
+
+    id_allocator::batch* id_allocator::popFull()
+    {
+        batch* b;
+        if ( m_FullBatches.pop( b ) )
+        {
+            return b;
+        }
+        if ( !m_OverflowCount.load( std::memory_order_acquire ) )
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock{ m_OverflowMutex };
+        const uint32_t size{ (uint32_t)m_Overflow.size() };
+        if ( m_OverflowHead == size )
+        {
+            return nullptr;
+        }
+        b = m_Overflow[ m_OverflowHead++ ];
+        // Move the oldest spilled batches to the queue, so the next
+        // refills don't have to lock
+        while ( m_OverflowHead < size && 
+                m_FullBatches.push( m_Overflow[ m_OverflowHead ] ) )
+        {
+            m_OverflowHead++;
+        }
+        // Drop the batches that were taken from the front
+        if ( m_OverflowHead == size || m_OverflowHead >= size / 2 )
+        {
+            std::copy( m_Overflow.begin() + m_OverflowHead, m_Overflow.end(),
+                       m_Overflow.begin() );
+            m_Overflow.resize( size - m_OverflowHead );
+            m_OverflowHead = 0;
+        }
+        m_OverflowCount.store( (uint32_t)m_Overflow.size() - m_OverflowHead,
+                               std::memory_order_release );
+        return b;
+    }
+
+    id_allocator::id_page* id_allocator::getPage( id_type index ) const
+    {
+        assert( index / page_size < m_PageCount );
+        return m_Pages[ index / page_size ].load( std::memory_order_acquire );
+    }
+
+    id_allocator::id_page* id_allocator::makePage( id_type index )
+    {
+        std::atomic<id_page*>& slot{ m_Pages[ index / page_size ] };
+        id_page* page{ slot.load( std::memory_order_acquire ) };
+        if ( page )
+        {
+            return page;
+        }
+
+        // Another thread may be making the same page, the one that
+        // loses the race throws its page away
+        id_page* newPage{ new id_page };
+        for ( uint32_t i{ 0 }; i < page_size; i++ )
+        {
+            newPage->generations[ i ].store( 0, std::memory_order_relaxed );
+        }
+        for ( uint32_t i{ 0 }; i < page_size / 64; i++ )
+        {
+            newPage->stored[ i ].store( 0, std::memory_order_relaxed );
+        }
+        if ( !slot.compare_exchange_strong( page, newPage,
+                                            std::memory_order_acq_rel ) )
+        {
+            delete newPage;
+            return page;
+        }
+        return newPage;
+    }
+} // namespace muggy::id
@@ -0,0 +1,167 @@
+//********************************************************************
+//  File:    idAllocator.h
+//  Date:    Sat, 17 Oct 2026: 18:55
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(ID_ALLOCATOR_H)
+#define ID_ALLOCATOR_H
+
+#include "componentsCommon.h"
+#include "../utilities/mpmcQueue.h"
+#include <atomic>
+#include <mutex>
+
+namespace muggy::id
+{
+    // Hands out and recycles ids from any number of threads, without
+    // taking a lock unless a lot of ids are freed at once.
+    // Freed ids are collected in batches, and full batches are queued
+    // in a global FIFO. Threads refill from that queue one batch at a
+    // time, or reserve a block of fresh indices when the queue holds
+    // less than min_deleted_elements ids. Each thread works on its own
+    // cache slot, so the shared state is only touched once per batch.
+    // The FIFO is a small lock-free queue. Batches that don't fit in it
+    // spill over into a list behind a mutex, so memory grows with the
+    // number of freed ids instead of being reserved for all of them.
+    // Generations live in fixed size pages that are never moved, which
+    // allows them to be read while other threads allocate. The pages
+    // also tell which ids belong to entities in the storage
+    class id_allocator
+    {
+    public:
+        // Number of ids moved between a cache and the global queue
+        static constexpr uint32_t batch_size{ 256 };
+        // Number of generations per page
+        static constexpr uint32_t page_size{ 64 * 1024 };
+        // Number of cache slots. Threads that find their slot busy move
+        // on to the next one
+        static constexpr uint32_t cache_count{ 64 };
+        // Number of full batches the lock-free queue holds before they
+        // spill over
+        static constexpr uint32_t queue_capacity{ 1024 };
+        // Number of empty batches kept around for reuse
+        static constexpr uint32_t spare_batch_count{ 64 };
+
+        id_allocator();
+        ~id_allocator();
+
+        id_allocator( const id_allocator& ) = delete;
+        id_allocator& operator=( const id_allocator& ) = delete;
+
+        // Returns an id that is not in use. Recycled ids already carry
+        // their new generation
+        [[nodiscard]] id_type allocate();
+        // Same as allocate() for every item in "ids"
+        void allocate( utils::span<id_type> ids );
+        // Bumps the generation of the id, which makes every copy of it
+        // stale. Returns false if the id was already stale, ie someone
+        // else retired it first. The index isn't handed out again until
+        // it is given to recycle()
+        bool retire( id_type id );
+        // Returns the index of an id that was retired by this thread for
+        // reuse. Takes the id as it was before retire()
+        // NOTE(klek): Other threads may get the index right away, so the
+        //             old entity must be out of the storage by now
+        void recycle( id_type id );
+        // Same as recycle() for every id in "ids"
+        void recycle( utils::span<const id_type> ids );
+        // Retires the id and recycles it at once. Only for ids that were
+        // never stored, such as reserved ones
+        bool release( id_type id );
+
+        // Returns true if the generation of the id is the current one
+        // for its index
+        [[nodiscard]] bool isCurrent( id_type id ) const;
+        [[nodiscard]] generation_type getGeneration( id_type index ) const;
+
+        // Marks whether the entity of the index is in the component
+        // storage. Ids that are handed out but not stored yet, such as
+        // reserved ones, are current without being stored
+        void setStored( id_type index, bool stored );
+        // Returns true if the id is current and its entity is stored.
+        // Like isCurrent() this is safe while other threads allocate
+        [[nodiscard]] bool isStored( id_type id ) const;
+        // Same as isStored() for up to 64 ids, where bit i of the result
+        // is set if ids[ i ] is stored. Invalid ids are not stored
+        [[nodiscard]] uint64_t areStored( const id_type* ids, uint32_t count ) const;
+        // Writes the current id of index first + i to ids[ n ] for each
+        // bit i set in "bits", where n counts the set bits. "first" must
+        // be a multiple of 64 and all indices must have been handed out
+        void getCurrentIds( id_type first, uint64_t bits, id_type* ids ) const;
+
+        // Replaces the whole state, ie the generation of every index and
+        // the ids that are free for reuse. Every index below the size of
+        // "generations" that isn't in "freeIds" is considered in use.
+        // NOTE(klek): Used when loading snapshots, this must not run
+        //             while other threads use the allocator
+        void restore( utils::span<const generation_type> generations,
+                      utils::span<const id_type> freeIds );
+
+        // Number of indices handed out so far, including the fresh
+        // ones that sit unused in the caches. All indices are below this
+        [[nodiscard]] id_type getIndexCount() const
+        {
+            return m_NextIndex.load( std::memory_order_acquire );
+        }
+
+    private:
+        struct id_page
+        {
+            std::atomic<generation_type>    generations[ page_size ];
+            // One bit per index, see setStored()
+            std::atomic<uint64_t>           stored[ page_size / 64 ];
+        };
+
+        struct batch
+        {
+            uint32_t    count{ 0 };
+            id_type     ids[ batch_size ];
+        };
+
+        struct alignas( 64 ) cache
+        {
+            std::atomic<bool>   busy{ false };
+            // Ids ready to be handed out, taken from the back
+            uint32_t            allocCount{ 0 };
+            id_type             allocIds[ batch_size ];
+            // Freed ids waiting for the batch to fill up
+            uint32_t            freeCount{ 0 };
+            id_type             freeIds[ batch_size ];
+        };
+
+        cache& lockCache();
+        cache& getCache( uint32_t slot );
+        void unlockCache( cache& c );
+        void refill( cache& c );
+        void flush( cache& c );
+        batch* getBatch();
+        void pushFull( batch* b );
+        batch* popFull();
+        id_page* getPage( id_type index ) const;
+        id_page* makePage( id_type index );
+
+        // Pages of generations, indexed by index / page_size
+        std::atomic<id_page*>*          m_Pages{ nullptr };
+        uint32_t                        m_PageCount{ 0 };
+        utils::mpmc_queue<batch*>       m_FullBatches;
+        // Batches that didn't fit in m_FullBatches, oldest first from
+        // m_OverflowHead
+        std::mutex                      m_OverflowMutex;
+        utils::vector<batch*>           m_Overflow;
+        uint32_t                        m_OverflowHead{ 0 };
+        std::atomic<uint32_t>           m_OverflowCount{ 0 };
+        // Batches are recycled through m_EmptyBatches
+        utils::mpmc_queue<batch*>       m_EmptyBatches;
+        // Number of ids in the full batches queue
+        std::atomic<uint64_t>           m_QueuedIds{ 0 };
+        std::atomic<id_type>            m_NextIndex{ 0 };
+        // Made on first use, see getCache()
+        std::atomic<cache*>             m_Caches[ cache_count ];
+    };
+} // namespace muggy::id
+
+
+#endif
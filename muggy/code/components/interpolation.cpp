@@ -0,0 +1,145 @@
+//********************************************************************
+//  File:    interpolation.cpp
+//  Date:    Mon, 19 Oct 2026: 10:30
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "transform.h"
+#include "world.h"
+#include "../math/interpolateBatch.h"
+#include <algorithm>
+#include <atomic>
+
+namespace muggy::ecs::detail
+{
+    // NOTE(klek): A triple buffer. The simulation fills "back" and
+    //             swaps it with "shared", the render thread swaps
+    //             "front" with "shared" when a newer frame is there.
+    //             Neither side ever waits for the other
+    struct interpolation_state
+    {
+        static constexpr uint32_t   index_mask{ 0x3 };
+        // Set in "shared" when it holds a frame the reader hasn't seen
+        static constexpr uint32_t   fresh_bit{ 0x4 };
+
+        transform::interpolation_frame  frames[ 3 ];
+        std::atomic<uint32_t>           shared{ 1 };
+        // Only used by the simulation thread
+        uint32_t                        back{ 0 };
+        uint32_t                        published{ uint32_invalid_id };
+        // Row of every entity in the published frame, indexed by
+        // entity index. Stale entries are caught by comparing the ids
+        utils::vector<uint32_t>         rows;
+        // Only used by the render thread
+        uint32_t                        front{ 2 };
+    };
+
+    interpolation_state* createInterpolationState()
+    {
+        return new interpolation_state{};
+    }
+
+    void destroyState( interpolation_state* state )
+    {
+        delete state;
+    }
+} // namespace muggy::ecs::detail
+
+namespace muggy::transform
+{
+    void captureTransforms()
+    {
+        ecs::detail::interpolation_state& state{ ecs::getCurrentWorld().getInterpolationState() };
+        // NOTE(klek): The published frame may be read by the render
+        //             thread at the same time, but neither side writes
+        //             it until it has gone through "shared" again
+        const interpolation_frame* previous{ state.published != uint32_invalid_id ?
+                                             &state.frames[ state.published ] : nullptr };
+        interpolation_frame& frame{ state.frames[ state.back ] };
+
+        const uint32_t count{ getTransformCount() };
+        frame.ids.resize( count );
+        frame.previousPositions.resize( count );
+        frame.previousRotations.resize( count );
+        frame.previousScales.resize( count );
+        frame.positions.resize( count );
+        frame.rotations.resize( count );
+        frame.scales.resize( count );
+
+        uint32_t row{ 0 };
+        forEachTransform( [&frame, &row]( const id::id_type* ids, const math::fv3d* positions,
+                                          const math::fv4d* rotations, const math::fv3d* scales,
+                                          uint32_t chunkCount )
+            {
+                std::copy_n( ids, chunkCount, frame.ids.data() + row );
+                std::copy_n( positions, chunkCount, frame.positions.data() + row );
+                std::copy_n( rotations, chunkCount, frame.rotations.data() + row );
+                std::copy_n( scales, chunkCount, frame.scales.data() + row );
+                row += chunkCount;
+            } );
+        assert( row == count );
+
+        // Match every row with the same entity in the previous capture.
+        // Rows move between ticks, so this can't be done by row
+        const uint32_t previousCount{ previous ? (uint32_t)previous->ids.size() : 0 };
+        for ( uint32_t i{ 0 }; i < count; i++ )
+        {
+            const id::id_type id{ frame.ids[ i ] };
+            const id::id_type index{ id::index( id ) };
+            const uint32_t r{ index < state.rows.size() ? state.rows[ index ] : uint32_invalid_id };
+            const bool existed{ r < previousCount && previous->ids[ r ] == id };
+            frame.previousPositions[ i ] = existed ? previous->positions[ r ] : frame.positions[ i ];
+            frame.previousRotations[ i ] = existed ? previous->rotations[ r ] : frame.rotations[ i ];
+            frame.previousScales[ i ] = existed ? previous->scales[ r ] : frame.scales[ i ];
+        }
+
+        // Remember the rows of this capture for the next one
+        for ( uint32_t i{ 0 }; i < count; i++ )
+        {
+            const id::id_type index{ id::index( frame.ids[ i ] ) };
+            if ( index >= state.rows.size() )
+            {
+                state.rows.resize( index + 1, uint32_invalid_id );
+            }
+            state.rows[ index ] = i;
+        }
+
+        frame.tick = previous ? previous->tick + 1 : 1;
+        state.published = state.back;
+        state.back = state.shared.exchange( state.back | ecs::detail::interpolation_state::fresh_bit,
+                                            std::memory_order_acq_rel ) &
+                     ecs::detail::interpolation_state::index_mask;
+    }
+
+    const interpolation_frame* acquireInterpolationFrame()
+    {
+        ecs::detail::interpolation_state& state{ ecs::getCurrentWorld().getInterpolationState() };
+        if ( state.shared.load( std::memory_order_relaxed ) & 
+             ecs::detail::interpolation_state::fresh_bit )
+        {
+            state.front = state.shared.exchange( state.front, std::memory_order_acq_rel ) &
+                          ecs::detail::interpolation_state::index_mask;
+        }
+        const interpolation_frame& frame{ state.frames[ state.front ] };
+        return frame.tick ? &frame : nullptr;
+    }
+
+    void interpolateTransforms( const interpolation_frame& frame, float t,
+                                uint32_t first,
+                                utils::span<math::fv3d> positions,
+                                utils::span<math::fv4d> rotations,
+                                utils::span<math::fv3d> scales )
+    {
+        const uint32_t size{ (uint32_t)positions.size() };
+        assert( rotations.size() == size && scales.size() == size );
+        assert( first + size <= frame.ids.size() );
+        math::lerpVectors( frame.previousPositions.data() + first, 
+                           frame.positions.data() + first, t, positions.data(), size );
+        math::nlerpQuaternions( frame.previousRotations.data() + first, 
+                                frame.rotations.data() + first, t, rotations.data(), size );
+        math::lerpVectors( frame.previousScales.data() + first, 
+                           frame.scales.data() + first, t, scales.data(), size );
+    }
+} // namespace muggy::transform
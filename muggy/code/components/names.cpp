@@ -0,0 +1,310 @@
+//********************************************************************
+//  File:    names.cpp
+//  Date:    Mon, 19 Oct 2026: 17:40
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "names.h"
+#include "entity.h"
+#include "world.h"
+
+namespace muggy::ecs::detail
+{
+    // NOTE(klek): The names are interned in one arena, each behind a
+    //             header with its hash so the table can be rebuilt and
+    //             entries removed without hashing again. The table is
+    //             open addressing with linear probing, and removal
+    //             shifts the following entries back so there are no
+    //             tombstones to skip
+    struct name_state
+    {
+        struct header
+        {
+            uint64_t    hash;
+            id::id_type id;
+            uint32_t    length;
+        };
+
+        struct slot
+        {
+            uint64_t    hash;
+            id::id_type id;
+            // Offset of the header in the arena
+            uint32_t    offset;
+        };
+
+        // Headers are 8-byte aligned, followed by the characters
+        utils::vector<uint8_t>      arena;
+        // Bytes of the arena taken by names that were removed
+        uint32_t                    deadBytes{ 0 };
+        // Power of two size, empty slots have an invalid id
+        utils::vector<slot>         slots;
+        uint32_t                    count{ 0 };
+        // Arena offset of the name of every entity, indexed by entity
+        // index
+        utils::vector<uint32_t>     offsets;
+    };
+
+    name_state* createNameState()
+    {
+        return new name_state{};
+    }
+
+    void destroyState( name_state* state )
+    {
+        delete state;
+    }
+} // namespace muggy::ecs::detail
+
+namespace muggy::game_entity
+{
+    namespace
+    {
+        using name_state = ecs::detail::name_state;
+
+        constexpr uint32_t min_slot_count{ 64 };
+
+        name_state& getNames()
+        {
+            return ecs::getCurrentWorld().getNameState();
+        }
+
+        const name_state::header& getHeader( const name_state& names, uint32_t offset )
+        {
+            return *(const name_state::header*)( names.arena.data() + offset );
+        }
+
+        std::string_view getText( const name_state& names, uint32_t offset )
+        {
+            const char *const text{ (const char*)( names.arena.data() + offset + 
+                                                   sizeof( name_state::header ) ) };
+            return std::string_view{ text, getHeader( names, offset ).length };
+        }
+
+        // NOTE(klek): vector::resize() only reserves what is asked for,
+        //             so grow by doubling to keep appends amortized O(1)
+        template <typename T>
+        void growTo( utils::vector<T>& v, uint64_t size )
+        {
+            if ( size > v.capacity() )
+            {
+                v.reserve( std::max( size, v.capacity() * 2 ) );
+            }
+        }
+
+        constexpr uint32_t entrySize( uint32_t length )
+        {
+            // Keep the next header aligned
+            return ( sizeof( name_state::header ) + length + 7 ) & ~7u;
+        }
+
+        // Returns the slot that holds the name, or the empty slot where
+        // it would be inserted
+        uint32_t findSlot( const name_state& names, const entity_name& name )
+        {
+            const uint32_t mask{ (uint32_t)names.slots.size() - 1 };
+            uint32_t i{ (uint32_t)name.hash & mask };
+            while ( id::isValid( names.slots[ i ].id ) )
+            {
+                const name_state::slot& s{ names.slots[ i ] };
+                if ( s.hash == name.hash && getText( names, s.offset ) == name.text )
+                {
+                    break;
+                }
+                i = ( i + 1 ) & mask;
+            }
+            return i;
+        }
+
+        void insertSlot( name_state& names, const name_state::slot& s )
+        {
+            const uint32_t mask{ (uint32_t)names.slots.size() - 1 };
+            uint32_t i{ (uint32_t)s.hash & mask };
+            while ( id::isValid( names.slots[ i ].id ) )
+            {
+                i = ( i + 1 ) & mask;
+            }
+            names.slots[ i ] = s;
+        }
+
+        void eraseSlot( name_state& names, uint32_t i )
+        {
+            // Move back entries of the same probe run that would no
+            // longer be found after the hole
+            const uint32_t mask{ (uint32_t)names.slots.size() - 1 };
+            uint32_t hole{ i };
+            uint32_t j{ i };
+            for ( ;; )
+            {
+                j = ( j + 1 ) & mask;
+                const name_state::slot& s{ names.slots[ j ] };
+                if ( !id::isValid( s.id ) )
+                {
+                    break;
+                }
+                const uint32_t home{ (uint32_t)s.hash & mask };
+                // The entry can move into the hole if its home slot is
+                // not in the cyclic range ( hole, j ]
+                if ( ( ( j - home ) & mask ) >= ( ( j - hole ) & mask ) )
+                {
+                    names.slots[ hole ] = s;
+                    hole = j;
+                }
+            }
+            names.slots[ hole ] = { 0, id::invalid_id, 0 };
+        }
+
+        void rebuildSlots( name_state& names, uint32_t slotCount )
+        {
+            names.slots.clear();
+            names.slots.resize( slotCount, name_state::slot{ 0, id::invalid_id, 0 } );
+            for ( uint32_t i{ 0 }; i < names.offsets.size(); i++ )
+            {
+                const uint32_t offset{ names.offsets[ i ] };
+                if ( offset != uint32_invalid_id )
+                {
+                    const name_state::header& h{ getHeader( names, offset ) };
+                    insertSlot( names, { h.hash, h.id, offset } );
+                }
+            }
+        }
+
+        // Drops removed names from the arena once they take up more
+        // than half of it
+        void compactArena( name_state& names )
+        {
+            if ( names.deadBytes < 4096 || names.deadBytes * 2 < names.arena.size() )
+            {
+                return;
+            }
+
+            utils::vector<uint8_t> arena;
+            arena.reserve( names.arena.size() - names.deadBytes );
+            for ( uint32_t i{ 0 }; i < names.offsets.size(); i++ )
+            {
+                const uint32_t offset{ names.offsets[ i ] };
+                if ( offset != uint32_invalid_id )
+                {
+                    const uint32_t size{ entrySize( getHeader( names, offset ).length ) };
+                    const uint32_t newOffset{ (uint32_t)arena.size() };
+                    arena.resize( newOffset + size );
+                    memcpy( arena.data() + newOffset, names.arena.data() + offset, size );
+                    names.offsets[ i ] = newOffset;
+                }
+            }
+            names.arena = std::move( arena );
+            names.deadBytes = 0;
+            rebuildSlots( names, (uint32_t)names.slots.size() );
+        }
+
+        void eraseName( name_state& names, id::id_type id )
+        {
+            const id::id_type index{ id::index( id ) };
+            const uint32_t offset{ names.offsets[ index ] };
+            const name_state::header& h{ getHeader( names, offset ) };
+            // The stored hash leads to the slot without comparing text
+            const uint32_t mask{ (uint32_t)names.slots.size() - 1 };
+            uint32_t slot{ (uint32_t)h.hash & mask };
+            while ( names.slots[ slot ].id != id )
+            {
+                assert( id::isValid( names.slots[ slot ].id ) );
+                slot = ( slot + 1 ) & mask;
+            }
+            eraseSlot( names, slot );
+            names.offsets[ index ] = uint32_invalid_id;
+            names.deadBytes += entrySize( h.length );
+            names.count--;
+        }
+    } // namespace anonymous
+
+    bool setName( entity e, entity_name name )
+    {
+        assert( isAlive( e ) && !name.text.empty() );
+        std::lock_guard<std::mutex> lock{ detail::getStorageMutex() };
+        name_state& names{ getNames() };
+        const id::id_type id{ e.getId() };
+        const id::id_type index{ id::index( id ) };
+
+        // Keep the load factor at or below one half
+        if ( ( names.count + 1 ) * 2 > names.slots.size() )
+        {
+            rebuildSlots( names, std::max( min_slot_count, (uint32_t)names.slots.size() * 2 ) );
+        }
+
+        const uint32_t slot{ findSlot( names, name ) };
+        if ( id::isValid( names.slots[ slot ].id ) )
+        {
+            return names.slots[ slot ].id == id;
+        }
+
+        if ( index < names.offsets.size() && names.offsets[ index ] != uint32_invalid_id )
+        {
+            eraseName( names, id );
+        }
+        else if ( index >= names.offsets.size() )
+        {
+            growTo( names.offsets, index + 1 );
+            names.offsets.resize( index + 1, uint32_invalid_id );
+        }
+
+        const uint32_t offset{ (uint32_t)names.arena.size() };
+        const uint32_t length{ (uint32_t)name.text.size() };
+        growTo( names.arena, offset + entrySize( length ) );
+        names.arena.resize( offset + entrySize( length ) );
+        const name_state::header h{ name.hash, id, length };
+        memcpy( names.arena.data() + offset, &h, sizeof( h ) );
+        memcpy( names.arena.data() + offset + sizeof( h ), name.text.data(), length );
+        names.offsets[ index ] = offset;
+        names.count++;
+        // The erase above may have moved entries, so probe again
+        insertSlot( names, { name.hash, id, offset } );
+        compactArena( names );
+        return true;
+    }
+
+    void clearName( entity e )
+    {
+        assert( isAlive( e ) );
+        std::lock_guard<std::mutex> lock{ detail::getStorageMutex() };
+        detail::removeName( e.getId() );
+    }
+
+    std::string_view getName( entity e )
+    {
+        assert( isAlive( e ) );
+        const name_state& names{ getNames() };
+        const id::id_type index{ id::index( e.getId() ) };
+        if ( index >= names.offsets.size() || names.offsets[ index ] == uint32_invalid_id )
+        {
+            return {};
+        }
+        return getText( names, names.offsets[ index ] );
+    }
+
+    entity findEntity( entity_name name )
+    {
+        const name_state& names{ getNames() };
+        if ( !names.count )
+        {
+            return {};
+        }
+        const name_state::slot& s{ names.slots[ findSlot( names, name ) ] };
+        return id::isValid( s.id ) ? entity{ entity_id{ s.id } } : entity{};
+    }
+
+    namespace detail
+    {
+        void removeName( id::id_type id )
+        {
+            name_state& names{ getNames() };
+            const id::id_type index{ id::index( id ) };
+            if ( index < names.offsets.size() && names.offsets[ index ] != uint32_invalid_id )
+            {
+                eraseName( names, id );
+                compactArena( names );
+            }
+        }
+    } // namespace detail
+} // namespace muggy::game_entity
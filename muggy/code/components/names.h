@@ -0,0 +1,82 @@
+//********************************************************************
+//  File:    names.h
+//  Date:    Mon, 19 Oct 2026: 17:25
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(NAMES_H)
+#define NAMES_H
+
+#include "componentsCommon.h"
+#include "../utilities/hash.h"
+#include <string>
+
+namespace muggy::game_entity
+{
+    // A name together with its hash. Names constructed in a constant
+    // expression, such as a constexpr variable, are hashed at compile
+    // time, so looking them up costs no hashing at runtime, eg
+    //      constexpr entity_name spawn{ "player_spawn_03" };
+    //      findEntity( spawn );
+    // NOTE(klek): The literal operator works the same way, but when it
+    //             is passed straight to a call, eg
+    //             findEntity( "player_spawn_03"_name ), the compiler is
+    //             free to hash at runtime. Use a constexpr variable
+    //             where that matters
+    struct entity_name
+    {
+        constexpr entity_name( std::string_view name )
+         :
+            hash( utils::hashString( name ) ),
+            text( name )
+        {}
+
+        constexpr entity_name( const char* name )
+         :
+            entity_name( std::string_view{ name } )
+        {}
+
+        entity_name( const std::string& name )
+         :
+            entity_name( std::string_view{ name } )
+        {}
+
+        uint64_t            hash;
+        std::string_view    text;
+    };
+
+    namespace literals
+    {
+        constexpr entity_name operator""_name( const char* name, size_t length )
+        {
+            return entity_name{ std::string_view{ name, length } };
+        }
+    } // namespace literals
+
+    // Names are optional and unique within the world. Returns false if
+    // another entity already has the name, otherwise the entity gets
+    // the name in place of its current one. Removed entities lose
+    // their names.
+    // Names are kept by saveSnapshot() and loadSnapshot(). Prefabs have
+    // no names, since every instance would need the same one, so
+    // instances start without a name and are named with setName()
+    bool setName( entity e, entity_name name );
+    void clearName( entity e );
+    // Returns an empty view if the entity has no name. The view stays
+    // valid until the next name is set or cleared
+    std::string_view getName( entity e );
+    // Returns the entity with the name, or an invalid entity
+    entity findEntity( entity_name name );
+
+    namespace detail
+    {
+        // Called by removeGameEntity() and removeGameEntities() with the
+        // storage mutex held
+        void removeName( id::id_type id );
+    } // namespace detail
+} // namespace muggy::game_entity
+
+
+#endif
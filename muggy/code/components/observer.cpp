@@ -0,0 +1,222 @@
+//********************************************************************
+//  File:    observer.cpp
+//  Date:    Mon, 19 Oct 2026: 14:20
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "observer.h"
+#include "world.h"
+
+namespace muggy::ecs::detail
+{
+    struct event_queue
+    {
+        utils::vector<id::id_type>  created;
+        utils::vector<id::id_type>  removed;
+        // Indexed by component type
+        utils::vector<id::id_type>  added[ max_component_types ];
+        component_mask              addedTypes{ 0 };
+    };
+
+    struct observer
+    {
+        observer_func   func;
+        void*           context;
+        entity_event    event;
+        component_type  type;
+    };
+
+    struct observer_state
+    {
+        // Unregistered observers leave a nullptr func behind
+        utils::vector<observer>     observers;
+        // Events are queued in one while the other is delivered
+        event_queue                 queues[ 2 ];
+        uint32_t                    pending{ 0 };
+
+        // What there are observers for, so the storage doesn't queue
+        // anything nobody listens to
+        uint32_t                    createdCount{ 0 };
+        uint32_t                    removedCount{ 0 };
+        component_mask              observedTypes{ 0 };
+    };
+
+    observer_state* createObserverState()
+    {
+        return new observer_state{};
+    }
+
+    void destroyState( observer_state* state )
+    {
+        delete state;
+    }
+} // namespace muggy::ecs::detail
+
+namespace muggy::ecs
+{
+    namespace
+    {
+        detail::observer_state& getObservers()
+        {
+            return getCurrentWorld().getObserverState();
+        }
+
+        void updateInterest( detail::observer_state& state )
+        {
+            state.createdCount = 0;
+            state.removedCount = 0;
+            state.observedTypes = 0;
+            for ( const detail::observer& o : state.observers )
+            {
+                if ( !o.func )
+                {
+                    continue;
+                }
+                state.createdCount += o.event == entity_event::created;
+                state.removedCount += o.event == entity_event::removed;
+                if ( o.event == entity_event::component_added )
+                {
+                    state.observedTypes |= component_mask{ 1 } << o.type;
+                }
+            }
+        }
+
+        void notify( const detail::observer_state& state, entity_event event,
+                     component_type type, const utils::vector<id::id_type>& ids )
+        {
+            if ( ids.empty() )
+            {
+                return;
+            }
+
+            const utils::span<const id::id_type> batch{ ids.data(), ids.size() };
+            // NOTE(klek): Observers may add other observers, which can
+            //             move the array, so it's indexed every time
+            for ( uint32_t i{ 0 }; i < state.observers.size(); i++ )
+            {
+                const detail::observer o{ state.observers[ i ] };
+                if ( o.func && o.event == event && 
+                     ( event != entity_event::component_added || o.type == type ) )
+                {
+                    o.func( batch, o.context );
+                }
+            }
+        }
+    } // namespace anonymous
+
+    observer_id addObserver( entity_event event, observer_func func, 
+                             void* context, component_type type )
+    {
+        assert( func && event < entity_event::count );
+        assert( type < max_component_types );
+        detail::observer_state& state{ getObservers() };
+        state.observers.push_back( { func, context, event, type } );
+        updateInterest( state );
+        return observer_id{ (id::id_type)state.observers.size() - 1 };
+    }
+
+    void removeObserver( observer_id id )
+    {
+        detail::observer_state& state{ getObservers() };
+        assert( id::isValid( id ) && id < state.observers.size() && 
+                state.observers[ id ].func );
+        state.observers[ id ].func = nullptr;
+        updateInterest( state );
+
+        // Drop what nobody listens to anymore, so the queue doesn't grow
+        // while nothing delivers it. The other queue is either empty or
+        // being delivered, and is cleared when that is done
+        detail::event_queue& queue{ state.queues[ state.pending ] };
+        if ( !state.createdCount )
+        {
+            queue.created.clear();
+        }
+        if ( !state.removedCount )
+        {
+            queue.removed.clear();
+        }
+        component_mask types{ queue.addedTypes & ~state.observedTypes };
+        queue.addedTypes &= state.observedTypes;
+        while ( types )
+        {
+            queue.added[ utils::countTrailingZeros( types ) ].clear();
+            types &= types - 1;
+        }
+    }
+
+    void deliverEvents()
+    {
+        detail::observer_state& state{ getObservers() };
+        detail::event_queue& queue{ state.queues[ state.pending ] };
+        // Anything the observers cause goes to the other queue
+        state.pending ^= 1;
+
+        notify( state, entity_event::created, 0, queue.created );
+        component_mask types{ queue.addedTypes };
+        while ( types )
+        {
+            const component_type type{ (component_type)utils::countTrailingZeros( types ) };
+            notify( state, entity_event::component_added, type, queue.added[ type ] );
+            queue.added[ type ].clear();
+            types &= types - 1;
+        }
+        notify( state, entity_event::removed, 0, queue.removed );
+
+        queue.created.clear();
+        queue.removed.clear();
+        queue.addedTypes = 0;
+    }
+
+    namespace detail
+    {
+        void queueCreated( utils::span<const id::id_type> ids, component_mask mask )
+        {
+            observer_state& state{ getObservers() };
+            event_queue& queue{ state.queues[ state.pending ] };
+            if ( state.createdCount )
+            {
+                for ( const id::id_type id : ids )
+                {
+                    queue.created.push_back( id );
+                }
+            }
+
+            component_mask types{ mask & state.observedTypes };
+            queue.addedTypes |= types;
+            while ( types )
+            {
+                utils::vector<id::id_type>& added{ 
+                    queue.added[ utils::countTrailingZeros( types ) ] };
+                for ( const id::id_type id : ids )
+                {
+                    added.push_back( id );
+                }
+                types &= types - 1;
+            }
+        }
+
+        void queueRemoved( id::id_type id )
+        {
+            observer_state& state{ getObservers() };
+            if ( state.removedCount )
+            {
+                state.queues[ state.pending ].removed.push_back( id );
+            }
+        }
+
+        void queueComponentsAdded( id::id_type id, component_mask added )
+        {
+            observer_state& state{ getObservers() };
+            event_queue& queue{ state.queues[ state.pending ] };
+            component_mask types{ added & state.observedTypes };
+            queue.addedTypes |= types;
+            while ( types )
+            {
+                queue.added[ utils::countTrailingZeros( types ) ].push_back( id );
+                types &= types - 1;
+            }
+        }
+    } // namespace detail
+} // namespace muggy::ecs
@@ -0,0 +1,70 @@
+//********************************************************************
+//  File:    observer.h
+//  Date:    Mon, 19 Oct 2026: 14:05
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(OBSERVER_H)
+#define OBSERVER_H
+
+#include "componentsCommon.h"
+#include "archetype.h"
+
+namespace muggy::ecs
+{
+    DEFINE_TYPED_ID(observer_id);
+
+    enum class entity_event : uint32_t
+    {
+        created = 0,
+        removed,
+        // An entity gained a component, either when it was created or
+        // later on. Observers of this event watch a single type
+        component_added,
+
+        count
+    };
+
+    // Receives every entity the event happened to since the last 
+    // delivery, in the order it happened. The same id can be in the
+    // batch more than once, eg when a component is removed and added
+    // again, and ids in the created batch may already be removed
+    using observer_func = void(*)( utils::span<const id::id_type> ids, void* context );
+
+    // Observers belong to the current world. Nothing is queued for an
+    // event until there is an observer for it, and what is queued is
+    // dropped when the last one is removed. While there are observers,
+    // events are kept until deliverEvents(), so it has to be called
+    // regularly, eg once a frame
+    observer_id addObserver( entity_event event, observer_func func, 
+                             void* context = nullptr, component_type type = 0 );
+    void removeObserver( observer_id id );
+
+    template <typename T>
+    observer_id addComponentObserver( observer_func func, void* context = nullptr )
+    {
+        return addObserver( entity_event::component_added, func, context, 
+                            componentType<T>() );
+    }
+
+    // Delivers the events queued in the current world, one call per
+    // observer with the whole batch: created first, then the added
+    // components by type and removed last. Meant to run at a sync
+    // point where nothing else uses the storage. Events caused by the
+    // observers themselves are delivered by the next call
+    void deliverEvents();
+
+    namespace detail
+    {
+        // Called by the storage when entities are added, removed or
+        // moved to an archetype with more components
+        void queueCreated( utils::span<const id::id_type> ids, component_mask mask );
+        void queueRemoved( id::id_type id );
+        void queueComponentsAdded( id::id_type id, component_mask added );
+    } // namespace detail
+} // namespace muggy::ecs
+
+
+#endif
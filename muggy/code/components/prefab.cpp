@@ -0,0 +1,210 @@
+//********************************************************************
+//  File:    prefab.cpp
+//  Date:    Sun, 18 Oct 2026: 00:40
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "prefab.h"
+#include "entity.h"
+#include "hierarchy.h"
+#include "idAllocator.h"
+
+namespace muggy::game_entity
+{
+    namespace
+    {
+        // Unregistered prefabs leave a nullptr behind.
+        // NOTE(klek): Prefabs are shared by all worlds, so the registry
+        //             is locked. A prefab must not be unregistered while
+        //             it is being instantiated
+        utils::vector<prefab*>  prefabs;
+        std::mutex              prefabMutex;
+
+        const prefab& getPrefab( prefab_id id )
+        {
+            std::lock_guard<std::mutex> lock{ prefabMutex };
+            assert( id::isValid( id ) && id < prefabs.size() && prefabs[ id ] );
+            return *prefabs[ id ];
+        }
+
+        // Writes "value" to "count" rows of the column starting at
+        // "firstRow". Within a chunk the filled part is doubled with
+        // each memcpy, so a run of n rows takes log2(n) copies
+        void fillColumn( const ecs::archetype& a, uint32_t firstRow, uint32_t count,
+                         ecs::component_type type, const void* value )
+        {
+            const uint32_t size{ ecs::getComponentDesc( type ).size };
+            const uint32_t capacity{ a.getChunkCapacity() };
+            uint32_t row{ firstRow };
+            const uint32_t end{ firstRow + count };
+            while ( row < end )
+            {
+                const uint32_t run{ std::min( capacity - row % capacity, end - row ) };
+                uint8_t *const dst{ (uint8_t*)a.getComponent( row, type ) };
+                memcpy( dst, value, size );
+                uint32_t filled{ 1 };
+                while ( filled < run )
+                {
+                    const uint32_t n{ std::min( filled, run - filled ) };
+                    memcpy( dst + filled * size, dst, n * size );
+                    filled += n;
+                }
+                row += run;
+            }
+        }
+    } // namespace anonymous
+
+    uint32_t prefab::addNode( const transform::init_info& transform, uint32_t parent )
+    {
+        // Only the first node is a root
+        assert( m_Nodes.empty() == ( parent == uint32_invalid_id ) );
+        assert( parent == uint32_invalid_id || parent < m_Nodes.size() );
+        m_Nodes.push_back( { math::fv3d( transform.position ),
+                             math::fv4d( transform.rotation ),
+                             math::fv3d( transform.scale ),
+                             parent,
+                             transform::getComponentMask(),
+                             0 } );
+        return (uint32_t)m_Nodes.size() - 1;
+    }
+
+    void prefab::addComponent( uint32_t node, ecs::component_type type,
+                               const void* data )
+    {
+        assert( node < m_Nodes.size() && data );
+        // The transform is set with addNode()
+        assert( !( ( transform::getComponentMask() >> type ) & 1 ) );
+        const uint32_t size{ ecs::getComponentDesc( type ).size };
+        const uint32_t offset{ (uint32_t)m_Data.size() };
+        m_Data.resize( offset + size );
+        memcpy( m_Data.data() + offset, data, size );
+        m_Components.push_back( { node, type, offset } );
+        m_Nodes[ node ].mask |= ecs::component_mask{ 1 } << type;
+    }
+
+    void prefab::setTags( uint32_t node, ecs::tag_mask tags )
+    {
+        assert( node < m_Nodes.size() );
+        m_Nodes[ node ].tags = tags;
+    }
+
+    prefab_id registerPrefab( const prefab& p )
+    {
+        assert( p.getNodeCount() );
+        prefab *const copy{ new prefab( p ) };
+        std::lock_guard<std::mutex> lock{ prefabMutex };
+        prefabs.push_back( copy );
+        return prefab_id{ (id::id_type)prefabs.size() - 1 };
+    }
+
+    void unregisterPrefab( prefab_id id )
+    {
+        std::lock_guard<std::mutex> lock{ prefabMutex };
+        assert( id::isValid( id ) && id < prefabs.size() && prefabs[ id ] );
+        delete prefabs[ id ];
+        prefabs[ id ] = nullptr;
+    }
+
+    void instantiate( prefab_id id, uint32_t count,
+                      utils::span<const transform::init_info> transforms,
+                      utils::span<entity> entities )
+    {
+        const prefab& p{ getPrefab( id ) };
+        const uint32_t nodeCount{ p.getNodeCount() };
+        assert( transforms.empty() || transforms.size() == count );
+        assert( entities.size() == (uint64_t)count * nodeCount );
+        if ( !count )
+        {
+            return;
+        }
+
+        // Get the ids for all instances in one go
+        const uint32_t total{ count * nodeCount };
+        utils::vector<id::id_type> ids( total );
+        detail::getIdAllocator().allocate( ids );
+        for ( uint32_t i{ 0 }; i < total; i++ )
+        {
+            entities[ i ] = entity{ entity_id{ ids[ i ] } };
+        }
+
+        std::lock_guard<std::mutex> lock{ detail::getStorageMutex() };
+        utils::vector<id::id_type> nodeIds( count );
+        for ( uint32_t n{ 0 }; n < nodeCount; n++ )
+        {
+            // Place this node of every instance in contiguous rows
+            const prefab::node& node{ p.m_Nodes[ n ] };
+            for ( uint32_t i{ 0 }; i < count; i++ )
+            {
+                nodeIds[ i ] = ids[ i * nodeCount + n ];
+            }
+            ecs::addEntities( nodeIds, node.mask );
+            const uint32_t first{ ecs::getLocation( nodeIds[ 0 ] ).row };
+            const ecs::archetype& a{ ecs::getArchetypeFromId(
+                                        ecs::getLocation( nodeIds[ 0 ] ).archetype ) };
+
+            if ( node.tags )
+            {
+                for ( uint32_t i{ 0 }; i < count; i++ )
+                {
+                    ecs::setTags( nodeIds[ i ], node.tags );
+                }
+            }
+
+            for ( uint32_t c{ 0 }; c < p.m_Components.size(); c++ )
+            {
+                const prefab::component_value& value{ p.m_Components[ c ] };
+                if ( value.node == n )
+                {
+                    fillColumn( a, first, count, value.type,
+                                p.m_Data.data() + value.offset );
+                }
+            }
+
+            if ( n || transforms.empty() )
+            {
+                fillColumn( a, first, count, ecs::componentType<transform::position>(),
+                            &node.position );
+                fillColumn( a, first, count, ecs::componentType<transform::rotation>(),
+                            &node.rotation );
+                fillColumn( a, first, count, ecs::componentType<transform::scale>(),
+                            &node.scale );
+                continue;
+            }
+
+            // The root transform is the only per-instance data
+            for ( uint32_t i{ 0 }; i < count; i++ )
+            {
+                const transform::init_info& info{ transforms[ i ] };
+                new ( a.getComponent( first + i, ecs::componentType<transform::position>() ) )
+                    math::fv3d( info.position );
+                new ( a.getComponent( first + i, ecs::componentType<transform::rotation>() ) )
+                    math::fv4d( info.rotation );
+                new ( a.getComponent( first + i, ecs::componentType<transform::scale>() ) )
+                    math::fv3d( info.scale );
+            }
+        }
+
+        // The ids are ordered instance by instance, with every node
+        // after its parent, which is the order the hierarchy expects
+        utils::vector<id::id_type> parents( total );
+        for ( uint32_t i{ 0 }; i < count; i++ )
+        {
+            for ( uint32_t n{ 0 }; n < nodeCount; n++ )
+            {
+                const uint32_t parent{ p.m_Nodes[ n ].parent };
+                if ( parent != uint32_invalid_id )
+                {
+                    parents[ i * nodeCount + n ] = ids[ i * nodeCount + parent ];
+                }
+                else
+                {
+                    parents[ i * nodeCount + n ] = transforms.empty() ?
+                        id::invalid_id : (id::id_type)transforms[ i ].parent.getId();
+                }
+            }
+        }
+        transform::detail::addNodes( ids, parents );
+    }
+} // namespace muggy::game_entity
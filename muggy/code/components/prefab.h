@@ -0,0 +1,97 @@
+//********************************************************************
+//  File:    prefab.h
+//  Date:    Sun, 18 Oct 2026: 00:15
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(PREFAB_H)
+#define PREFAB_H
+
+#include "componentsCommon.h"
+#include "archetype.h"
+#include "tags.h"
+#include "transform.h"
+
+namespace muggy::game_entity
+{
+    DEFINE_TYPED_ID(prefab_id);
+
+    // Template for a hierarchy of entities and their component data,
+    // which can be instantiated many times with instantiate().
+    // Names are unique, so instances start without one, see setName().
+    // The first node is the root of the hierarchy, every other node
+    // has a parent that was added before it
+    class prefab
+    {
+    public:
+        // Adds a node with a local transform and returns its index in
+        // the prefab. The parent in the init_info is ignored, the
+        // "parent" index is used instead
+        uint32_t addNode( const transform::init_info& transform,
+                          uint32_t parent = uint32_invalid_id );
+        // Gives the node a component with the specified value
+        void addComponent( uint32_t node, ecs::component_type type,
+                           const void* data );
+
+        template <typename T>
+        void addComponent( uint32_t node, const ecs::component_value_t<T>& value )
+        {
+            addComponent( node, ecs::componentType<T>(), &value );
+        }
+
+        // Replaces the tags every instance of the node starts with, 
+        // see ecs::tagMask()
+        void setTags( uint32_t node, ecs::tag_mask tags );
+
+        [[nodiscard]] uint32_t getNodeCount() const
+        {
+            return (uint32_t)m_Nodes.size();
+        }
+
+    private:
+        friend void instantiate( prefab_id, uint32_t, 
+                                 utils::span<const transform::init_info>,
+                                 utils::span<entity> );
+
+        struct node
+        {
+            math::fv3d          position;
+            math::fv4d          rotation;
+            math::fv3d          scale;
+            uint32_t            parent;
+            ecs::component_mask mask;
+            ecs::tag_mask       tags;
+        };
+
+        struct component_value
+        {
+            uint32_t            node;
+            ecs::component_type type;
+            uint32_t            offset;
+        };
+
+        utils::vector<node>             m_Nodes;
+        utils::vector<component_value>  m_Components;
+        utils::vector<uint8_t>          m_Data;
+    };
+
+    // Stores a copy of the prefab and returns its id
+    prefab_id registerPrefab( const prefab& p );
+    void unregisterPrefab( prefab_id id );
+
+    // Creates "count" instances of the prefab. If "transforms" isn't
+    // empty it holds one item per instance, which replaces the local 
+    // transform of the root node and whose parent becomes the parent
+    // of the instance root. The entities of instance i are written to
+    // entities[ i * nodeCount + node ].
+    // All instances of the same node are placed in contiguous rows, so
+    // the component columns are filled with bulk copies
+    void instantiate( prefab_id id, uint32_t count, 
+                      utils::span<const transform::init_info> transforms,
+                      utils::span<entity> entities );
+} // namespace muggy::game_entity
+
+
+#endif
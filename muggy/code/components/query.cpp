@@ -0,0 +1,39 @@
+//********************************************************************
+//  File:    query.cpp
+//  Date:    Tue, 20 Oct 2026: 14:05
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "query.h"
+#include "world.h"
+
+namespace muggy::ecs
+{
+    void query_cache::update( component_mask mask, component_mask exclude ) const
+    {
+        const uint64_t serial{ getCurrentWorld().getSerial() };
+        if ( serial != m_WorldSerial || mask != m_Mask || exclude != m_Exclude )
+        {
+            m_Matches.clear();
+            m_Mask = mask;
+            m_Exclude = exclude;
+            m_WorldSerial = serial;
+            m_Seen = 0;
+        }
+
+        // Archetypes are only ever appended, so everything before
+        // m_Seen has been matched already
+        const uint32_t count{ getArchetypeCount() };
+        for ( archetype_id id{ m_Seen }; id < count; id++ )
+        {
+            const component_mask archetypeMask{ getArchetypeFromId( id ).getMask() };
+            if ( ( archetypeMask & mask ) == mask && !( archetypeMask & exclude ) )
+            {
+                m_Matches.push_back( id );
+            }
+        }
+        m_Seen = count;
+    }
+} // namespace muggy::ecs
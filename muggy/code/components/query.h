@@ -0,0 +1,318 @@
+//********************************************************************
+//  File:    query.h
+//  Date:    Sat, 17 Oct 2026: 16:30
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(QUERY_H)
+#define QUERY_H
+
+#include "archetype.h"
+
+namespace muggy::ecs
+{
+    namespace detail
+    {
+        // Matches the masks of all archetypes on every use
+        struct archetype_scan
+        {
+            template <typename F>
+            void forEachChunk( component_mask mask, component_mask exclude, 
+                               F&& func ) const
+            {
+                ecs::forEachChunk( mask, exclude, std::forward<F>( func ) );
+            }
+        };
+    } // namespace detail
+
+    // The archetypes that match a mask, kept between uses. Archetypes
+    // are never destroyed, so only the ones created since the last use
+    // have to be matched. The chunks of the matched archetypes are read
+    // when iterating, so entities being added or removed doesn't make
+    // the cache stale. Using it from another world rebuilds it.
+    // NOTE(klek): The cache is updated by const iteration, so a single
+    //             cache must not be used by several threads at once
+    class query_cache
+    {
+    public:
+        template <typename F>
+        void forEachChunk( component_mask mask, component_mask exclude, 
+                           F&& func ) const
+        {
+            update( mask, exclude );
+            for ( uint32_t i{ 0 }; i < m_Matches.size(); i++ )
+            {
+                archetype& a{ getArchetypeFromId( m_Matches[ i ] ) };
+                const uint32_t chunkCount{ a.getChunkCount() };
+                for ( uint32_t c{ 0 }; c < chunkCount; c++ )
+                {
+                    func( a, c, a.getChunkSize( c ) );
+                }
+            }
+        }
+
+        // Number of matching archetypes, as of the last use
+        [[nodiscard]] uint32_t getMatchCount() const
+        {
+            return (uint32_t)m_Matches.size();
+        }
+
+    private:
+        // Matches the archetypes created since the last call, or all of
+        // them if the masks or the world changed
+        void update( component_mask mask, component_mask exclude ) const;
+
+        mutable utils::vector<archetype_id> m_Matches;
+        mutable component_mask              m_Mask{ 0 };
+        mutable component_mask              m_Exclude{ 0 };
+        // Serial of the world the matches are from, 0 for none
+        mutable uint64_t                    m_WorldSerial{ 0 };
+        // Number of archetypes that have been matched
+        mutable uint32_t                    m_Seen{ 0 };
+    };
+
+    namespace detail
+    {
+        // Column pointer handed to the functions of a view. Only the
+        // components that are marked as written can be modified, since
+        // changes made through any other pointer wouldn't be seen by
+        // changedSince() or the transform hierarchy
+        template <typename T, typename... Written>
+        using column_pointer_t = std::conditional_t<( std::is_same<T, Written>::value || ... ),
+                                                    component_value_t<T>*,
+                                                    const component_value_t<T>*>;
+
+        // A view over all entities that have every component in 
+        // Components... (and none of the excluded ones). Matching is done
+        // on the archetype masks, so the view only walks the chunks of
+        // matching archetypes and never tests single entities. Source
+        // decides which archetypes are visited, see view and query below.
+        template <typename Source, typename... Components>
+        class basic_view
+        {
+        public:
+            basic_view()
+             :
+                m_Mask( componentMask<Components...>() )
+            {}
+
+            // Skips entities that have any of the Excluded components
+            template <typename... Excluded>
+            basic_view& exclude()
+            {
+                m_Exclude |= componentMask<Excluded...>();
+                return *this;
+            }
+
+            // Only visits entities where any of the Changed components was
+            // written after "version", see ecs::advanceVersion()
+            template <typename... Changed>
+            basic_view& changedSince( uint32_t version )
+            {
+                m_Changed |= componentMask<Changed...>();
+                m_Since = version;
+                // The changed components must be part of the view
+                assert( ( m_Changed & m_Mask ) == m_Changed );
+                return *this;
+            }
+
+            // Calls func( count, entities, columns... ) once per chunk, with
+            // one raw column pointer per component. This is the one to use
+            // for loops the compiler should vectorize. The columns are
+            // const, use eachChunkWrite() to modify them.
+            // NOTE(klek): The change filter is applied per chunk here, so a
+            //             chunk with any changed row is passed as a whole
+            template <typename F>
+            void eachChunk( F&& func ) const
+            {
+                m_Source.forEachChunk( m_Mask, m_Exclude,
+                    [this, &func]( archetype& a, uint32_t chunk, uint32_t count )
+                    {
+                        if ( !isChunkChanged( a, chunk ) )
+                        {
+                            return;
+                        }
+                        func( count, 
+                              (const id::id_type*)a.getEntities( chunk ),
+                              (column_pointer_t<Components>)a.getColumn<Components>( chunk )... );
+                    } );
+            }
+
+            // Same as eachChunk() but marks the Written components of every
+            // visited chunk as changed, which is how columns must be accessed
+            // when they are modified in place. Only the Written columns are
+            // passed as non-const pointers
+            template <typename... Written, typename F>
+            void eachChunkWrite( F&& func ) const
+            {
+                const component_mask written{ componentMask<Written...>() };
+                assert( ( written & m_Mask ) == written );
+                m_Source.forEachChunk( m_Mask, m_Exclude,
+                    [this, &func]( archetype& a, uint32_t chunk, uint32_t count )
+                    {
+                        if ( !isChunkChanged( a, chunk ) )
+                        {
+                            return;
+                        }
+                        ( (void)a.writeColumn<Written>( chunk ), ... );
+                        func( count, 
+                              (const id::id_type*)a.getEntities( chunk ),
+                              (column_pointer_t<Components, Written...>)
+                                a.getColumn<Components>( chunk )... );
+                    } );
+            }
+
+            // Calls func( id, const components&... ) once per matching
+            // entity
+            template <typename F>
+            void each( F&& func ) const
+            {
+                m_Source.forEachChunk( m_Mask, m_Exclude,
+                    [this, &func]( archetype& a, uint32_t chunk, uint32_t count )
+                    {
+                        if ( !isChunkChanged( a, chunk ) )
+                        {
+                            return;
+                        }
+                        const id::id_type *const ids{ a.getEntities( chunk ) };
+                        eachRow( a, chunk, count, func, ids, 
+                                 (column_pointer_t<Components>)a.getColumn<Components>( chunk )... );
+                    } );
+            }
+
+            // Same as each() but the Written components are passed as
+            // non-const references and the visited rows are marked as 
+            // changed
+            template <typename... Written, typename F>
+            void eachWrite( F&& func ) const
+            {
+                const component_mask written{ componentMask<Written...>() };
+                assert( ( written & m_Mask ) == written );
+                m_Source.forEachChunk( m_Mask, m_Exclude,
+                    [this, &func]( archetype& a, uint32_t chunk, uint32_t count )
+                    {
+                        if ( !isChunkChanged( a, chunk ) )
+                        {
+                            return;
+                        }
+                        const id::id_type *const ids{ a.getEntities( chunk ) };
+                        eachRow<Written...>( a, chunk, count, func, ids, 
+                                             (column_pointer_t<Components, Written...>)
+                                                a.getColumn<Components>( chunk )... );
+                    } );
+            }
+
+            // Returns the number of matching entities
+            [[nodiscard]] uint32_t count() const
+            {
+                uint32_t total{ 0 };
+                m_Source.forEachChunk( m_Mask, m_Exclude,
+                    [this, &total]( archetype& a, uint32_t chunk, uint32_t count )
+                    {
+                        if ( !m_Changed )
+                        {
+                            total += count;
+                            return;
+                        }
+                        for ( uint32_t i{ 0 }; i < count; i++ )
+                        {
+                            total += isRowChanged( a, chunk, i );
+                        }
+                    } );
+                return total;
+            }
+
+            [[nodiscard]] constexpr component_mask getMask() const
+            {
+                return m_Mask;
+            }
+
+            [[nodiscard]] constexpr component_mask getExcludeMask() const
+            {
+                return m_Exclude;
+            }
+
+        private:
+            [[nodiscard]] bool isChunkChanged( const archetype& a, uint32_t chunk ) const
+            {
+                component_mask m{ m_Changed };
+                for ( component_type type{ 0 }; m; type++, m >>= 1 )
+                {
+                    if ( ( m & 1 ) && isNewer( a.getChunkVersion( chunk, type ), m_Since ) )
+                    {
+                        return true;
+                    }
+                }
+                return !m_Changed;
+            }
+
+            [[nodiscard]] bool isRowChanged( const archetype& a, uint32_t chunk, 
+                                             uint32_t slot ) const
+            {
+                component_mask m{ m_Changed };
+                for ( component_type type{ 0 }; m; type++, m >>= 1 )
+                {
+                    if ( ( m & 1 ) && isNewer( a.getVersions( chunk, type )[ slot ], m_Since ) )
+                    {
+                        return true;
+                    }
+                }
+                return !m_Changed;
+            }
+
+            // Calls func for every row that passes the change filter and
+            // marks the Written components of those rows as changed
+            template <typename... Written, typename F, typename... Columns>
+            void eachRow( archetype& a, uint32_t chunk, uint32_t count, F& func,
+                          const id::id_type* ids, Columns*... columns ) const
+            {
+                const uint32_t first{ chunk * a.getChunkCapacity() };
+                for ( uint32_t i{ 0 }; i < count; i++ )
+                {
+                    if ( isRowChanged( a, chunk, i ) )
+                    {
+                        ( a.markChanged( first + i, 1, componentType<Written>() ), ... );
+                        func( ids[ i ], columns[ i ]... );
+                    }
+                }
+            }
+
+            Source          m_Source{};
+            component_mask  m_Mask{ 0 };
+            component_mask  m_Exclude{ 0 };
+            // Components to check for changes, 0 if the filter is not used
+            component_mask  m_Changed{ 0 };
+            uint32_t        m_Since{ 0 };
+        };
+    } // namespace detail
+
+    // Matches the archetype masks every time it's used, which is
+    // what a view created on the spot in a system should do.
+    //
+    // Example:
+    //  ecs::view<transform::position, velocity> v;
+    //  v.eachChunkWrite<transform::position>( 
+    //      []( uint32_t count, const id::id_type* ids,
+    //          math::fv3d* p, const math::fv3d* vel ) { ... } );
+    //
+    // With changedSince() the view only visits entities that had one
+    // of the named components written after the specified version:
+    //  view<transform::position>().changedSince<transform::position>( seen )
+    //      .each( []( id::id_type id, const math::fv3d& p ) { ... } );
+    template <typename... Components>
+    using view = detail::basic_view<detail::archetype_scan, Components...>;
+
+    // Same as view but keeps the matching archetypes in a query_cache,
+    // so when no archetypes were created since the last use it does no
+    // matching at all. Meant to be kept by a system between frames:
+    //  ecs::query<transform::position, velocity> m_Moving;
+    //  m_Moving.eachChunkWrite<transform::position>( ... );
+    template <typename... Components>
+    using query = detail::basic_view<query_cache, Components...>;
+} // namespace muggy::ecs
+
+
+#endif
+
@@ -0,0 +1,872 @@
+//********************************************************************
+//  File:    snapshot.cpp
+//  Date:    Sat, 17 Oct 2026: 22:20
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "snapshot.h"
+#include "entity.h"
+#include "transform.h"
+#include "archetype.h"
+#include "hierarchy.h"
+#include "idAllocator.h"
+#include "names.h"
+#include "tags.h"
+#include <algorithm>
+#include <cstdio>
+#include <unordered_set>
+
+#if defined(_WIN64)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace muggy::game_entity
+{
+    namespace
+    {
+        // "MSNP" when read as bytes
+        constexpr uint32_t snapshot_magic{ 0x504e534d };
+        // Every section of the file starts at a multiple of this, so
+        // the arrays can be used directly from the mapped file
+        constexpr uint64_t section_alignment{ 64 };
+        constexpr uint32_t max_name_length{ 248 };
+
+        // All offsets are in bytes from the start of the file
+        struct snapshot_header
+        {
+            uint32_t    magic;
+            uint32_t    version;
+            uint32_t    idSize;
+            uint32_t    generationBits;
+            uint64_t    fileSize;
+            // One generation per index, ie the state of the id allocator
+            uint64_t    indexCount;
+            uint64_t    generationsOffset;
+            uint64_t    freeIdCount;
+            uint64_t    freeIdsOffset;
+            // Child and parent ids of every transform with a parent
+            uint64_t    parentCount;
+            uint64_t    parentsOffset;
+            uint32_t    componentCount;
+            uint32_t    archetypeCount;
+            uint64_t    componentsOffset;
+            uint64_t    archetypesOffset;
+            // One bitset of indexCount bits per tag type
+            uint32_t    tagTypeCount;
+            uint32_t    reserved;
+            uint64_t    tagTypesOffset;
+            uint64_t    tagsOffset;
+            // One record per named entity, and the characters of all
+            // names one after the other
+            uint64_t    nameCount;
+            uint64_t    namesOffset;
+            uint64_t    nameTextSize;
+            uint64_t    nameTextOffset;
+        };
+
+        // Component types are matched by name when loading, since the
+        // type numbers depend on the order of registration
+        struct component_record
+        {
+            uint32_t    size;
+            uint32_t    alignment;
+            char        name[ max_name_length ];
+        };
+
+        // Tag types are matched by name as well
+        struct tag_record
+        {
+            char        name[ max_name_length ];
+        };
+
+        // The ids and each column of an archetype are stored as one
+        // contiguous array each, regardless of the chunk layout
+        struct archetype_record
+        {
+            ecs::component_mask mask;
+            uint64_t            count;
+            uint64_t            idsOffset;
+            uint64_t            columnOffsets[ ecs::max_component_types ];
+        };
+
+        struct parent_record
+        {
+            id::id_type child;
+            id::id_type parent;
+        };
+
+        // The text isn't terminated, it is "length" characters from
+        // "textOffset" in the name text section
+        struct name_record
+        {
+            id::id_type id;
+            uint32_t    length;
+            uint64_t    textOffset;
+        };
+
+        constexpr uint64_t alignUp( uint64_t value )
+        {
+            return ( value + section_alignment - 1 ) & ~( section_alignment - 1 );
+        }
+
+        // Number of words in the bitset of each saved tag
+        constexpr uint64_t tagWordCount( uint64_t indexCount )
+        {
+            return ( indexCount + utils::bitset::word_bits - 1 ) / utils::bitset::word_bits;
+        }
+
+        // Returns true if an aligned section of "count" items of "size"
+        // bytes at "offset" lies within a file of "fileSize" bytes. The
+        // product is never formed, so large counts can't overflow it
+        constexpr bool isSectionInFile( uint64_t offset, uint64_t count, 
+                                        uint64_t size, uint64_t fileSize )
+        {
+            return ( offset % section_alignment ) == 0 &&
+                   offset <= fileSize &&
+                   ( !count || ( size && count <= ( fileSize - offset ) / size ) );
+        }
+
+        // Returns true if the index of every id was handed out when the
+        // snapshot was saved
+        bool areIdsInRange( const id::id_type* ids, uint64_t count, uint64_t indexCount )
+        {
+            for ( uint64_t i{ 0 }; i < count; i++ )
+            {
+                if ( !id::isValid( ids[ i ] ) || id::index( ids[ i ] ) >= indexCount )
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Returns true if the ids of the snapshot describe a world that
+        // could have been saved. Every stored id must be in one archetype
+        // only, carry the generation of its index and not be free as
+        // well, the parents must be stored entities without cycles and
+        // the names must belong to stored entities, one each, and be
+        // unique.
+        // NOTE(klek): The sections must have been checked against the
+        //             size of the file already
+        bool areIdsConsistent( const uint8_t* base, const snapshot_header& header )
+        {
+            const id::generation_type* generations{
+                (const id::generation_type*)( base + header.generationsOffset ) };
+            auto isCurrent = [generations]( id::id_type id )
+            {
+                return id::generation( id ) == generations[ id::index( id ) ];
+            };
+
+            utils::bitset stored{ header.indexCount };
+            const archetype_record* archetypes{
+                (const archetype_record*)( base + header.archetypesOffset ) };
+            for ( uint32_t i{ 0 }; i < header.archetypeCount; i++ )
+            {
+                const id::id_type* ids{ (const id::id_type*)( base + archetypes[ i ].idsOffset ) };
+                for ( uint64_t j{ 0 }; j < archetypes[ i ].count; j++ )
+                {
+                    const id::id_type index{ id::index( ids[ j ] ) };
+                    if ( stored.test( index ) || !isCurrent( ids[ j ] ) )
+                    {
+                        return false;
+                    }
+                    stored.set( index );
+                }
+            }
+
+            // A free index is handed out again, so it can't be stored or
+            // free twice
+            utils::bitset free{ header.indexCount };
+            const id::id_type* freeIds{ (const id::id_type*)( base + header.freeIdsOffset ) };
+            for ( uint64_t i{ 0 }; i < header.freeIdCount; i++ )
+            {
+                const id::id_type index{ id::index( freeIds[ i ] ) };
+                if ( stored.test( index ) || free.test( index ) || !isCurrent( freeIds[ i ] ) )
+                {
+                    return false;
+                }
+                free.set( index );
+            }
+
+            // Each child has one parent, kept by index
+            utils::vector<id::id_type> parentOf( header.indexCount, id::invalid_id );
+            const parent_record* parents{
+                (const parent_record*)( base + header.parentsOffset ) };
+            for ( uint64_t i{ 0 }; i < header.parentCount; i++ )
+            {
+                const parent_record& record{ parents[ i ] };
+                const id::id_type child{ id::index( record.child ) };
+                if ( !stored.test( child ) || !isCurrent( record.child ) ||
+                     !stored.test( id::index( record.parent ) ) || !isCurrent( record.parent ) ||
+                     parentOf[ child ] != id::invalid_id )
+                {
+                    return false;
+                }
+                parentOf[ child ] = id::index( record.parent );
+            }
+
+            // Walk up from every child. Reaching an index that is on the
+            // current path means there is a cycle, and indices that are
+            // known to lead to a root are not walked again
+            enum : uint8_t { unvisited, on_path, done };
+            utils::vector<uint8_t> state( header.indexCount, unvisited );
+            utils::vector<id::id_type> path;
+            for ( uint64_t i{ 0 }; i < header.parentCount; i++ )
+            {
+                path.clear();
+                id::id_type index{ id::index( parents[ i ].child ) };
+                while ( index != id::invalid_id && state[ index ] == unvisited )
+                {
+                    state[ index ] = on_path;
+                    path.push_back( index );
+                    index = parentOf[ index ];
+                }
+                if ( index != id::invalid_id && state[ index ] == on_path )
+                {
+                    return false;
+                }
+                for ( const id::id_type visited : path )
+                {
+                    state[ visited ] = done;
+                }
+            }
+
+            utils::bitset named{ header.indexCount };
+            std::unordered_set<std::string_view> texts;
+            const name_record* names{ (const name_record*)( base + header.namesOffset ) };
+            const char* text{ (const char*)( base + header.nameTextOffset ) };
+            for ( uint64_t i{ 0 }; i < header.nameCount; i++ )
+            {
+                const name_record& record{ names[ i ] };
+                const id::id_type index{ id::index( record.id ) };
+                if ( !stored.test( index ) || !isCurrent( record.id ) || named.test( index ) ||
+                     !texts.insert( { text + record.textOffset, record.length } ).second )
+                {
+                    return false;
+                }
+                named.set( index );
+            }
+            return true;
+        }
+
+        // Writes the file in order while keeping track of the offset,
+        // so sections can be padded to the alignment
+        class file_writer
+        {
+        public:
+            explicit file_writer( const char* path )
+             :
+                m_File( fopen( path, "wb" ) )
+            {}
+
+            ~file_writer()
+            {
+                if ( m_File )
+                {
+                    fclose( m_File );
+                }
+            }
+
+            [[nodiscard]] bool isOpen() const
+            {
+                return m_File != nullptr;
+            }
+
+            void write( const void* data, uint64_t size )
+            {
+                if ( size && m_Ok )
+                {
+                    m_Ok = fwrite( data, 1, size, m_File ) == size;
+                }
+                m_Offset += size;
+            }
+
+            // Pads with zeros up to the next section
+            void align()
+            {
+                static const uint8_t zeros[ section_alignment ]{ };
+                write( zeros, alignUp( m_Offset ) - m_Offset );
+            }
+
+            [[nodiscard]] bool close()
+            {
+                const bool ok{ m_Ok && fclose( m_File ) == 0 };
+                m_File = nullptr;
+                return ok;
+            }
+
+        private:
+            FILE*       m_File{ nullptr };
+            uint64_t    m_Offset{ 0 };
+            bool        m_Ok{ true };
+        };
+
+        // Read-only memory mapping of a whole file
+        class mapped_file
+        {
+        public:
+            explicit mapped_file( const char* path )
+            {
+#if defined(_WIN64)
+                m_File = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                      OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+                LARGE_INTEGER size;
+                if ( m_File == INVALID_HANDLE_VALUE || !GetFileSizeEx( m_File, &size ) ||
+                     !size.QuadPart )
+                {
+                    return;
+                }
+                m_Mapping = CreateFileMappingA( m_File, nullptr, PAGE_READONLY, 0, 0, nullptr );
+                if ( m_Mapping )
+                {
+                    m_Data = (const uint8_t*)MapViewOfFile( m_Mapping, FILE_MAP_READ, 0, 0, 0 );
+                    m_Size = m_Data ? (uint64_t)size.QuadPart : 0;
+                }
+#else
+                m_File = open( path, O_RDONLY );
+                struct stat info;
+                if ( m_File < 0 || fstat( m_File, &info ) != 0 || !info.st_size )
+                {
+                    return;
+                }
+                void* data{ mmap( nullptr, info.st_size, PROT_READ, MAP_PRIVATE, m_File, 0 ) };
+                if ( data != MAP_FAILED )
+                {
+                    // The whole file is read front to back
+                    madvise( data, info.st_size, MADV_SEQUENTIAL );
+                    m_Data = (const uint8_t*)data;
+                    m_Size = info.st_size;
+                }
+#endif
+            }
+
+            ~mapped_file()
+            {
+#if defined(_WIN64)
+                if ( m_Data ) UnmapViewOfFile( m_Data );
+                if ( m_Mapping ) CloseHandle( m_Mapping );
+                if ( m_File != INVALID_HANDLE_VALUE ) CloseHandle( m_File );
+#else
+                if ( m_Data ) munmap( (void*)m_Data, m_Size );
+                if ( m_File >= 0 ) close( m_File );
+#endif
+            }
+
+            mapped_file( const mapped_file& ) = delete;
+            mapped_file& operator=( const mapped_file& ) = delete;
+
+            [[nodiscard]] const uint8_t* data() const
+            {
+                return m_Data;
+            }
+
+            [[nodiscard]] uint64_t size() const
+            {
+                return m_Size;
+            }
+
+        private:
+#if defined(_WIN64)
+            HANDLE          m_File{ INVALID_HANDLE_VALUE };
+            HANDLE          m_Mapping{ nullptr };
+#else
+            int             m_File{ -1 };
+#endif
+            const uint8_t*  m_Data{ nullptr };
+            uint64_t        m_Size{ 0 };
+        };
+
+        // Calls func( ids, count ) for every chunk of the archetype
+        template <typename F>
+        void forEachIdRun( const ecs::archetype& a, F&& func )
+        {
+            for ( uint32_t c{ 0 }; c < a.getChunkCount(); c++ )
+            {
+                func( a.getEntities( c ), a.getChunkSize( c ) );
+            }
+        }
+
+        // Checks every section and count of the snapshot against the
+        // size of the file and the ids against each other, before
+        // anything is loaded
+        bool isSnapshotValid( const uint8_t* base, uint64_t fileSize )
+        {
+            const snapshot_header& header{ *(const snapshot_header*)base };
+            if ( header.magic != snapshot_magic ||
+                 header.version != snapshot_version ||
+                 header.idSize != sizeof( id::id_type ) ||
+                 header.generationBits != id::detail::generationBits ||
+                 header.fileSize != fileSize ||
+                 header.componentCount > ecs::max_component_types ||
+                 header.tagTypeCount > ecs::max_tag_types ||
+                 header.indexCount > id::detail::indexMask )
+            {
+                return false;
+            }
+
+            if ( !isSectionInFile( header.generationsOffset, header.indexCount,
+                                   sizeof( id::generation_type ), fileSize ) ||
+                 !isSectionInFile( header.freeIdsOffset, header.freeIdCount,
+                                   sizeof( id::id_type ), fileSize ) ||
+                 !isSectionInFile( header.parentsOffset, header.parentCount,
+                                   sizeof( parent_record ), fileSize ) ||
+                 !isSectionInFile( header.componentsOffset, header.componentCount,
+                                   sizeof( component_record ), fileSize ) ||
+                 !isSectionInFile( header.archetypesOffset, header.archetypeCount,
+                                   sizeof( archetype_record ), fileSize ) ||
+                 !isSectionInFile( header.tagTypesOffset, header.tagTypeCount,
+                                   sizeof( tag_record ), fileSize ) ||
+                 !isSectionInFile( header.tagsOffset, 
+                                   header.tagTypeCount * tagWordCount( header.indexCount ),
+                                   sizeof( uint64_t ), fileSize ) ||
+                 !isSectionInFile( header.namesOffset, header.nameCount,
+                                   sizeof( name_record ), fileSize ) ||
+                 !isSectionInFile( header.nameTextOffset, header.nameTextSize,
+                                   sizeof( char ), fileSize ) )
+            {
+                return false;
+            }
+
+            // Every name is in the text section and not empty
+            const name_record* names{ (const name_record*)( base + header.namesOffset ) };
+            for ( uint64_t i{ 0 }; i < header.nameCount; i++ )
+            {
+                const name_record& record{ names[ i ] };
+                if ( !id::isValid( record.id ) || id::index( record.id ) >= header.indexCount ||
+                     !record.length || record.textOffset > header.nameTextSize ||
+                     record.length > header.nameTextSize - record.textOffset )
+                {
+                    return false;
+                }
+            }
+
+            const id::id_type* freeIds{ (const id::id_type*)( base + header.freeIdsOffset ) };
+            const parent_record* parents{
+                (const parent_record*)( base + header.parentsOffset ) };
+            if ( !areIdsInRange( freeIds, header.freeIdCount, header.indexCount ) ||
+                 !areIdsInRange( (const id::id_type*)parents, header.parentCount * 2,
+                                 header.indexCount ) )
+            {
+                return false;
+            }
+
+            const component_record* components{
+                (const component_record*)( base + header.componentsOffset ) };
+            const archetype_record* archetypes{
+                (const archetype_record*)( base + header.archetypesOffset ) };
+            const ecs::component_mask validTypes{ header.componentCount < 64 ?
+                ( ecs::component_mask{ 1 } << header.componentCount ) - 1 : 
+                ~ecs::component_mask{ 0 } };
+            for ( uint32_t i{ 0 }; i < header.archetypeCount; i++ )
+            {
+                // Empty archetypes are never saved
+                const archetype_record& record{ archetypes[ i ] };
+                if ( !record.count || record.count > header.indexCount ||
+                     ( record.mask & ~validTypes ) ||
+                     !isSectionInFile( record.idsOffset, record.count,
+                                       sizeof( id::id_type ), fileSize ) ||
+                     !areIdsInRange( (const id::id_type*)( base + record.idsOffset ),
+                                     record.count, header.indexCount ) )
+                {
+                    return false;
+                }
+                for ( uint32_t type{ 0 }; type < header.componentCount; type++ )
+                {
+                    if ( ( ( record.mask >> type ) & 1 ) &&
+                         !isSectionInFile( record.columnOffsets[ type ], record.count,
+                                           components[ type ].size, fileSize ) )
+                    {
+                        return false;
+                    }
+                }
+            }
+            return areIdsConsistent( base, header );
+        }
+    } // namespace anonymous
+
+    bool saveSnapshot( const char* path )
+    {
+        assert( path );
+        id::id_allocator& allocator{ detail::getIdAllocator() };
+
+        // Every index that isn't stored is free, which includes the
+        // ids waiting in the allocator caches
+        const id::id_type indexCount{ allocator.getIndexCount() };
+        utils::vector<id::generation_type> generations( indexCount );
+        utils::vector<id::id_type> freeIds;
+        utils::vector<name_record> names;
+        utils::vector<char> nameText;
+        for ( id::id_type index{ 0 }; index < indexCount; index++ )
+        {
+            generations[ index ] = allocator.getGeneration( index );
+            const id::id_type id{ index | ( (id::id_type)generations[ index ] <<
+                                            id::detail::indexBits ) };
+            if ( !ecs::hasEntity( id ) )
+            {
+                freeIds.push_back( id );
+                continue;
+            }
+
+            const std::string_view name{ getName( entity{ entity_id{ id } } ) };
+            if ( !name.empty() )
+            {
+                name_record record{ };
+                record.id = id;
+                record.length = (uint32_t)name.size();
+                record.textOffset = nameText.size();
+                names.push_back( record );
+                nameText.resize( nameText.size() + name.size() );
+                memcpy( nameText.data() + record.textOffset, name.data(), name.size() );
+            }
+        }
+
+        // Collect the archetypes that hold entities and the parents of
+        // their transforms
+        utils::vector<archetype_record> archetypes;
+        utils::vector<parent_record> parents;
+        const uint32_t componentCount{ ecs::getComponentTypeCount() };
+        for ( ecs::archetype_id id{ 0 }; id < ecs::getArchetypeCount(); id++ )
+        {
+            const ecs::archetype& a{ ecs::getArchetypeFromId( id ) };
+            if ( !a.getSize() )
+            {
+                continue;
+            }
+
+            archetype_record record{ };
+            record.mask = a.getMask();
+            record.count = a.getSize();
+            archetypes.push_back( record );
+
+            forEachIdRun( a, [&parents]( const id::id_type* ids, uint32_t count )
+            {
+                for ( uint32_t i{ 0 }; i < count; i++ )
+                {
+                    const transform::component parent{ transform::getParent(
+                        transform::component{ transform::transform_id{ ids[ i ] } } ) };
+                    if ( parent.isValid() )
+                    {
+                        parents.push_back( { ids[ i ], parent.getId() } );
+                    }
+                }
+            } );
+        }
+
+        // Work out where every section goes before writing anything
+        snapshot_header header{ };
+        header.magic = snapshot_magic;
+        header.version = snapshot_version;
+        header.idSize = sizeof( id::id_type );
+        header.generationBits = id::detail::generationBits;
+        header.indexCount = indexCount;
+        header.freeIdCount = freeIds.size();
+        header.parentCount = parents.size();
+        header.componentCount = componentCount;
+        header.archetypeCount = (uint32_t)archetypes.size();
+        const uint32_t tagTypeCount{ ecs::getTagTypeCount() };
+        const uint64_t tagWords{ tagWordCount( indexCount ) };
+        header.tagTypeCount = tagTypeCount;
+        header.nameCount = names.size();
+        header.nameTextSize = nameText.size();
+
+        uint64_t offset{ alignUp( sizeof( snapshot_header ) ) };
+        header.generationsOffset = offset;
+        offset = alignUp( offset + indexCount * sizeof( id::generation_type ) );
+        header.freeIdsOffset = offset;
+        offset = alignUp( offset + freeIds.size() * sizeof( id::id_type ) );
+        header.parentsOffset = offset;
+        offset = alignUp( offset + parents.size() * sizeof( parent_record ) );
+        header.componentsOffset = offset;
+        offset = alignUp( offset + componentCount * sizeof( component_record ) );
+        header.archetypesOffset = offset;
+        offset = alignUp( offset + archetypes.size() * sizeof( archetype_record ) );
+        header.tagTypesOffset = offset;
+        offset = alignUp( offset + tagTypeCount * sizeof( tag_record ) );
+        header.tagsOffset = offset;
+        offset = alignUp( offset + tagTypeCount * tagWords * sizeof( uint64_t ) );
+        header.namesOffset = offset;
+        offset = alignUp( offset + names.size() * sizeof( name_record ) );
+        header.nameTextOffset = offset;
+        offset = alignUp( offset + nameText.size() );
+        for ( uint32_t i{ 0 }; i < archetypes.size(); i++ )
+        {
+            archetype_record& record{ archetypes[ i ] };
+            record.idsOffset = offset;
+            offset = alignUp( offset + record.count * sizeof( id::id_type ) );
+            for ( ecs::component_type type{ 0 }; type < componentCount; type++ )
+            {
+                if ( ( record.mask >> type ) & 1 )
+                {
+                    record.columnOffsets[ type ] = offset;
+                    offset = alignUp( offset + record.count *
+                                      ecs::getComponentDesc( type ).size );
+                }
+            }
+        }
+        header.fileSize = offset;
+
+        file_writer file{ path };
+        if ( !file.isOpen() )
+        {
+            return false;
+        }
+
+        file.write( &header, sizeof( header ) );
+        file.align();
+        file.write( generations.data(), indexCount * sizeof( id::generation_type ) );
+        file.align();
+        file.write( freeIds.data(), freeIds.size() * sizeof( id::id_type ) );
+        file.align();
+        file.write( parents.data(), parents.size() * sizeof( parent_record ) );
+        file.align();
+        for ( ecs::component_type type{ 0 }; type < componentCount; type++ )
+        {
+            const ecs::component_desc& desc{ ecs::getComponentDesc( type ) };
+            component_record record{ };
+            record.size = desc.size;
+            record.alignment = desc.alignment;
+            // If this assert hits, the name is cut and might match
+            // another type when loading
+            assert( strlen( desc.name ) < max_name_length );
+            strncpy( record.name, desc.name, max_name_length - 1 );
+            file.write( &record, sizeof( record ) );
+        }
+        file.align();
+        file.write( archetypes.data(), archetypes.size() * sizeof( archetype_record ) );
+        file.align();
+        for ( ecs::tag_type type{ 0 }; type < tagTypeCount; type++ )
+        {
+            const char *const name{ ecs::getTagName( type ) };
+            tag_record record{ };
+            assert( strlen( name ) < max_name_length );
+            strncpy( record.name, name, max_name_length - 1 );
+            file.write( &record, sizeof( record ) );
+        }
+        file.align();
+        // The tag bitsets may be shorter or longer than indexCount bits,
+        // every one is saved with exactly that many
+        utils::vector<uint64_t> words( tagWords );
+        for ( ecs::tag_type type{ 0 }; type < tagTypeCount; type++ )
+        {
+            const utils::bitset& bits{ ecs::detail::getTagBits( type ) };
+            const uint64_t count{ std::min( tagWords, bits.wordCount() ) };
+            std::fill_n( words.data(), tagWords, 0 );
+            std::copy_n( bits.words(), count, words.data() );
+            const uint64_t used{ indexCount % utils::bitset::word_bits };
+            if ( used )
+            {
+                words[ tagWords - 1 ] &= ( uint64_t{ 1 } << used ) - 1;
+            }
+            file.write( words.data(), tagWords * sizeof( uint64_t ) );
+        }
+        file.align();
+        file.write( names.data(), names.size() * sizeof( name_record ) );
+        file.align();
+        file.write( nameText.data(), nameText.size() );
+        file.align();
+
+        // The chunk data, written one chunk at a time per column
+        for ( uint32_t i{ 0 }; i < archetypes.size(); i++ )
+        {
+            const ecs::archetype& a{ ecs::getArchetypeFromId(
+                                        ecs::getArchetype( archetypes[ i ].mask ) ) };
+            forEachIdRun( a, [&file]( const id::id_type* ids, uint32_t count )
+            {
+                file.write( ids, count * sizeof( id::id_type ) );
+            } );
+            file.align();
+
+            for ( ecs::component_type type{ 0 }; type < componentCount; type++ )
+            {
+                if ( !a.hasComponent( type ) )
+                {
+                    continue;
+                }
+                const uint32_t size{ ecs::getComponentDesc( type ).size };
+                for ( uint32_t c{ 0 }; c < a.getChunkCount(); c++ )
+                {
+                    file.write( a.getColumn( c, type ), a.getChunkSize( c ) * size );
+                }
+                file.align();
+            }
+        }
+
+        return file.close();
+    }
+
+    bool loadSnapshot( const char* path )
+    {
+        assert( path );
+        // NOTE(klek): Loading into a world that has entities would mix
+        //             up the ids of both
+        assert( !transform::getTransformCount() );
+        if ( transform::getTransformCount() )
+        {
+            return false;
+        }
+
+        const mapped_file file{ path };
+        const uint8_t* base{ file.data() };
+        if ( !base || file.size() < sizeof( snapshot_header ) )
+        {
+            return false;
+        }
+
+        if ( !isSnapshotValid( base, file.size() ) )
+        {
+            return false;
+        }
+        const snapshot_header& header{ *(const snapshot_header*)base };
+
+        // Map the saved component types to the registered ones
+        ecs::component_type typeMap[ ecs::max_component_types ];
+        const component_record* components{
+            (const component_record*)( base + header.componentsOffset ) };
+        const uint32_t registered{ ecs::getComponentTypeCount() };
+        for ( uint32_t i{ 0 }; i < header.componentCount; i++ )
+        {
+            typeMap[ i ] = ecs::invalid_component_type;
+            for ( ecs::component_type type{ 0 }; type < registered; type++ )
+            {
+                const ecs::component_desc& desc{ ecs::getComponentDesc( type ) };
+                if ( desc.size == components[ i ].size &&
+                     !strncmp( desc.name, components[ i ].name, max_name_length ) )
+                {
+                    typeMap[ i ] = type;
+                    break;
+                }
+            }
+            if ( typeMap[ i ] == ecs::invalid_component_type )
+            {
+                return false;
+            }
+        }
+
+        // Same for the tag types
+        ecs::tag_type tagMap[ ecs::max_tag_types ];
+        const tag_record* tagTypes{ (const tag_record*)( base + header.tagTypesOffset ) };
+        const uint32_t registeredTags{ ecs::getTagTypeCount() };
+        for ( uint32_t i{ 0 }; i < header.tagTypeCount; i++ )
+        {
+            tagMap[ i ] = ecs::max_tag_types;
+            for ( ecs::tag_type type{ 0 }; type < registeredTags; type++ )
+            {
+                if ( !strncmp( ecs::getTagName( type ), tagTypes[ i ].name, max_name_length ) )
+                {
+                    tagMap[ i ] = type;
+                    break;
+                }
+            }
+            if ( tagMap[ i ] == ecs::max_tag_types )
+            {
+                return false;
+            }
+        }
+
+        // Restore the generations and the free ids straight from the
+        // mapped file
+        detail::getIdAllocator().restore(
+            { (const id::generation_type*)( base + header.generationsOffset ),
+              header.indexCount },
+            { (const id::id_type*)( base + header.freeIdsOffset ),
+              header.freeIdCount } );
+
+        const archetype_record* archetypes{
+            (const archetype_record*)( base + header.archetypesOffset ) };
+        for ( uint32_t i{ 0 }; i < header.archetypeCount; i++ )
+        {
+            const archetype_record& record{ archetypes[ i ] };
+            ecs::component_mask mask{ 0 };
+            for ( uint32_t type{ 0 }; type < header.componentCount; type++ )
+            {
+                if ( ( record.mask >> type ) & 1 )
+                {
+                    mask |= ecs::component_mask{ 1 } << typeMap[ type ];
+                }
+            }
+
+            // Adding the entities in one go gives them contiguous rows,
+            // so each column is copied in one memcpy per chunk
+            const utils::span<const id::id_type> ids{
+                (const id::id_type*)( base + record.idsOffset ), record.count };
+            ecs::addEntities( ids, mask );
+            const ecs::entity_location first{ ecs::getLocation( ids[ 0 ] ) };
+            const ecs::archetype& a{ ecs::getArchetypeFromId( first.archetype ) };
+            const uint32_t capacity{ a.getChunkCapacity() };
+
+            for ( uint32_t type{ 0 }; type < header.componentCount; type++ )
+            {
+                if ( !( ( record.mask >> type ) & 1 ) )
+                {
+                    continue;
+                }
+                const uint32_t size{ components[ type ].size };
+                const uint8_t* src{ base + record.columnOffsets[ type ] };
+                uint32_t row{ first.row };
+                uint64_t remaining{ record.count };
+                while ( remaining )
+                {
+                    const uint32_t count{ (uint32_t)std::min<uint64_t>(
+                                            capacity - row % capacity, remaining ) };
+                    memcpy( a.getComponent( row, typeMap[ type ] ), src, count * size );
+                    src += count * size;
+                    row += count;
+                    remaining -= count;
+                }
+            }
+
+            transform::detail::addNodes( ids, {} );
+        }
+
+        // Tags are loaded once the entities are in the storage, and are
+        // limited to them, so a free index never starts out tagged
+        const utils::bitset& occupancy{ ecs::getOccupancy() };
+        const uint64_t tagWords{ tagWordCount( header.indexCount ) };
+        for ( uint32_t i{ 0 }; i < header.tagTypeCount; i++ )
+        {
+            const uint64_t* words{ (const uint64_t*)( base + header.tagsOffset ) + i * tagWords };
+            utils::bitset& bits{ ecs::detail::getTagBits( tagMap[ i ] ) };
+            if ( bits.size() < occupancy.size() )
+            {
+                bits.resize( occupancy.size() );
+            }
+            const uint64_t count{ std::min( tagWords, occupancy.wordCount() ) };
+            for ( uint64_t w{ 0 }; w < count; w++ )
+            {
+                bits.words()[ w ] = words[ w ] & occupancy.words()[ w ];
+            }
+        }
+
+        // Names were checked to be unique, so none of them is refused
+        const name_record* names{ (const name_record*)( base + header.namesOffset ) };
+        const char* nameText{ (const char*)( base + header.nameTextOffset ) };
+        for ( uint64_t i{ 0 }; i < header.nameCount; i++ )
+        {
+            const bool named{ setName( entity{ entity_id{ names[ i ].id } },
+                                       std::string_view{ nameText + names[ i ].textOffset,
+                                                         names[ i ].length } ) };
+            assert( named );
+            (void)named;
+        }
+
+        // Every transform exists now, so the parents can be set in any
+        // order
+        const parent_record* parents{
+            (const parent_record*)( base + header.parentsOffset ) };
+        for ( uint64_t i{ 0 }; i < header.parentCount; i++ )
+        {
+            transform::setParent( transform::component{ transform::transform_id{ parents[ i ].child } },
+                                  transform::component{ transform::transform_id{ parents[ i ].parent } } );
+        }
+
+        return true;
+    }
+} // namespace muggy::game_entity
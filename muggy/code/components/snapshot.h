@@ -0,0 +1,42 @@
+//********************************************************************
+//  File:    snapshot.h
+//  Date:    Sat, 17 Oct 2026: 22:05
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(SNAPSHOT_H)
+#define SNAPSHOT_H
+
+#include "componentsCommon.h"
+
+namespace muggy::game_entity
+{
+    // Current version of the snapshot file format
+    constexpr uint32_t snapshot_version{ 3 };
+
+    // Writes all entities to a binary snapshot. This contains the id
+    // generations, the free ids, the transform hierarchy, the tags, the
+    // entity names and every component column of every archetype.
+    // NOTE(klek): Command buffers must be flushed before saving, since
+    //             entities that are only reserved are saved as free
+    bool saveSnapshot( const char* path );
+
+    // Loads a snapshot written by saveSnapshot() into an empty world.
+    // The file is memory mapped, but the chunks are not used in place:
+    // every column is copied into newly allocated chunks, with one
+    // memcpy per chunk, so there are no pointers to fix up. All
+    // component and tag types in the snapshot must be registered
+    // before loading, ie componentType<T>() and tagType<T>() must have
+    // been called for them.
+    // Returns false if the file can't be used, which includes files
+    // with sections that don't fit in the file, ids that are stored
+    // twice or stored and free, stale ids, parents that form a cycle
+    // and names that are used twice or belong to free ids. Those are
+    // rejected before anything is loaded
+    bool loadSnapshot( const char* path );
+} // namespace muggy::game_entity
+
+
+#endif
@@ -0,0 +1,224 @@
+//********************************************************************
+//  File:    spatialSort.cpp
+//  Date:    Sun, 18 Oct 2026: 10:20
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "transform.h"
+#include "entity.h"
+#include "world.h"
+#include <algorithm>
+
+namespace muggy::ecs::detail
+{
+    // State of the pass in progress. "order" holds the entities of the
+    // current archetype in the order they should end up in, and rows
+    // before "cursor" have already been placed
+    struct spatial_state
+    {
+        utils::vector<id::id_type>  order;
+        ecs::archetype_id           current{ ecs::invalid_archetype };
+        ecs::archetype_id           next{ 0 };
+        uint32_t                    cursor{ 0 };
+    };
+
+    spatial_state* createSpatialState()
+    {
+        return new spatial_state{};
+    }
+
+    void destroyState( spatial_state* state )
+    {
+        delete state;
+    }
+} // namespace muggy::ecs::detail
+
+namespace muggy::transform
+{
+    namespace
+    {
+        // Number of bits per axis in a 64-bit Morton code
+        constexpr uint32_t morton_bits{ 21 };
+        constexpr uint32_t morton_max{ ( 1u << morton_bits ) - 1 };
+
+        // Spreads the lower 21 bits of v so that there are two zero
+        // bits between each of them
+        constexpr uint64_t spreadBits( uint64_t v )
+        {
+            v &= morton_max;
+            v = ( v | v << 32 ) & 0x001f00000000ffffull;
+            v = ( v | v << 16 ) & 0x001f0000ff0000ffull;
+            v = ( v | v <<  8 ) & 0x100f00f00f00f00full;
+            v = ( v | v <<  4 ) & 0x10c30c30c30c30c3ull;
+            v = ( v | v <<  2 ) & 0x1249249249249249ull;
+            return v;
+        }
+
+        constexpr uint64_t mortonCode( uint32_t x, uint32_t y, uint32_t z )
+        {
+            return spreadBits( x ) | ( spreadBits( y ) << 1 ) | ( spreadBits( z ) << 2 );
+        }
+
+        static_assert( mortonCode( 1, 0, 0 ) == 1 && mortonCode( 0, 1, 0 ) == 2 &&
+                       mortonCode( 0, 0, 1 ) == 4 && mortonCode( 3, 3, 3 ) == 63 );
+        static_assert( mortonCode( morton_max, morton_max, morton_max ) ==
+                       ( ~0ull >> 1 ) );
+
+        struct sort_key
+        {
+            uint64_t    code;
+            id::id_type id;
+        };
+
+        // Computes the Morton order of the archetype. Returns false if
+        // the rows are already in order, in which case there is nothing
+        // to do
+        bool plan( ecs::detail::spatial_state& pass, ecs::archetype_id id )
+        {
+            const ecs::archetype& a{ ecs::getArchetypeFromId( id ) };
+            const uint32_t size{ a.getSize() };
+            const uint32_t chunkCount{ a.getChunkCount() };
+
+            // The codes are relative to the bounds of this archetype
+            math::fv3d lo{ a.getColumn<position>( 0 )[ 0 ] };
+            math::fv3d hi{ lo };
+            for ( uint32_t c{ 0 }; c < chunkCount; c++ )
+            {
+                const math::fv3d *const positions{ a.getColumn<position>( c ) };
+                const uint32_t count{ a.getChunkSize( c ) };
+                for ( uint32_t i{ 0 }; i < count; i++ )
+                {
+                    lo.x = std::min( lo.x, positions[ i ].x );
+                    lo.y = std::min( lo.y, positions[ i ].y );
+                    lo.z = std::min( lo.z, positions[ i ].z );
+                    hi.x = std::max( hi.x, positions[ i ].x );
+                    hi.y = std::max( hi.y, positions[ i ].y );
+                    hi.z = std::max( hi.z, positions[ i ].z );
+                }
+            }
+
+            const float extent{ std::max( { hi.x - lo.x, hi.y - lo.y, hi.z - lo.z,
+                                            1e-6f } ) };
+            const float quantize{ (float)morton_max / extent };
+
+            utils::vector<sort_key> keys( size );
+            bool sorted{ true };
+            uint32_t row{ 0 };
+            for ( uint32_t c{ 0 }; c < chunkCount; c++ )
+            {
+                const id::id_type *const ids{ a.getEntities( c ) };
+                const math::fv3d *const positions{ a.getColumn<position>( c ) };
+                const uint32_t count{ a.getChunkSize( c ) };
+                for ( uint32_t i{ 0 }; i < count; i++, row++ )
+                {
+                    const math::fv3d& p{ positions[ i ] };
+                    keys[ row ].code = mortonCode(
+                        (uint32_t)std::min( ( p.x - lo.x ) * quantize, (float)morton_max ),
+                        (uint32_t)std::min( ( p.y - lo.y ) * quantize, (float)morton_max ),
+                        (uint32_t)std::min( ( p.z - lo.z ) * quantize, (float)morton_max ) );
+                    keys[ row ].id = ids[ i ];
+                    sorted = sorted && ( !row || keys[ row - 1 ].code <= keys[ row ].code );
+                }
+            }
+
+            if ( sorted )
+            {
+                return false;
+            }
+
+            std::stable_sort( keys.begin(), keys.end(),
+                              []( const sort_key& l, const sort_key& r )
+                              {
+                                  return l.code < r.code;
+                              } );
+            pass.order.resize( size );
+            for ( uint32_t i{ 0 }; i < size; i++ )
+            {
+                pass.order[ i ] = keys[ i ].id;
+            }
+            pass.current = id;
+            pass.cursor = 0;
+            return true;
+        }
+
+        // Moves entities from "order" into place, starting at the cursor.
+        // Entities can be added, removed or moved to other archetypes
+        // between steps, those that aren't found where expected are just
+        // skipped and picked up by the next pass
+        uint32_t place( ecs::detail::spatial_state& pass, uint32_t maxRows )
+        {
+            const ecs::archetype& a{ ecs::getArchetypeFromId( pass.current ) };
+            const uint32_t capacity{ a.getChunkCapacity() };
+            const uint32_t end{ std::min( (uint32_t)pass.order.size(), a.getSize() ) };
+            uint32_t placed{ 0 };
+            while ( pass.cursor < end && placed < maxRows )
+            {
+                const id::id_type id{ pass.order[ pass.cursor ] };
+                if ( ecs::hasEntity( id ) )
+                {
+                    const ecs::entity_location location{ ecs::getLocation( id ) };
+                    // The index may have been reused for another entity
+                    if ( location.archetype == pass.current && location.row > pass.cursor &&
+                         a.getEntities( location.row / capacity )
+                            [ location.row % capacity ] == id )
+                    {
+                        ecs::swapRows( pass.current, pass.cursor, location.row );
+                    }
+                }
+                pass.cursor++;
+                placed++;
+            }
+
+            if ( pass.cursor >= end )
+            {
+                pass.current = ecs::invalid_archetype;
+                pass.order.clear();
+            }
+            return placed;
+        }
+    } // namespace anonymous
+
+    bool spatialSortStep( uint32_t maxRows )
+    {
+        assert( maxRows );
+        std::lock_guard<std::mutex> lock{ game_entity::detail::getStorageMutex() };
+        ecs::detail::spatial_state& pass{ ecs::getCurrentWorld().getSpatialState() };
+        const ecs::component_mask mask{ ecs::componentMask<position>() };
+        uint32_t budget{ maxRows };
+        while ( budget )
+        {
+            if ( pass.current != ecs::invalid_archetype )
+            {
+                budget -= place( pass, budget );
+                continue;
+            }
+
+            if ( pass.next >= ecs::getArchetypeCount() )
+            {
+                pass.next = 0;
+                return true;
+            }
+
+            const ecs::archetype& a{ ecs::getArchetypeFromId( pass.next ) };
+            if ( ( a.getMask() & mask ) != mask || a.getSize() < 2 )
+            {
+                pass.next++;
+                continue;
+            }
+
+            // NOTE(klek): Planning touches every row of the archetype,
+            //             so leave a large archetype for the next call
+            //             if part of the budget has already been spent
+            if ( budget < maxRows && a.getSize() > budget )
+            {
+                break;
+            }
+            budget -= std::min( budget, a.getSize() );
+            plan( pass, pass.next++ );
+        }
+
+        return false;
+    }
+} // namespace muggy::transform
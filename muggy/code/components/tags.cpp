@@ -0,0 +1,253 @@
+//********************************************************************
+//  File:    tags.cpp
+//  Date:    Tue, 20 Oct 2026: 09:40
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "tags.h"
+#include "archetype.h"
+#include "world.h"
+#include <atomic>
+#include <mutex>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define USE_SSE_TAGS        1
+#include <emmintrin.h>
+#else
+#define USE_SSE_TAGS        0
+#endif
+
+namespace muggy::ecs::detail
+{
+    struct tag_state
+    {
+        // Indexed by tag type, each is indexed by entity index. They
+        // may be shorter than the storage, missing bits are cleared
+        utils::bitset   tags[ max_tag_types ];
+    };
+
+    tag_state* createTagState()
+    {
+        return new tag_state{};
+    }
+
+    void destroyState( tag_state* state )
+    {
+        delete state;
+    }
+} // namespace muggy::ecs::detail
+
+namespace muggy::ecs
+{
+    namespace
+    {
+        // The tag types are shared by all worlds
+        const char*             tagNames[ max_tag_types ];
+        std::atomic<uint32_t>   tagCount{ 0 };
+        std::mutex              tagMutex;
+
+        // Words filtered per pass, small enough that the block stays
+        // in L1 while every tag is applied to it
+        constexpr uint32_t      block_words{ 512 };
+
+        detail::tag_state& getTagState()
+        {
+            return getCurrentWorld().getTagState();
+        }
+
+        // dst &= src
+        void andWords( uint64_t* dst, const uint64_t* src, uint32_t count )
+        {
+            uint32_t i{ 0 };
+#if USE_SSE_TAGS
+            for ( ; i + 2 <= count; i += 2 )
+            {
+                const __m128i d{ _mm_loadu_si128( (const __m128i*)( dst + i ) ) };
+                const __m128i s{ _mm_loadu_si128( (const __m128i*)( src + i ) ) };
+                _mm_storeu_si128( (__m128i*)( dst + i ), _mm_and_si128( d, s ) );
+            }
+#endif
+            for ( ; i < count; i++ )
+            {
+                dst[ i ] &= src[ i ];
+            }
+        }
+
+        // dst &= ~src
+        void andNotWords( uint64_t* dst, const uint64_t* src, uint32_t count )
+        {
+            uint32_t i{ 0 };
+#if USE_SSE_TAGS
+            for ( ; i + 2 <= count; i += 2 )
+            {
+                const __m128i d{ _mm_loadu_si128( (const __m128i*)( dst + i ) ) };
+                const __m128i s{ _mm_loadu_si128( (const __m128i*)( src + i ) ) };
+                _mm_storeu_si128( (__m128i*)( dst + i ), _mm_andnot_si128( s, d ) );
+            }
+#endif
+            for ( ; i < count; i++ )
+            {
+                dst[ i ] &= ~src[ i ];
+            }
+        }
+
+        // Makes the bitsets of the tags in the mask at least as large
+        // as the storage, so blocks can be read without bounds checks
+        void coverStorage( detail::tag_state& state, tag_mask tags, uint64_t size )
+        {
+            for ( ; tags; tags &= tags - 1 )
+            {
+                utils::bitset& bits{ state.tags[ utils::countTrailingZeros( tags ) ] };
+                if ( bits.size() < size )
+                {
+                    bits.resize( size );
+                }
+            }
+        }
+
+        // Filters words [first, first + count) of the storage into "out"
+        // and returns the number of bits set
+        uint32_t filterBlock( const detail::tag_state& state, const uint64_t* occupancy,
+                              uint64_t first, uint32_t count, 
+                              tag_mask all, tag_mask none, uint64_t* out )
+        {
+            memcpy( out, occupancy + first, count * sizeof( uint64_t ) );
+            for ( ; all; all &= all - 1 )
+            {
+                andWords( out, state.tags[ utils::countTrailingZeros( all ) ].words() + first,
+                          count );
+            }
+            for ( ; none; none &= none - 1 )
+            {
+                andNotWords( out, state.tags[ utils::countTrailingZeros( none ) ].words() + first,
+                             count );
+            }
+
+            uint32_t total{ 0 };
+            for ( uint32_t i{ 0 }; i < count; i++ )
+            {
+                total += utils::popCount( out[ i ] );
+            }
+            return total;
+        }
+    } // namespace anonymous
+
+    tag_type registerTagType( const char* name )
+    {
+        std::lock_guard<std::mutex> lock{ tagMutex };
+        const tag_type type{ tagCount.load( std::memory_order_relaxed ) };
+        // If this assert hits, the tag mask has to be widened
+        assert( type < max_tag_types );
+        tagNames[ type ] = name;
+        tagCount.store( type + 1, std::memory_order_release );
+        return type;
+    }
+
+    const char* getTagName( tag_type type )
+    {
+        assert( type < tagCount.load( std::memory_order_acquire ) );
+        return tagNames[ type ];
+    }
+
+    uint32_t getTagTypeCount()
+    {
+        return tagCount.load( std::memory_order_acquire );
+    }
+
+    void setTags( id::id_type id, tag_mask tags )
+    {
+        detail::tag_state& state{ getTagState() };
+        const id::id_type index{ id::index( id ) };
+        const uint32_t count{ getTagTypeCount() };
+        for ( tag_type type{ 0 }; type < count; type++ )
+        {
+            utils::bitset& bits{ state.tags[ type ] };
+            if ( ( tags >> type ) & 1 )
+            {
+                if ( index >= bits.size() )
+                {
+                    // Grow by doubling, a resize reallocates the words
+                    bits.resize( std::max( (uint64_t)index + 1, bits.size() * 2 ) );
+                }
+                bits.set( index );
+            }
+            else if ( index < bits.size() )
+            {
+                bits.reset( index );
+            }
+        }
+    }
+
+    void addTags( id::id_type id, tag_mask tags )
+    {
+        setTags( id, getTags( id ) | tags );
+    }
+
+    void removeTags( id::id_type id, tag_mask tags )
+    {
+        setTags( id, getTags( id ) & ~tags );
+    }
+
+    tag_mask getTags( id::id_type id )
+    {
+        const detail::tag_state& state{ getTagState() };
+        const id::id_type index{ id::index( id ) };
+        const uint32_t count{ getTagTypeCount() };
+        tag_mask tags{ 0 };
+        for ( tag_type type{ 0 }; type < count; type++ )
+        {
+            const utils::bitset& bits{ state.tags[ type ] };
+            if ( index < bits.size() && bits.test( index ) )
+            {
+                tags |= tag_mask{ 1 } << type;
+            }
+        }
+        return tags;
+    }
+
+    uint32_t filterTags( tag_mask all, tag_mask none, utils::bitset& result )
+    {
+        detail::tag_state& state{ getTagState() };
+        const utils::bitset& occupancy{ getOccupancy() };
+        coverStorage( state, all | none, occupancy.size() );
+        result.resize( occupancy.size() );
+
+        const uint64_t wordCount{ occupancy.wordCount() };
+        uint32_t total{ 0 };
+        for ( uint64_t first{ 0 }; first < wordCount; first += block_words )
+        {
+            const uint32_t count{ (uint32_t)std::min<uint64_t>( block_words, wordCount - first ) };
+            total += filterBlock( state, occupancy.words(), first, count, all, none,
+                                  result.words() + first );
+        }
+        return total;
+    }
+
+    uint32_t countTagged( tag_mask all, tag_mask none )
+    {
+        detail::tag_state& state{ getTagState() };
+        const utils::bitset& occupancy{ getOccupancy() };
+        coverStorage( state, all | none, occupancy.size() );
+
+        const uint64_t wordCount{ occupancy.wordCount() };
+        uint64_t block[ block_words ];
+        uint32_t total{ 0 };
+        for ( uint64_t first{ 0 }; first < wordCount; first += block_words )
+        {
+            const uint32_t count{ (uint32_t)std::min<uint64_t>( block_words, wordCount - first ) };
+            total += filterBlock( state, occupancy.words(), first, count, all, none, block );
+        }
+        return total;
+    }
+
+    namespace detail
+    {
+        utils::bitset& getTagBits( tag_type type )
+        {
+            assert( type < getTagTypeCount() );
+            return getTagState().tags[ type ];
+        }
+    } // namespace detail
+} // namespace muggy::ecs
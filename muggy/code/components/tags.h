@@ -0,0 +1,91 @@
+//********************************************************************
+//  File:    tags.h
+//  Date:    Tue, 20 Oct 2026: 09:15
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TAGS_H)
+#define TAGS_H
+
+#include "componentsCommon.h"
+#include "../utilities/bitset.h"
+
+namespace muggy::ecs
+{
+    // Tag masks are 64-bit, so this is the maximum number of tag types
+    // that can be registered
+    constexpr uint32_t max_tag_types{ 64 };
+
+    using tag_type = uint32_t;
+    using tag_mask = uint64_t;
+
+    // Tags are components without data. Instead of a column in the
+    // chunks, every tag is a bitset indexed by entity index, so tagging
+    // doesn't move entities between archetypes and filtering is done
+    // on whole words of bits
+    tag_type registerTagType( const char* name );
+    const char* getTagName( tag_type type );
+    // Number of tag types registered so far
+    uint32_t getTagTypeCount();
+
+    // Returns the tag type for T, registering it on first use. T is
+    // an empty struct that only names the tag, eg struct enemy {};
+    template <typename T>
+    tag_type tagType()
+    {
+        static_assert( std::is_empty<T>::value, "Tags can't hold data" );
+        static const tag_type type{ registerTagType( typeid( T ).name() ) };
+        return type;
+    }
+
+    template <typename... T>
+    tag_mask tagMask()
+    {
+        return ( tag_mask{ 0 } | ... | ( tag_mask{ 1 } << tagType<T>() ) );
+    }
+
+    // Replaces all tags of the entity
+    void setTags( id::id_type id, tag_mask tags );
+    void addTags( id::id_type id, tag_mask tags );
+    void removeTags( id::id_type id, tag_mask tags );
+    [[nodiscard]] tag_mask getTags( id::id_type id );
+
+    template <typename T>
+    void addTag( id::id_type id )
+    {
+        addTags( id, tagMask<T>() );
+    }
+
+    template <typename T>
+    void removeTag( id::id_type id )
+    {
+        removeTags( id, tagMask<T>() );
+    }
+
+    template <typename T>
+    [[nodiscard]] bool hasTag( id::id_type id )
+    {
+        return getTags( id ) & tagMask<T>();
+    }
+
+    // Sets bit i of "result" for every entity index i in the storage
+    // that has all tags of "all" and none of "none", and returns how
+    // many there are. Works a block of words at a time, with one AND
+    // (or ANDNOT) pass per tag and a final POPCNT pass
+    uint32_t filterTags( tag_mask all, tag_mask none, utils::bitset& result );
+    // Same as filterTags() but only counts
+    [[nodiscard]] uint32_t countTagged( tag_mask all, tag_mask none = 0 );
+
+    namespace detail
+    {
+        // The bitset of the tag in the current world, indexed by entity
+        // index. It may be shorter than the storage, the missing bits
+        // are cleared. Used to save and load the tags in snapshots
+        utils::bitset& getTagBits( tag_type type );
+    } // namespace detail
+} // namespace muggy::ecs
+
+
+#endif
@@ -8,66 +8,276 @@
 
 #include "transform.h"
 #include "entity.h"
+#include "hierarchy.h"
+#include "../math/mat4Batch.h"
+#include <algorithm>
 
 namespace muggy::transform
 {
     namespace
     {
-        utils::vector<math::fv3d>             positions;
-        utils::vector<math::fv4d>             rotations;
-        utils::vector<math::fv3d>             scales;
+        // Calls func( archetype, row, index, count ) for each run of
+        // entities that are stored in consecutive rows of one chunk,
+        // where "index" is the position of the run in "entities"
+        template <typename F>
+        void forEachRun( utils::span<const game_entity::entity> entities, F&& func )
+        {
+            const uint32_t count{ (uint32_t)entities.size() };
+            uint32_t i{ 0 };
+            while ( i < count )
+            {
+                // DEBUG: Check that the entity is valid
+                assert( entities[ i ].isValid() );
+                const ecs::entity_location first{ ecs::getLocation( entities[ i ].getId() ) };
+                ecs::archetype& a{ ecs::getArchetypeFromId( first.archetype ) };
+                const uint32_t maxRun{ std::min( a.getChunkCapacity() - 
+                                                 first.row % a.getChunkCapacity(),
+                                                 count - i ) };
+                uint32_t run{ 1 };
+                while ( run < maxRun )
+                {
+                    const ecs::entity_location& next{ 
+                        ecs::getLocation( entities[ i + run ].getId() ) };
+                    if ( next.archetype != first.archetype || next.row != first.row + run )
+                    {
+                        break;
+                    }
+                    run++;
+                }
+
+                func( a, first.row, i, run );
+                i += run;
+            }
+        }
+
+        template <typename T>
+        void getColumnValues( utils::span<const game_entity::entity> entities,
+                              ecs::component_value_t<T>* values )
+        {
+            const ecs::component_type type{ ecs::componentType<T>() };
+            forEachRun( entities, 
+                [values, type]( ecs::archetype& a, uint32_t row, uint32_t i, uint32_t count )
+                {
+                    std::copy_n( (const ecs::component_value_t<T>*)a.getComponent( row, type ),
+                                 count, values + i );
+                } );
+        }
+
+        template <typename T>
+        void setColumnValues( utils::span<const game_entity::entity> entities,
+                              const ecs::component_value_t<T>* values )
+        {
+            const ecs::component_type type{ ecs::componentType<T>() };
+            forEachRun( entities, 
+                [values, type]( ecs::archetype& a, uint32_t row, uint32_t i, uint32_t count )
+                {
+                    a.markChanged( row, count, type );
+                    std::copy_n( values + i, count, 
+                                 (ecs::component_value_t<T>*)a.getComponent( row, type ) );
+                } );
+        }
     } // namespace anonymous
-    
+
     component createTransform( const init_info& info, game_entity::entity e )
     {
         // DEBUG: Check that the entity is valid!
         assert( e.isValid() );
-        const id::id_type e_index{ id::index( e.getId() ) };
+        const id::id_type id{ e.getId() };
+
+        // The entity must already have been placed in an archetype
+        // containing the transform columns
+        assert( ecs::hasEntity( id ) );
+        assert( ( ecs::getArchetypeFromId( ecs::getLocation( id ).archetype ).getMask() & 
+                  getComponentMask() ) == getComponentMask() );
+
+        new ( ecs::getComponent<position>( id ) ) math::fv3d( info.position );
+        new ( ecs::getComponent<rotation>( id ) ) math::fv4d( info.rotation );
+        new ( ecs::getComponent<scale>( id ) ) math::fv3d( info.scale );
+        detail::addNode( id, info.parent.getId() );
 
-        // Check if we should reuse slots or create new slots
-        if ( positions.size() > e_index )
+        // NOTE(klek): The transform shares id with its entity, the
+        //             actual storage row is looked up through the 
+        //             entity location
+        return component( transform_id{ id } );
+    }
+
+    void createTransforms( utils::span<const game_entity::entity_info> infos,
+                           utils::span<const game_entity::entity> entities )
+    {
+        assert( infos.size() == entities.size() );
+        if ( entities.empty() )
         {
-            // Reusing available slots
-            positions[ e_index ] = math::fv3d( info.position );
-            rotations[ e_index ] = math::fv4d( info.rotation );
-            scales[ e_index ] = math::fv3d( info.scale );
+            return;
         }
-        else 
+
+        const uint32_t count{ (uint32_t)entities.size() };
+        const ecs::entity_location first{ ecs::getLocation( entities[ 0 ].getId() ) };
+        ecs::archetype& a{ ecs::getArchetypeFromId( first.archetype ) };
+        assert( ( a.getMask() & getComponentMask() ) == getComponentMask() );
+        const uint32_t capacity{ a.getChunkCapacity() };
+
+        // Fill the columns one chunk at a time, so the column pointers
+        // are only looked up once per chunk instead of once per entity
+        uint32_t row{ first.row };
+        uint32_t i{ 0 };
+        while ( i < count )
         {
-            // Add new slots
-            assert( positions.size() == e_index );
-            positions.emplace_back( info.position );
-            rotations.emplace_back( info.rotation );
-            scales.emplace_back( info.scale );
+            const uint32_t chunk{ row / capacity };
+            const uint32_t slot{ row % capacity };
+            const uint32_t run{ std::min( capacity - slot, count - i ) };
+            math::fv3d *const positions{ a.getColumn<position>( chunk ) + slot };
+            math::fv4d *const rotations{ a.getColumn<rotation>( chunk ) + slot };
+            math::fv3d *const scales{ a.getColumn<scale>( chunk ) + slot };
+
+            for ( uint32_t j{ 0 }; j < run; j++ )
+            {
+                const init_info& info{ *infos[ i + j ].transform };
+                // DEBUG: Check that the entities really are contiguous
+                assert( ecs::getLocation( entities[ i + j ].getId() ).row == row + j );
+                new ( positions + j ) math::fv3d( info.position );
+                new ( rotations + j ) math::fv4d( info.rotation );
+                new ( scales + j ) math::fv3d( info.scale );
+            }
+
+            row += run;
+            i += run;
         }
 
-        return component( transform_id{ (id::id_type)positions.size() - 1 } );
+        utils::vector<id::id_type> ids( count );
+        utils::vector<id::id_type> parents( count );
+        for ( uint32_t i{ 0 }; i < count; i++ )
+        {
+            ids[ i ] = entities[ i ].getId();
+            parents[ i ] = infos[ i ].transform->parent.getId();
+        }
+        detail::addNodes( ids, parents );
     }
 
     void removeTransform( component c )
     {
         assert( c.isValid() );
+        detail::removeNode( c.getId() );
+        // NOTE(klek): The transform columns are released together with
+        //             the entity row in the chunk storage
+    }
+
+    ecs::component_mask getComponentMask()
+    {
+        static const ecs::component_mask mask{ 
+            ecs::componentMask<position, rotation, scale>() };
+        return mask;
+    }
+
+    uint32_t getTransformCount()
+    {
+        uint32_t count{ 0 };
+        ecs::forEachChunk( getComponentMask(), 
+            [&count]( ecs::archetype&, uint32_t, uint32_t chunkCount )
+            {
+                count += chunkCount;
+            } );
+        return count;
+    }
+
+    uint32_t buildLocalMatrices( utils::span<math::fmat4> matrices )
+    {
+        uint32_t written{ 0 };
+        forEachTransform( 
+            [&]( const id::id_type*, const math::fv3d* positions, 
+                 const math::fv4d* rotations, const math::fv3d* scales, 
+                 uint32_t count )
+            {
+                // If this assert hits, the buffer is too small
+                assert( written + count <= matrices.size() );
+                math::buildTransformMatrices( positions, rotations, scales,
+                                              matrices.data() + written, count );
+                written += count;
+            } );
+        return written;
+    }
+
+    void getPositions( utils::span<const game_entity::entity> entities,
+                       utils::span<math::fv3d> positions )
+    {
+        assert( positions.size() == entities.size() );
+        getColumnValues<position>( entities, positions.data() );
+    }
+
+    void getRotations( utils::span<const game_entity::entity> entities,
+                       utils::span<math::fv4d> rotations )
+    {
+        assert( rotations.size() == entities.size() );
+        getColumnValues<rotation>( entities, rotations.data() );
+    }
+
+    void getScales( utils::span<const game_entity::entity> entities,
+                    utils::span<math::fv3d> scales )
+    {
+        assert( scales.size() == entities.size() );
+        getColumnValues<scale>( entities, scales.data() );
+    }
+
+    void setPositions( utils::span<const game_entity::entity> entities,
+                       utils::span<const math::fv3d> positions )
+    {
+        assert( positions.size() == entities.size() );
+        setColumnValues<position>( entities, positions.data() );
+    }
+
+    void setRotations( utils::span<const game_entity::entity> entities,
+                       utils::span<const math::fv4d> rotations )
+    {
+        assert( rotations.size() == entities.size() );
+        setColumnValues<rotation>( entities, rotations.data() );
+    }
+
+    void setScales( utils::span<const game_entity::entity> entities,
+                    utils::span<const math::fv3d> scales )
+    {
+        assert( scales.size() == entities.size() );
+        setColumnValues<scale>( entities, scales.data() );
     }
 
     math::fv3d component::getPosition() const
     {
         // DEBUG: Check that this component is valid
         assert( isValid() );
-        return positions[ id::index( m_Id )];
+        return *ecs::getComponent<position>( m_Id );
     }
 
     math::fv4d component::getRotation() const
     {
         // DEBUG: Check that this component is valid
         assert( isValid() );
-        return rotations[ id::index( m_Id )];
+        return *ecs::getComponent<rotation>( m_Id );
     }
 
     math::fv3d component::getScale() const
     {
         // DEBUG: Check that this component is valid
         assert( isValid() );
-        return scales[ id::index( m_Id )];
+        return *ecs::getComponent<scale>( m_Id );
+    }
+
+    void component::setPosition( const math::fv3d& p ) const
+    {
+        // DEBUG: Check that this component is valid
+        assert( isValid() );
+        *ecs::writeComponent<position>( m_Id ) = p;
+    }
+
+    void component::setRotation( const math::fv4d& r ) const
+    {
+        // DEBUG: Check that this component is valid
+        assert( isValid() );
+        *ecs::writeComponent<rotation>( m_Id ) = r;
+    }
+
+    void component::setScale( const math::fv3d& s ) const
+    {
+        // DEBUG: Check that this component is valid
+        assert( isValid() );
+        *ecs::writeComponent<scale>( m_Id ) = s;
     }
 
 } // namespace muggy::transform
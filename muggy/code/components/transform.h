@@ -10,9 +10,38 @@
 #define TRANSFORM_H
 
 #include "componentsCommon.h"
+#include "archetype.h"
+
+namespace muggy
+{
+    // ***************************************************************
+    // Forward declaration of the entity info
+    namespace game_entity
+    {
+        struct entity_info;
+    } // namespace game_entity
+    // ***************************************************************
+} // namespace muggy
 
 namespace muggy::transform
 {
+    // Column types of the transform component. Each of them is stored
+    // in its own SoA column in the chunk storage
+    struct position
+    {
+        using column_type = math::fv3d;
+    };
+
+    struct rotation
+    {
+        using column_type = math::fv4d;
+    };
+
+    struct scale
+    {
+        using column_type = math::fv3d;
+    };
+
     struct init_info
     {
         // Position in x, y, z
@@ -21,11 +50,128 @@ namespace muggy::transform
         float rotation[4]{ };
         // Scale in x, y, z
         float scale[3]{ 1.0f, 1.0f, 1.0f };
+        // Parent transform, invalid for root transforms
+        component parent{ };
     };
 
     component createTransform( const init_info& info, 
                                game_entity::entity entity );
     void removeTransform( component c );
+
+    // Initializes the transforms of entities that were added to the
+    // storage together, ie that occupy contiguous rows
+    void createTransforms( utils::span<const game_entity::entity_info> infos,
+                           utils::span<const game_entity::entity> entities );
+
+    // Returns the mask of the columns that make up a transform, ie
+    // what every entity archetype must contain
+    ecs::component_mask getComponentMask();
+
+    // Attaches the child to the parent, or detaches it if the parent
+    // is invalid. Local position, rotation and scale of the child are
+    // relative to the parent. Returns false and leaves the hierarchy
+    // as it was if the parent is the child or one of its descendants,
+    // since that would make a cycle
+    bool setParent( component child, component parent );
+    component getParent( component child );
+
+    // Recomputes the world matrices of all transforms that changed 
+    // since the last update, together with their children
+    void updateWorldMatrices();
+
+    // Returns the number of transforms currently stored
+    uint32_t getTransformCount();
+
+    // Builds the local translation * rotation * scale matrix of every
+    // stored transform into "matrices", in the same order as
+    // forEachTransform() visits them. Returns the number of matrices
+    // written, which is getTransformCount()
+    uint32_t buildLocalMatrices( utils::span<math::fmat4> matrices );
+
+    // Reorders the transform storage by the Morton code of the 
+    // position, so entities that are close in space are also close in
+    // memory. The pass is incremental: each call plans or reorders at
+    // most about "maxRows" rows, so it can run a little every frame.
+    // Returns true when a full pass over all archetypes has finished.
+    // Entity ids are not affected, only the rows they are stored in
+    bool spatialSortStep( uint32_t maxRows );
+
+    // Copies the local position, rotation or scale of every entity into
+    // the output span, which must be as large as "entities". Entities
+    // stored in consecutive rows are copied in a single run
+    void getPositions( utils::span<const game_entity::entity> entities,
+                       utils::span<math::fv3d> positions );
+    void getRotations( utils::span<const game_entity::entity> entities,
+                       utils::span<math::fv4d> rotations );
+    void getScales( utils::span<const game_entity::entity> entities,
+                    utils::span<math::fv3d> scales );
+
+    // Writes the local position, rotation or scale of every entity from
+    // the input span and marks them as changed, so their world matrices
+    // are updated in the next updateWorldMatrices()
+    void setPositions( utils::span<const game_entity::entity> entities,
+                       utils::span<const math::fv3d> positions );
+    void setRotations( utils::span<const game_entity::entity> entities,
+                       utils::span<const math::fv4d> rotations );
+    void setScales( utils::span<const game_entity::entity> entities,
+                    utils::span<const math::fv3d> scales );
+
+    // Transforms of two consecutive captured ticks, with the rows of
+    // both ticks matched by entity. Entities that didn't exist in the
+    // previous tick hold their current values in both
+    struct interpolation_frame
+    {
+        utils::vector<id::id_type>  ids;
+        utils::vector<math::fv3d>   previousPositions;
+        utils::vector<math::fv4d>   previousRotations;
+        utils::vector<math::fv3d>   previousScales;
+        utils::vector<math::fv3d>   positions;
+        utils::vector<math::fv4d>   rotations;
+        utils::vector<math::fv3d>   scales;
+        // Number of captures up to and including this one
+        uint64_t                    tick{ 0 };
+    };
+
+    // Copies the transform columns of the current world at the end of
+    // a fixed simulation tick and publishes them, together with the
+    // previous capture, to the render thread. Must be called by the
+    // thread that simulates the world. Nothing is captured until this
+    // is first called, so worlds that aren't rendered pay nothing
+    void captureTransforms();
+
+    // Returns the latest published frame of the current world, or 
+    // nullptr if nothing was captured yet. Meant for a single render
+    // thread per world: the frame stays unchanged until the next call
+    // on that thread, and the simulation never waits for it
+    const interpolation_frame* acquireInterpolationFrame();
+
+    // Interpolates rows [first, first + size) of the frame between the
+    // previous and the current tick, where t goes from 0 to 1. Positions
+    // and scales are lerped and rotations nlerped with SIMD batches
+    void interpolateTransforms( const interpolation_frame& frame, float t,
+                                uint32_t first,
+                                utils::span<math::fv3d> positions,
+                                utils::span<math::fv4d> rotations,
+                                utils::span<math::fv3d> scales );
+
+    // Calls func( entities, positions, rotations, scales, count ) with
+    // the densely packed transform columns of each storage chunk.
+    // The columns are read-only, to write them directly use
+    // ecs::view<position>().eachChunkWrite<position>(), which marks the
+    // chunks as changed
+    template <typename F>
+    void forEachTransform( F&& func )
+    {
+        ecs::forEachChunk( getComponentMask(), 
+            [&func]( ecs::archetype& a, uint32_t chunk, uint32_t count )
+            {
+                func( (const id::id_type*)a.getEntities( chunk ),
+                      (const math::fv3d*)a.getColumn<position>( chunk ),
+                      (const math::fv4d*)a.getColumn<rotation>( chunk ),
+                      (const math::fv3d*)a.getColumn<scale>( chunk ),
+                      count );
+            } );
+    }
 } // namespace muggy::transform
 
 
@@ -0,0 +1,72 @@
+//********************************************************************
+//  File:    world.cpp
+//  Date:    Sun, 18 Oct 2026: 16:35
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "world.h"
+#include <atomic>
+
+namespace muggy::ecs
+{
+    namespace
+    {
+        std::atomic<uint64_t>   nextSerial{ 1 };
+        // nullptr means the default world
+        thread_local world*     currentWorld{ nullptr };
+    } // namespace anonymous
+
+    world::world()
+     :
+        m_Serial( nextSerial.fetch_add( 1, std::memory_order_relaxed ) )
+    {
+        m_Observers = detail::createObserverState();
+        m_Storage = detail::createStorageState();
+        m_Registry = detail::createRegistryState();
+        m_Names = detail::createNameState();
+        m_Tags = detail::createTagState();
+        m_Hierarchy = detail::createHierarchyState();
+        m_Pools = detail::createPoolState();
+        m_Spatial = detail::createSpatialState();
+        m_Commands = detail::createCommandState();
+        m_Interpolation = detail::createInterpolationState();
+    }
+
+    world::~world()
+    {
+        // DEBUG: Check that the world isn't destroyed while in use
+        assert( currentWorld != this );
+        // Reverse order of creation, the command buffers may still hold
+        // reserved ids and the pools refer to entities in the storage
+        detail::destroyState( m_Interpolation );
+        detail::destroyState( m_Commands );
+        detail::destroyState( m_Spatial );
+        detail::destroyState( m_Pools );
+        detail::destroyState( m_Hierarchy );
+        detail::destroyState( m_Tags );
+        detail::destroyState( m_Names );
+        detail::destroyState( m_Registry );
+        detail::destroyState( m_Storage );
+        detail::destroyState( m_Observers );
+    }
+
+    world& getDefaultWorld()
+    {
+        static world defaultWorld;
+        return defaultWorld;
+    }
+
+    world& getCurrentWorld()
+    {
+        return currentWorld ? *currentWorld : getDefaultWorld();
+    }
+
+    world* setCurrentWorld( world* w )
+    {
+        world *const previous{ currentWorld };
+        currentWorld = ( w == &getDefaultWorld() ) ? nullptr : w;
+        return previous;
+    }
+} // namespace muggy::ecs
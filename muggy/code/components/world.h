@@ -0,0 +1,135 @@
+//********************************************************************
+//  File:    world.h
+//  Date:    Sun, 18 Oct 2026: 16:10
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(WORLD_H)
+#define WORLD_H
+
+#include "componentsCommon.h"
+
+namespace muggy::ecs
+{
+    // NOTE(klek): Every module keeps its state in the world. The state
+    //             types are only defined in the .cpp of the module that
+    //             uses them, which also creates and destroys them
+    namespace detail
+    {
+        struct storage_state;       // archetype.cpp
+        struct registry_state;      // entity.cpp
+        struct hierarchy_state;     // hierarchy.cpp
+        struct pool_state;          // componentPool.cpp
+        struct spatial_state;       // spatialSort.cpp
+        struct command_state;       // commandBuffer.cpp
+        struct interpolation_state; // interpolation.cpp
+        struct observer_state;      // observer.cpp
+        struct name_state;          // names.cpp
+        struct tag_state;           // tags.cpp
+
+        storage_state* createStorageState();
+        registry_state* createRegistryState();
+        hierarchy_state* createHierarchyState();
+        pool_state* createPoolState();
+        spatial_state* createSpatialState();
+        command_state* createCommandState();
+        interpolation_state* createInterpolationState();
+        observer_state* createObserverState();
+        name_state* createNameState();
+        tag_state* createTagState();
+
+        void destroyState( storage_state* state );
+        void destroyState( registry_state* state );
+        void destroyState( hierarchy_state* state );
+        void destroyState( pool_state* state );
+        void destroyState( spatial_state* state );
+        void destroyState( command_state* state );
+        void destroyState( interpolation_state* state );
+        void destroyState( observer_state* state );
+        void destroyState( name_state* state );
+        void destroyState( tag_state* state );
+    } // namespace detail
+
+    // Owns the entities of one simulation: the id allocator, the chunk
+    // storage, the transform hierarchy, the component pools, the
+    // command buffers, the entity observers, names and tags, and the
+    // transforms captured for rendering.
+    // The game_entity, transform and ecs functions work on the world
+    // bound to the calling thread, so independent worlds can be 
+    // updated in parallel, one per thread.
+    // Component types and prefabs are shared by all worlds
+    class world
+    {
+    public:
+        world();
+        ~world();
+
+        world( const world& ) = delete;
+        world& operator=( const world& ) = delete;
+
+        // Unique for every world ever created, unlike the address
+        [[nodiscard]] constexpr uint64_t getSerial() const
+        {
+            return m_Serial;
+        }
+
+        [[nodiscard]] detail::storage_state& getStorageState() const { return *m_Storage; }
+        [[nodiscard]] detail::registry_state& getRegistryState() const { return *m_Registry; }
+        [[nodiscard]] detail::hierarchy_state& getHierarchyState() const { return *m_Hierarchy; }
+        [[nodiscard]] detail::pool_state& getPoolState() const { return *m_Pools; }
+        [[nodiscard]] detail::spatial_state& getSpatialState() const { return *m_Spatial; }
+        [[nodiscard]] detail::command_state& getCommandState() const { return *m_Commands; }
+        [[nodiscard]] detail::interpolation_state& getInterpolationState() const { return *m_Interpolation; }
+        [[nodiscard]] detail::observer_state& getObserverState() const { return *m_Observers; }
+        [[nodiscard]] detail::name_state& getNameState() const { return *m_Names; }
+        [[nodiscard]] detail::tag_state& getTagState() const { return *m_Tags; }
+
+    private:
+        uint64_t                        m_Serial{ 0 };
+        detail::storage_state*          m_Storage{ nullptr };
+        detail::registry_state*         m_Registry{ nullptr };
+        detail::hierarchy_state*        m_Hierarchy{ nullptr };
+        detail::pool_state*             m_Pools{ nullptr };
+        detail::spatial_state*          m_Spatial{ nullptr };
+        detail::command_state*          m_Commands{ nullptr };
+        detail::interpolation_state*    m_Interpolation{ nullptr };
+        detail::observer_state*         m_Observers{ nullptr };
+        detail::name_state*             m_Names{ nullptr };
+        detail::tag_state*              m_Tags{ nullptr };
+    };
+
+    // The world used by threads that never bound one. It lives until
+    // the program ends
+    world& getDefaultWorld();
+    // Returns the world bound to the calling thread
+    world& getCurrentWorld();
+    // Binds the world to the calling thread, nullptr binds the default
+    // world. Returns the previously bound world
+    world* setCurrentWorld( world* w );
+
+    // Binds a world to the calling thread for the lifetime of the scope
+    class world_scope
+    {
+    public:
+        explicit world_scope( world& w )
+         :
+            m_Previous( setCurrentWorld( &w ) )
+        {}
+
+        ~world_scope()
+        {
+            setCurrentWorld( m_Previous );
+        }
+
+        world_scope( const world_scope& ) = delete;
+        world_scope& operator=( const world_scope& ) = delete;
+
+    private:
+        world*  m_Previous{ nullptr };
+    };
+} // namespace muggy::ecs
+
+
+#endif
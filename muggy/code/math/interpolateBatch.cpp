@@ -0,0 +1,128 @@
+//********************************************************************
+//  File:    interpolateBatch.cpp
+//  Date:    Mon, 19 Oct 2026: 09:52
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "interpolateBatch.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define USE_SSE_INTERPOLATE_BATCH   1
+#include <xmmintrin.h>
+#else
+#define USE_SSE_INTERPOLATE_BATCH   0
+#endif
+
+namespace muggy::math
+{
+    // Vectors are stored as packed floats, which the loads below rely on
+    static_assert( sizeof( fv3d ) == 3 * sizeof( float ) );
+    static_assert( sizeof( fv4d ) == 4 * sizeof( float ) );
+
+    void lerpVectors( const fv3d* from, const fv3d* to, float t,
+                      fv3d* out, uint32_t count )
+    {
+        assert( ( from && to && out ) || !count );
+        const float *const a{ (const float*)from };
+        const float *const b{ (const float*)to };
+        float *const r{ (float*)out };
+        const uint32_t floatCount{ count * 3 };
+        uint32_t i{ 0 };
+
+#if USE_SSE_INTERPOLATE_BATCH
+        const __m128 tt{ _mm_set1_ps( t ) };
+        for ( ; i + 4 <= floatCount; i += 4 )
+        {
+            const __m128 va{ _mm_loadu_ps( a + i ) };
+            const __m128 vb{ _mm_loadu_ps( b + i ) };
+            _mm_storeu_ps( r + i, _mm_add_ps( va, _mm_mul_ps( _mm_sub_ps( vb, va ), tt ) ) );
+        }
+#endif
+
+        // Scalar path for the remainder, or everything when SSE is not
+        // available
+        for ( ; i < floatCount; i++ )
+        {
+            r[ i ] = a[ i ] + ( b[ i ] - a[ i ] ) * t;
+        }
+    }
+
+    void nlerpQuaternions( const fv4d* from, const fv4d* to, float t,
+                           fv4d* out, uint32_t count )
+    {
+        assert( ( from && to && out ) || !count );
+        uint32_t i{ 0 };
+
+#if USE_SSE_INTERPOLATE_BATCH
+        const __m128 tt{ _mm_set1_ps( t ) };
+        const __m128 one{ _mm_set1_ps( 1.0f ) };
+        const __m128 signBit{ _mm_set1_ps( -0.0f ) };
+
+        for ( ; i + 4 <= count; i += 4 )
+        {
+            __m128 ax{ _mm_loadu_ps( (const float*)( from + i + 0 ) ) };
+            __m128 ay{ _mm_loadu_ps( (const float*)( from + i + 1 ) ) };
+            __m128 az{ _mm_loadu_ps( (const float*)( from + i + 2 ) ) };
+            __m128 aw{ _mm_loadu_ps( (const float*)( from + i + 3 ) ) };
+            _MM_TRANSPOSE4_PS( ax, ay, az, aw );
+            __m128 bx{ _mm_loadu_ps( (const float*)( to + i + 0 ) ) };
+            __m128 by{ _mm_loadu_ps( (const float*)( to + i + 1 ) ) };
+            __m128 bz{ _mm_loadu_ps( (const float*)( to + i + 2 ) ) };
+            __m128 bw{ _mm_loadu_ps( (const float*)( to + i + 3 ) ) };
+            _MM_TRANSPOSE4_PS( bx, by, bz, bw );
+
+            // Flip "to" when the quaternions are more than 90 degrees
+            // apart, so we take the shorter arc. Done by copying the
+            // sign of the dot product onto every component
+            const __m128 dot{ _mm_add_ps( _mm_add_ps( _mm_mul_ps( ax, bx ), _mm_mul_ps( ay, by ) ),
+                                          _mm_add_ps( _mm_mul_ps( az, bz ), _mm_mul_ps( aw, bw ) ) ) };
+            const __m128 sign{ _mm_and_ps( dot, signBit ) };
+            bx = _mm_xor_ps( bx, sign );
+            by = _mm_xor_ps( by, sign );
+            bz = _mm_xor_ps( bz, sign );
+            bw = _mm_xor_ps( bw, sign );
+
+            __m128 rx{ _mm_add_ps( ax, _mm_mul_ps( _mm_sub_ps( bx, ax ), tt ) ) };
+            __m128 ry{ _mm_add_ps( ay, _mm_mul_ps( _mm_sub_ps( by, ay ), tt ) ) };
+            __m128 rz{ _mm_add_ps( az, _mm_mul_ps( _mm_sub_ps( bz, az ), tt ) ) };
+            __m128 rw{ _mm_add_ps( aw, _mm_mul_ps( _mm_sub_ps( bw, aw ), tt ) ) };
+
+            // NOTE(klek): A full precision square root and division,
+            //             _mm_rsqrt_ps is only good for 12 bits which
+            //             shows up as wobble on large objects
+            const __m128 lengthSq{ _mm_add_ps( _mm_add_ps( _mm_mul_ps( rx, rx ), _mm_mul_ps( ry, ry ) ),
+                                               _mm_add_ps( _mm_mul_ps( rz, rz ), _mm_mul_ps( rw, rw ) ) ) };
+            const __m128 invLength{ _mm_div_ps( one, _mm_sqrt_ps( lengthSq ) ) };
+            rx = _mm_mul_ps( rx, invLength );
+            ry = _mm_mul_ps( ry, invLength );
+            rz = _mm_mul_ps( rz, invLength );
+            rw = _mm_mul_ps( rw, invLength );
+
+            _MM_TRANSPOSE4_PS( rx, ry, rz, rw );
+            _mm_storeu_ps( (float*)( out + i + 0 ), rx );
+            _mm_storeu_ps( (float*)( out + i + 1 ), ry );
+            _mm_storeu_ps( (float*)( out + i + 2 ), rz );
+            _mm_storeu_ps( (float*)( out + i + 3 ), rw );
+        }
+#endif
+
+        // Scalar path for the remainder, or everything when SSE is not
+        // available
+        for ( ; i < count; i++ )
+        {
+            const fv4d& a{ from[ i ] };
+            const fv4d& b{ to[ i ] };
+            const float dot{ a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w };
+            const float sign{ dot < 0.0f ? -1.0f : 1.0f };
+            const float x{ a.x + ( b.x * sign - a.x ) * t };
+            const float y{ a.y + ( b.y * sign - a.y ) * t };
+            const float z{ a.z + ( b.z * sign - a.z ) * t };
+            const float w{ a.w + ( b.w * sign - a.w ) * t };
+            const float invLength{ 1.0f / std::sqrt( x * x + y * y + z * z + w * w ) };
+            out[ i ] = fv4d{ x * invLength, y * invLength, z * invLength, w * invLength };
+        }
+    }
+} // namespace muggy::math
@@ -0,0 +1,31 @@
+//********************************************************************
+//  File:    interpolateBatch.h
+//  Date:    Mon, 19 Oct 2026: 09:40
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(INTERPOLATE_BATCH_H)
+#define INTERPOLATE_BATCH_H
+
+#include "../common/common.h"
+
+namespace muggy::math
+{
+    // Writes from + ( to - from ) * t for "count" vectors. The vectors
+    // are processed as one packed float stream, four floats at a time
+    // with SSE when available
+    void lerpVectors( const fv3d* from, const fv3d* to, float t,
+                      fv3d* out, uint32_t count );
+
+    // Interpolates "count" unit quaternions along the shorter arc and
+    // normalizes the result (nlerp). For the small angles between two
+    // simulation ticks this is visually the same as slerp, without the
+    // trigonometry. Four quaternions at a time with SSE when available
+    void nlerpQuaternions( const fv4d* from, const fv4d* to, float t,
+                           fv4d* out, uint32_t count );
+} // namespace muggy::math
+
+
+#endif
@@ -0,0 +1,133 @@
+//********************************************************************
+//  File:    mat4Batch.cpp
+//  Date:    Sat, 17 Oct 2026: 14:11
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "mat4Batch.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define USE_SSE_MAT4_BATCH      1
+#include <xmmintrin.h>
+#else
+#define USE_SSE_MAT4_BATCH      0
+#endif
+
+namespace muggy::math
+{
+    // Vectors are stored as packed floats, which the loads below rely on
+    static_assert( sizeof( fv3d ) == 3 * sizeof( float ) );
+    static_assert( sizeof( fv4d ) == 4 * sizeof( float ) );
+    static_assert( sizeof( fmat4 ) == 16 * sizeof( float ) );
+
+#if USE_SSE_MAT4_BATCH
+    namespace
+    {
+        // Loads four packed vec3s and splits them into one register
+        // per component, ie from x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+        // into x0 x1 x2 x3 | y0 y1 y2 y3 | z0 z1 z2 z3
+        inline void loadVec3x4( const fv3d* v, __m128& x, __m128& y, __m128& z )
+        {
+            const float *const f{ (const float*)v };
+            const __m128 a{ _mm_loadu_ps( f ) };
+            const __m128 b{ _mm_loadu_ps( f + 4 ) };
+            const __m128 c{ _mm_loadu_ps( f + 8 ) };
+
+            const __m128 bc{ _mm_shuffle_ps( b, c, _MM_SHUFFLE( 0, 1, 0, 2 ) ) };
+            x = _mm_shuffle_ps( a, bc, _MM_SHUFFLE( 2, 0, 3, 0 ) );
+
+            const __m128 ab1{ _mm_shuffle_ps( a, b, _MM_SHUFFLE( 0, 0, 1, 1 ) ) };
+            const __m128 bc1{ _mm_shuffle_ps( b, c, _MM_SHUFFLE( 2, 2, 3, 3 ) ) };
+            y = _mm_shuffle_ps( ab1, bc1, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+
+            const __m128 ab2{ _mm_shuffle_ps( a, b, _MM_SHUFFLE( 1, 1, 2, 2 ) ) };
+            const __m128 cc{ _mm_shuffle_ps( c, c, _MM_SHUFFLE( 3, 3, 0, 0 ) ) };
+            z = _mm_shuffle_ps( ab2, cc, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+        }
+
+        // Transposes the four component registers of one matrix column
+        // and stores that column in four consecutive matrices
+        inline void storeColumnx4( float* out, uint32_t column,
+                                   __m128 r0, __m128 r1, __m128 r2, __m128 r3 )
+        {
+            _MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+            _mm_storeu_ps( out + 0 * 16 + column * 4, r0 );
+            _mm_storeu_ps( out + 1 * 16 + column * 4, r1 );
+            _mm_storeu_ps( out + 2 * 16 + column * 4, r2 );
+            _mm_storeu_ps( out + 3 * 16 + column * 4, r3 );
+        }
+    } // namespace anonymous
+#endif
+
+    void buildTransformMatrices( const fv3d* positions,
+                                 const fv4d* rotations,
+                                 const fv3d* scales,
+                                 fmat4* matrices,
+                                 uint32_t count )
+    {
+        assert( ( positions && rotations && scales && matrices ) || !count );
+        uint32_t i{ 0 };
+
+#if USE_SSE_MAT4_BATCH
+        const __m128 zero{ _mm_setzero_ps() };
+        const __m128 one{ _mm_set1_ps( 1.0f ) };
+        const __m128 two{ _mm_set1_ps( 2.0f ) };
+
+        for ( ; i + 4 <= count; i += 4 )
+        {
+            __m128 tx, ty, tz;
+            __m128 sx, sy, sz;
+            loadVec3x4( positions + i, tx, ty, tz );
+            loadVec3x4( scales + i, sx, sy, sz );
+
+            // Quaternions are already 4 wide, so a transpose gives us
+            // one register per component
+            __m128 qx{ _mm_loadu_ps( (const float*)( rotations + i + 0 ) ) };
+            __m128 qy{ _mm_loadu_ps( (const float*)( rotations + i + 1 ) ) };
+            __m128 qz{ _mm_loadu_ps( (const float*)( rotations + i + 2 ) ) };
+            __m128 qw{ _mm_loadu_ps( (const float*)( rotations + i + 3 ) ) };
+            _MM_TRANSPOSE4_PS( qx, qy, qz, qw );
+
+            const __m128 xx{ _mm_mul_ps( qx, qx ) };
+            const __m128 yy{ _mm_mul_ps( qy, qy ) };
+            const __m128 zz{ _mm_mul_ps( qz, qz ) };
+            const __m128 xy{ _mm_mul_ps( qx, qy ) };
+            const __m128 xz{ _mm_mul_ps( qx, qz ) };
+            const __m128 yz{ _mm_mul_ps( qy, qz ) };
+            const __m128 xw{ _mm_mul_ps( qx, qw ) };
+            const __m128 yw{ _mm_mul_ps( qy, qw ) };
+            const __m128 zw{ _mm_mul_ps( qz, qw ) };
+
+            // Same layout as in mat4Template::transformation()
+            const __m128 m00{ _mm_mul_ps( _mm_sub_ps( one, _mm_mul_ps( two, _mm_add_ps( yy, zz ) ) ), sx ) };
+            const __m128 m10{ _mm_mul_ps( _mm_mul_ps( two, _mm_add_ps( xy, zw ) ), sx ) };
+            const __m128 m20{ _mm_mul_ps( _mm_mul_ps( two, _mm_sub_ps( xz, yw ) ), sx ) };
+
+            const __m128 m01{ _mm_mul_ps( _mm_mul_ps( two, _mm_sub_ps( xy, zw ) ), sy ) };
+            const __m128 m11{ _mm_mul_ps( _mm_sub_ps( one, _mm_mul_ps( two, _mm_add_ps( xx, zz ) ) ), sy ) };
+            const __m128 m21{ _mm_mul_ps( _mm_mul_ps( two, _mm_add_ps( yz, xw ) ), sy ) };
+
+            const __m128 m02{ _mm_mul_ps( _mm_mul_ps( two, _mm_add_ps( xz, yw ) ), sz ) };
+            const __m128 m12{ _mm_mul_ps( _mm_mul_ps( two, _mm_sub_ps( yz, xw ) ), sz ) };
+            const __m128 m22{ _mm_mul_ps( _mm_sub_ps( one, _mm_mul_ps( two, _mm_add_ps( xx, yy ) ) ), sz ) };
+
+            float *const out{ matrices[ i ].elements };
+            storeColumnx4( out, 0, m00, m10, m20, zero );
+            storeColumnx4( out, 1, m01, m11, m21, zero );
+            storeColumnx4( out, 2, m02, m12, m22, zero );
+            storeColumnx4( out, 3, tx, ty, tz, one );
+        }
+#endif
+
+        // Scalar path for the remainder, or everything when SSE is not
+        // available
+        for ( ; i < count; i++ )
+        {
+            matrices[ i ] = fmat4::transformation( positions[ i ], 
+                                                   rotations[ i ], 
+                                                   scales[ i ] );
+        }
+    }
+} // namespace muggy::math
@@ -0,0 +1,31 @@
+//********************************************************************
+//  File:    mat4Batch.h
+//  Date:    Sat, 17 Oct 2026: 14:05
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(MAT_4_BATCH_H)
+#define MAT_4_BATCH_H
+
+#include "../common/common.h"
+
+namespace muggy::math
+{
+    // Builds translation * rotation * scale matrices for "count" 
+    // transforms, reading from separate position, rotation (normalized
+    // quaternion) and scale streams and writing the matrices to a
+    // contiguous buffer.
+    // Gives the same result as calling fmat4::transformation() per
+    // transform, but processes four transforms at a time with SSE
+    // when available
+    void buildTransformMatrices( const fv3d* positions,
+                                 const fv4d* rotations,
+                                 const fv3d* scales,
+                                 fmat4* matrices,
+                                 uint32_t count );
+} // namespace muggy::math
+
+
+#endif
@@ -36,15 +36,6 @@ namespace muggy::math
         elements[ 4 * 3 + 3 ] = diagonal;
     }
 
-    template <typename T>
-    mat4Template<T>::mat4Template( const mat4Template<T>& m ) 
-    {
-        for ( int i = 0; i < FOUR_BY_FOUR; i++ )
-        {
-            this->elements[ i ] = m.elements[ i ];
-        }
-    }
-
     template <typename T>
     vec4dTemplate<T> mat4Template<T>::getColumn( int index )
     {
@@ -341,6 +332,24 @@ namespace muggy::math
         return result;
     }
 
+    // Calculate the rotation matrix for a given
+    // - Quaternion (vec4d) as x, y, z, w
+    // The quaternion is expected to be normalized
+    // The matrix looks like:
+    //
+    //    1-2(yy+zz)  2(xy-zw)    2(xz+yw)    0
+    //    2(xy+zw)    1-2(xx+zz)  2(yz-xw)    0
+    //    2(xz-yw)    2(yz+xw)    1-2(xx+yy)  0
+    //    0           0           0           1
+    //
+    template <typename T>
+    mat4Template<T> mat4Template<T>::rotation( const vec4dTemplate<T>& q )
+    {
+        return transformation( vec3dTemplate<T>( ), 
+                               q, 
+                               vec3dTemplate<T>( T( 1 ), T( 1 ), T( 1 ) ) );
+    }
+
     // Calculate the scale matrix for a given:
     // - Scale (vec3d)
     // The scale matrix is basically an identity matrix with the
@@ -365,6 +374,57 @@ namespace muggy::math
         return result;
     }
 
+    // Calculate the combined transformation matrix for a given:
+    // - Translation (vec3d)
+    // - Rotation (vec4d), a normalized quaternion
+    // - Scale (vec3d)
+    // This is the same as translation( t ) * rotation( q ) * scale( s )
+    // but is built directly instead of doing two matrix multiplications.
+    // Each of the first three columns is a column of the rotation
+    // matrix multiplied by the corresponding scale, the last column
+    // holds the translation:
+    //
+    //    R00*s.x  R01*s.y  R02*s.z  t.x
+    //    R10*s.x  R11*s.y  R12*s.z  t.y
+    //    R20*s.x  R21*s.y  R22*s.z  t.z
+    //    0        0        0        1
+    //
+    template <typename T>
+    mat4Template<T> mat4Template<T>::transformation( const vec3dTemplate<T>& t,
+                                                     const vec4dTemplate<T>& q,
+                                                     const vec3dTemplate<T>& s )
+    {
+        mat4Template<T> result( T( 1.0f ) );
+
+        const T xx = q.x * q.x;
+        const T yy = q.y * q.y;
+        const T zz = q.z * q.z;
+        const T xy = q.x * q.y;
+        const T xz = q.x * q.z;
+        const T yz = q.y * q.z;
+        const T xw = q.x * q.w;
+        const T yw = q.y * q.w;
+        const T zw = q.z * q.w;
+
+        result.elements[ 4 * 0 + 0 ] = ( T( 1 ) - T( 2 ) * ( yy + zz ) ) * s.x;
+        result.elements[ 4 * 0 + 1 ] = ( T( 2 ) * ( xy + zw ) ) * s.x;
+        result.elements[ 4 * 0 + 2 ] = ( T( 2 ) * ( xz - yw ) ) * s.x;
+
+        result.elements[ 4 * 1 + 0 ] = ( T( 2 ) * ( xy - zw ) ) * s.y;
+        result.elements[ 4 * 1 + 1 ] = ( T( 1 ) - T( 2 ) * ( xx + zz ) ) * s.y;
+        result.elements[ 4 * 1 + 2 ] = ( T( 2 ) * ( yz + xw ) ) * s.y;
+
+        result.elements[ 4 * 2 + 0 ] = ( T( 2 ) * ( xz + yw ) ) * s.z;
+        result.elements[ 4 * 2 + 1 ] = ( T( 2 ) * ( yz - xw ) ) * s.z;
+        result.elements[ 4 * 2 + 2 ] = ( T( 1 ) - T( 2 ) * ( xx + yy ) ) * s.z;
+
+        result.elements[ 4 * 3 + 0 ] = t.x;
+        result.elements[ 4 * 3 + 1 ] = t.y;
+        result.elements[ 4 * 3 + 2 ] = t.z;
+
+        return result;
+    }
+
     // Output operators, overloaded
     template <typename T>
     std::ostream& operator<<(std::ostream &stream, const mat4Template<T>& m)
@@ -45,7 +45,7 @@ namespace muggy::math
         // Constructors
         mat4Template();
         mat4Template( T diagonal );
-        mat4Template( const mat4Type& m );
+        mat4Template( const mat4Type& ) = default;
 
         // Member functions
         // Support for getting elements
@@ -97,9 +97,18 @@ namespace muggy::math
         // Rotation matrix
         static mat4Type rotation( vType angle, const vec3Type& axis );
 
+        // Rotation matrix from a quaternion (x, y, z, w)
+        static mat4Type rotation( const vec4Type& quaternion );
+
         // Scale matrix
         static mat4Type scale(const vec3Type& scale);
 
+        // Combined translation * rotation * scale matrix, where the
+        // rotation is a quaternion
+        static mat4Type transformation( const vec3Type& translation,
+                                        const vec4Type& rotation,
+                                        const vec3Type& scale );
+
         // Output operators, overloaded
         template <typename Y>
         friend std::ostream& operator<<(std::ostream &stream, const mat4Template<Y>& m);
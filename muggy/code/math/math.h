@@ -85,6 +85,13 @@ namespace muggy::math
     typedef i32v4d                      RECT;
     typedef i32v3d                      TRIANGLE;
     typedef i32v2d                      POINT;
+
+    // NOTE(klek): utils::vector moves trivially copyable items with
+    //             memcpy, which is what keeps large arrays of these fast
+    static_assert( std::is_trivially_copyable<fv3d>::value &&
+                   std::is_trivially_copyable<fv4d>::value &&
+                   std::is_trivially_copyable<fmat4>::value,
+                   "Math types must stay trivially copyable" );
     
 } // namespace muggy::math
 
@@ -26,13 +26,6 @@ namespace muggy::math
         y( _y )
     {}
 
-    template <typename T>
-    vec2dTemplate<T>::vec2dTemplate( const vec2dTemplate<T>& _v )
-     : 
-        x( _v.x ),
-        y( _v.y )
-    {}
-
     template <typename T>
     vec2dTemplate<T>::vec2dTemplate( const T (&_arr)[2] )
      : 
@@ -30,14 +30,6 @@ namespace muggy::math
         z( _z )
     {}
 
-    template <typename T>
-    vec3dTemplate<T>::vec3dTemplate( const vec3dTemplate<T>& _v )
-     : 
-        x( _v.x ),
-        y( _v.y ),
-        z( _v.z )
-    {}
-
     template <typename T>
     vec3dTemplate<T>::vec3dTemplate( const T (&_arr)[3] )
      : 
@@ -33,15 +33,6 @@ namespace muggy::math
         w( _w )
     {}
 
-    template <typename T>
-    vec4dTemplate<T>::vec4dTemplate( const vec4dTemplate<T>& _v )
-     : 
-        x( _v.x ),
-        y( _v.y ),
-        z( _v.z ),
-        w( _v.w )
-    {}
-
     template <typename T>
     vec4dTemplate<T>::vec4dTemplate( const T (&_arr)[4] )
      : 
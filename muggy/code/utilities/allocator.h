@@ -0,0 +1,111 @@
+//********************************************************************
+//  File:    allocator.h
+//  Date:    Tue, 20 Oct 2026: 16:20
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(ALLOCATOR_H)
+#define ALLOCATOR_H
+
+#include <stdint.h>
+#include <assert.h>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#if defined(_WIN64)
+#include <malloc.h>
+#endif
+
+namespace muggy::utils
+{
+    // Allocators decide where the memory of a utils::vector comes from
+    // and how it is aligned. An allocator has to provide:
+    //
+    //  static constexpr uint32_t alignment;
+    //  void* allocate( uint64_t size );
+    //  // Grows or shrinks the allocation to "size" bytes, preserving
+    //  // the first "used" bytes. Returns nullptr on failure, in which
+    //  // case the old allocation is left untouched
+    //  void* reallocate( void* data, uint64_t used, uint64_t size );
+    //  void deallocate( void* data );
+    //
+    // The vector keeps a copy of the allocator, so an allocator can
+    // refer to an arena. Allocators without members take no space.
+
+    // Allocates from the heap. Up to the alignment malloc guarantees,
+    // this uses realloc, which can often grow in place. Larger
+    // alignments, such as the 32 or 64 bytes wanted for AVX loads or
+    // cache lines, use aligned allocations.
+    template <uint32_t Alignment = alignof( std::max_align_t )>
+    class heap_allocator
+    {
+        static_assert( Alignment && !( Alignment & ( Alignment - 1 ) ),
+                       "Alignment must be a power of two" );
+
+    public:
+        static constexpr uint32_t alignment{ Alignment };
+
+        [[nodiscard]] void* allocate( uint64_t size )
+        {
+            return reallocate( nullptr, 0, size );
+        }
+
+        [[nodiscard]] void* reallocate( void* data, uint64_t used, uint64_t size )
+        {
+            assert( used <= size || !data );
+            if constexpr ( is_malloc_aligned )
+            {
+                (void)used;
+                return realloc( data, size );
+            }
+            else
+            {
+#if defined(_WIN64)
+                // NOTE(klek): _aligned_realloc() copies the contents itself
+                (void)used;
+                return _aligned_realloc( data, size, Alignment );
+#else
+                void* newData{ nullptr };
+                if ( posix_memalign( &newData, Alignment, size ) )
+                {
+                    return nullptr;
+                }
+                if ( data )
+                {
+                    memcpy( newData, data, used );
+                    free( data );
+                }
+                return newData;
+#endif
+            }
+        }
+
+        void deallocate( void* data )
+        {
+#if defined(_WIN64)
+            if constexpr ( !is_malloc_aligned )
+            {
+                _aligned_free( data );
+                return;
+            }
+#endif
+            // posix_memalign() memory is released with free() as well
+            free( data );
+        }
+
+    private:
+        static constexpr bool is_malloc_aligned{ Alignment <= alignof( std::max_align_t ) };
+    };
+
+    // The allocator vectors use unless told otherwise. It follows the
+    // alignment of the element type, so over-aligned types work
+    template <typename T>
+    using default_allocator = heap_allocator<( alignof( T ) > alignof( std::max_align_t ) )
+                                             ? (uint32_t)alignof( T )
+                                             : (uint32_t)alignof( std::max_align_t )>;
+} // namespace muggy::utils
+
+
+#endif
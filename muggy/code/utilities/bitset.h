@@ -0,0 +1,168 @@
+//********************************************************************
+//  File:    bitset.h
+//  Date:    Sat, 17 Oct 2026: 11:20
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(BITSET_H)
+#define BITSET_H
+
+#include "../common/common.h"
+#if defined(_WIN64)
+#include <intrin.h>
+#endif
+
+namespace muggy::utils
+{
+    // Index of the lowest set bit, "value" must not be zero
+    inline uint32_t countTrailingZeros( uint64_t value )
+    {
+        assert( value );
+#if defined(_WIN64)
+        unsigned long index;
+        _BitScanForward64( &index, value );
+        return (uint32_t)index;
+#else
+        return (uint32_t)__builtin_ctzll( value );
+#endif
+    }
+
+    // Number of set bits
+    inline uint32_t popCount( uint64_t value )
+    {
+#if defined(_WIN64)
+        return (uint32_t)__popcnt64( value );
+#else
+        return (uint32_t)__builtin_popcountll( value );
+#endif
+    }
+
+    // Dynamically sized set of bits, stored in 64-bit words so that
+    // users can scan 64 bits at a time
+    class bitset
+    {
+    public:
+        static constexpr uint32_t word_bits{ 64 };
+
+        bitset() = default;
+
+        explicit bitset( uint64_t size )
+        {
+            resize( size );
+        }
+
+        // Resizes the bitset, new bits are cleared
+        void resize( uint64_t size )
+        {
+            const uint64_t wordCount{ ( size + word_bits - 1 ) / word_bits };
+            if ( size < m_Size && wordCount )
+            {
+                // Clear the bits past the new size in the last word,
+                // so they're zero should the bitset grow again
+                const uint64_t used{ size % word_bits };
+                if ( used )
+                {
+                    m_Words[ wordCount - 1 ] &= ( uint64_t{ 1 } << used ) - 1;
+                }
+            }
+            m_Words.resize( wordCount, 0 );
+            m_Size = size;
+        }
+
+        constexpr void set( uint64_t index )
+        {
+            assert( index < m_Size );
+            m_Words[ index / word_bits ] |= ( uint64_t{ 1 } << ( index % word_bits ) );
+        }
+
+        constexpr void reset( uint64_t index )
+        {
+            assert( index < m_Size );
+            m_Words[ index / word_bits ] &= ~( uint64_t{ 1 } << ( index % word_bits ) );
+        }
+
+        [[nodiscard]] constexpr bool test( uint64_t index ) const
+        {
+            assert( index < m_Size );
+            return ( m_Words[ index / word_bits ] >> ( index % word_bits ) ) & 1;
+        }
+
+        // Clears all bits but keeps the size
+        void clearAll()
+        {
+            if ( !m_Words.empty() )
+            {
+                memset( m_Words.data(), 0, m_Words.size() * sizeof( uint64_t ) );
+            }
+        }
+
+        // Returns true if any bit is set
+        [[nodiscard]] bool any() const
+        {
+            for ( uint64_t i{ 0 }; i < m_Words.size(); i++ )
+            {
+                if ( m_Words[ i ] )
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Number of set bits
+        [[nodiscard]] uint64_t count() const
+        {
+            uint64_t total{ 0 };
+            for ( uint64_t i{ 0 }; i < m_Words.size(); i++ )
+            {
+                total += popCount( m_Words[ i ] );
+            }
+            return total;
+        }
+
+        // Calls func( index ) for every set bit in increasing order,
+        // skipping 64 cleared bits at a time
+        template <typename F>
+        void forEachSet( F&& func ) const
+        {
+            for ( uint64_t i{ 0 }; i < m_Words.size(); i++ )
+            {
+                for ( uint64_t bits{ m_Words[ i ] }; bits; bits &= bits - 1 )
+                {
+                    func( i * word_bits + countTrailingZeros( bits ) );
+                }
+            }
+        }
+
+        // Number of bits
+        [[nodiscard]] constexpr uint64_t size() const
+        {
+            return m_Size;
+        }
+
+        [[nodiscard]] constexpr uint64_t wordCount() const
+        {
+            return m_Words.size();
+        }
+
+        // Direct access to the words, bit i is stored in word i / 64
+        [[nodiscard]] constexpr uint64_t* words()
+        {
+            return m_Words.data();
+        }
+
+        [[nodiscard]] constexpr const uint64_t* words() const
+        {
+            return m_Words.data();
+        }
+
+    private:
+        utils::vector<uint64_t>     m_Words;
+        uint64_t                    m_Size{ 0 };
+    };
+} // namespace muggy::utils
+
+
+#endif
@@ -10,6 +10,7 @@
 #define FREELIST_H
 
 #include "../common/common.h"
+#include "allocator.h"
 #include <cstring>
 
 namespace muggy::utils
@@ -19,7 +20,9 @@ namespace muggy::utils
 #pragma message("WARNING: Using utils::free_list with std::vector results in duplicate calls to class destructor")
 #endif
 
-    template < typename T>
+    // The slots are stored in a utils::vector that gets its memory from
+    // Allocator, see allocator.h
+    template < typename T, typename Allocator = default_allocator<T>>
     class free_list
     {
         static_assert( sizeof(T) >= sizeof( uint32_t ));
@@ -32,6 +35,15 @@ namespace muggy::utils
             m_Array.reserve( count );
         }
 
+#if !USE_STL_VECTOR
+        explicit free_list( const Allocator& allocator, uint32_t count = 0 )
+         :
+            m_Array( allocator )
+        {
+            m_Array.reserve( count );
+        }
+#endif
+
         ~free_list()
         {
             assert(!m_Size);
@@ -149,12 +161,12 @@ namespace muggy::utils
             }
         }
 #if USE_STL_VECTOR
-        utils::vector<T>        m_Array;
+        utils::vector<T>                    m_Array;
 #else
-        utils::vector<T, false> m_Array;
+        utils::vector<T, false, Allocator>  m_Array;
 #endif
-        uint32_t                m_NextFreeIndex{ uint32_invalid_id };
-        uint32_t                m_Size{ 0 };
+        uint32_t                            m_NextFreeIndex{ uint32_invalid_id };
+        uint32_t                            m_Size{ 0 };
     };
 } // namespace muggy::utils
 
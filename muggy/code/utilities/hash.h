@@ -0,0 +1,36 @@
+//********************************************************************
+//  File:    hash.h
+//  Date:    Mon, 19 Oct 2026: 17:10
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(HASH_H)
+#define HASH_H
+
+#include "../common/common.h"
+#include <string_view>
+
+namespace muggy::utils
+{
+    // 64-bit FNV-1a. Being constexpr, hashes of string literals can be
+    // computed at compile time, eg
+    //      constexpr uint64_t h{ hashString( "player_spawn_03" ) };
+    constexpr uint64_t hashString( std::string_view s )
+    {
+        uint64_t hash{ 0xcbf29ce484222325ull };
+        for ( const char c : s )
+        {
+            hash ^= (uint8_t)c;
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    static_assert( hashString( "" ) == 0xcbf29ce484222325ull );
+    static_assert( hashString( "a" ) == 0xaf63dc4c8601ec8cull );
+} // namespace muggy::utils
+
+
+#endif
@@ -0,0 +1,141 @@
+//********************************************************************
+//  File:    mpmcQueue.h
+//  Date:    Sat, 17 Oct 2026: 18:40
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(MPMC_QUEUE_H)
+#define MPMC_QUEUE_H
+
+#include "../common/common.h"
+#include <atomic>
+
+namespace muggy::utils
+{
+    // Bounded multi-producer/multi-consumer FIFO queue without locks.
+    // Every cell has a sequence number telling producers and consumers
+    // whose turn it is, so pushing and popping only needs a single
+    // compare-exchange on the enqueue or dequeue position.
+    // The capacity must be a power of two and is fixed at construction
+    template <typename T>
+    class mpmc_queue
+    {
+        static_assert( std::is_trivially_copyable<T>::value,
+                       "Items must be trivially copyable" );
+
+    public:
+        explicit mpmc_queue( uint32_t capacity )
+         :
+            m_Cells( new cell[ capacity ] ),
+            m_Mask( capacity - 1 )
+        {
+            // If this assert hits, the capacity is not a power of two
+            assert( capacity >= 2 && ( capacity & ( capacity - 1 ) ) == 0 );
+            for ( uint32_t i{ 0 }; i < capacity; i++ )
+            {
+                m_Cells[ i ].sequence.store( i, std::memory_order_relaxed );
+            }
+        }
+
+        ~mpmc_queue()
+        {
+            delete[] m_Cells;
+        }
+
+        mpmc_queue( const mpmc_queue& ) = delete;
+        mpmc_queue& operator=( const mpmc_queue& ) = delete;
+
+        // Returns false if the queue is full
+        bool push( const T& item )
+        {
+            uint64_t pos{ m_EnqueuePos.load( std::memory_order_relaxed ) };
+            cell* c;
+            for ( ;; )
+            {
+                c = &m_Cells[ pos & m_Mask ];
+                const uint64_t seq{ c->sequence.load( std::memory_order_acquire ) };
+                const int64_t diff{ (int64_t)seq - (int64_t)pos };
+                if ( diff == 0 )
+                {
+                    // The cell is free, try to claim it
+                    if ( m_EnqueuePos.compare_exchange_weak( pos, pos + 1,
+                                                             std::memory_order_relaxed ) )
+                    {
+                        break;
+                    }
+                }
+                else if ( diff < 0 )
+                {
+                    // The cell still holds an item from the previous lap
+                    return false;
+                }
+                else
+                {
+                    pos = m_EnqueuePos.load( std::memory_order_relaxed );
+                }
+            }
+
+            c->item = item;
+            c->sequence.store( pos + 1, std::memory_order_release );
+            return true;
+        }
+
+        // Returns false if the queue is empty
+        bool pop( T& item )
+        {
+            uint64_t pos{ m_DequeuePos.load( std::memory_order_relaxed ) };
+            cell* c;
+            for ( ;; )
+            {
+                c = &m_Cells[ pos & m_Mask ];
+                const uint64_t seq{ c->sequence.load( std::memory_order_acquire ) };
+                const int64_t diff{ (int64_t)seq - (int64_t)( pos + 1 ) };
+                if ( diff == 0 )
+                {
+                    // The cell has an item, try to claim it
+                    if ( m_DequeuePos.compare_exchange_weak( pos, pos + 1,
+                                                             std::memory_order_relaxed ) )
+                    {
+                        break;
+                    }
+                }
+                else if ( diff < 0 )
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = m_DequeuePos.load( std::memory_order_relaxed );
+                }
+            }
+
+            item = c->item;
+            c->sequence.store( pos + m_Mask + 1, std::memory_order_release );
+            return true;
+        }
+
+        [[nodiscard]] constexpr uint32_t capacity() const
+        {
+            return m_Mask + 1;
+        }
+
+    private:
+        struct cell
+        {
+            std::atomic<uint64_t>   sequence;
+            T                       item;
+        };
+
+        // Keep the producer and consumer positions on separate cache
+        // lines to avoid false sharing between them
+        cell *const                         m_Cells;
+        const uint64_t                      m_Mask;
+        alignas( 64 ) std::atomic<uint64_t> m_EnqueuePos{ 0 };
+        alignas( 64 ) std::atomic<uint64_t> m_DequeuePos{ 0 };
+    };
+} // namespace muggy::utils
+
+
+#endif
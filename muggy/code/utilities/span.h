@@ -0,0 +1,106 @@
+//********************************************************************
+//  File:    span.h
+//  Date:    Sat, 17 Oct 2026: 02:15
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(SPAN_H)
+#define SPAN_H
+
+#include <stdint.h>
+#include <assert.h>
+#include <type_traits>
+
+namespace muggy::utils
+{
+    // Non-owning view of a contiguous range of items. This is a
+    // minimal stand-in for std::span until we move to C++20
+    template <typename T>
+    class span
+    {
+    public:
+        constexpr span() = default;
+
+        constexpr span( T* data, uint64_t size )
+         :
+            m_Data( data ),
+            m_Size( size )
+        {
+            assert( data || !size );
+        }
+
+        template <uint64_t N>
+        constexpr span( T (&arr)[N] )
+         :
+            m_Data( arr ),
+            m_Size( N )
+        {}
+
+        // Constructs from any container with data() and size(), such
+        // as utils::vector
+        template <typename C,
+                  typename = std::enable_if_t<
+                      std::is_convertible_v<decltype( std::declval<C&>().data() ), T*>>>
+        constexpr span( C& container )
+         :
+            m_Data( container.data() ),
+            m_Size( container.size() )
+        {}
+
+        // Allows conversion from span<U> to span<const U>
+        template <typename U,
+                  typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+        constexpr span( const span<U>& other )
+         :
+            m_Data( other.data() ),
+            m_Size( other.size() )
+        {}
+
+        // Returns a view of "count" items starting at "offset"
+        [[nodiscard]] constexpr span subspan( uint64_t offset, uint64_t count ) const
+        {
+            assert( offset + count <= m_Size );
+            return span( m_Data + offset, count );
+        }
+
+        [[nodiscard]] constexpr T* data() const
+        {
+            return m_Data;
+        }
+
+        [[nodiscard]] constexpr uint64_t size() const
+        {
+            return m_Size;
+        }
+
+        [[nodiscard]] constexpr bool empty() const
+        {
+            return m_Size == 0;
+        }
+
+        [[nodiscard]] constexpr T& operator[]( uint64_t index ) const
+        {
+            assert( m_Data && index < m_Size );
+            return m_Data[ index ];
+        }
+
+        [[nodiscard]] constexpr T* begin() const
+        {
+            return m_Data;
+        }
+
+        [[nodiscard]] constexpr T* end() const
+        {
+            return m_Data + m_Size;
+        }
+
+    private:
+        T*          m_Data{ nullptr };
+        uint64_t    m_Size{ 0 };
+    };
+} // namespace muggy::utils
+
+
+#endif
@@ -0,0 +1,170 @@
+//********************************************************************
+//  File:    sparseset.h
+//  Date:    Sat, 17 Oct 2026: 00:12
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(SPARSE_SET_H)
+#define SPARSE_SET_H
+
+#include "../common/common.h"
+
+namespace muggy::utils
+{
+    // Stores values keyed by id in a densely packed array. The sparse
+    // array maps the index part of an id to the position in the dense
+    // arrays, which in turn keeps the full id of every value so stale
+    // generations are detected.
+    // Adding and removing is O(1), removing swaps the last value into
+    // the hole so iteration over the dense array never hits a hole
+    template <typename T>
+    class sparse_set
+    {
+    public:
+        sparse_set() = default;
+
+        explicit sparse_set( uint32_t count )
+        {
+            reserve( count );
+        }
+
+        // Reserves memory in the dense arrays for "count" values
+        constexpr void reserve( uint32_t count )
+        {
+            m_Dense.reserve( count );
+            m_Ids.reserve( count );
+        }
+
+        // Constructs a value for the id at the end of the dense array
+        template <typename... params>
+        constexpr T& add( id::id_type id, params&&... p )
+        {
+            assert( id::isValid( id ) && !contains( id ) );
+            const id::id_type index{ id::index( id ) };
+            if ( index >= m_Sparse.size() )
+            {
+                m_Sparse.resize( index + 1, uint32_invalid_id );
+            }
+
+            m_Sparse[ index ] = (uint32_t)m_Dense.size();
+            m_Ids.push_back( id );
+            return m_Dense.emplace_back( std::forward<params>( p )... );
+        }
+
+        // Removes the value for the id by moving the last value of the
+        // dense array into its place
+        constexpr void remove( id::id_type id )
+        {
+            assert( contains( id ) );
+            const id::id_type index{ id::index( id ) };
+            const uint32_t denseIndex{ m_Sparse[ index ] };
+            const uint32_t last{ (uint32_t)m_Dense.size() - 1 };
+
+            if ( denseIndex != last )
+            {
+                // Update the sparse slot of the value that gets moved
+                m_Sparse[ id::index( m_Ids[ last ] ) ] = denseIndex;
+            }
+
+            utils::erase_unordered( m_Dense, denseIndex );
+            utils::erase_unordered( m_Ids, denseIndex );
+            m_Sparse[ index ] = uint32_invalid_id;
+        }
+
+        // Returns true if there is a value for this exact id, ie
+        // including the generation
+        [[nodiscard]] constexpr bool contains( id::id_type id ) const
+        {
+            const id::id_type index{ id::index( id ) };
+            return ( index < m_Sparse.size() &&
+                     m_Sparse[ index ] != uint32_invalid_id &&
+                     m_Ids[ m_Sparse[ index ] ] == id );
+        }
+
+        // Returns the position of the id in the dense array
+        [[nodiscard]] constexpr uint32_t getDenseIndex( id::id_type id ) const
+        {
+            assert( contains( id ) );
+            return m_Sparse[ id::index( id ) ];
+        }
+
+        // Removes all values but keeps the memory
+        constexpr void clear()
+        {
+            m_Dense.clear();
+            m_Ids.clear();
+            m_Sparse.clear();
+        }
+
+        [[nodiscard]] constexpr T& operator[]( id::id_type id )
+        {
+            return m_Dense[ getDenseIndex( id ) ];
+        }
+
+        [[nodiscard]] constexpr const T& operator[]( id::id_type id ) const
+        {
+            return m_Dense[ getDenseIndex( id ) ];
+        }
+
+        // Number of values currently stored
+        [[nodiscard]] constexpr uint32_t size() const
+        {
+            return (uint32_t)m_Dense.size();
+        }
+
+        [[nodiscard]] constexpr bool empty() const
+        {
+            return m_Dense.empty();
+        }
+
+        // Pointer to the densely packed values
+        [[nodiscard]] constexpr T* data()
+        {
+            return m_Dense.data();
+        }
+
+        [[nodiscard]] constexpr const T* data() const
+        {
+            return m_Dense.data();
+        }
+
+        // Pointer to the ids of the densely packed values. The id at
+        // position i owns the value at position i
+        [[nodiscard]] constexpr const id::id_type* ids() const
+        {
+            return m_Ids.data();
+        }
+
+        // Iterators over the dense values. Unlike utils::vector these
+        // are valid (but equal) for an empty set
+        [[nodiscard]] constexpr T* begin()
+        {
+            return m_Dense.data();
+        }
+
+        [[nodiscard]] constexpr const T* begin() const
+        {
+            return m_Dense.data();
+        }
+
+        [[nodiscard]] constexpr T* end()
+        {
+            return m_Dense.data() + m_Dense.size();
+        }
+
+        [[nodiscard]] constexpr const T* end() const
+        {
+            return m_Dense.data() + m_Dense.size();
+        }
+
+    private:
+        utils::vector<T>            m_Dense;
+        utils::vector<id::id_type>  m_Ids;
+        utils::vector<uint32_t>     m_Sparse;
+    };
+} // namespace muggy::utils
+
+
+#endif
@@ -0,0 +1,34 @@
+//********************************************************************
+//  File:    traits.h
+//  Date:    Wed, 21 Oct 2026: 10:15
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TRAITS_H)
+#define TRAITS_H
+
+#include <type_traits>
+
+namespace muggy::utils
+{
+    // True if an object of T can be moved to another address by 
+    // copying its bytes and then forgetting the original, without
+    // calling a move constructor or destructor. utils::vector grows
+    // with realloc and erases with memmove for these types, and move 
+    // constructs the items one by one for the rest.
+    // Trivially copyable types are relocatable. Other types opt in by
+    // specializing this trait, which is correct for most types that
+    // don't hold pointers into themselves:
+    //  template <> struct utils::is_trivially_relocatable<my_type> 
+    //      : std::true_type {};
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+    template <typename T>
+    inline constexpr bool is_trivially_relocatable_v{ is_trivially_relocatable<T>::value };
+} // namespace muggy::utils
+
+
+#endif
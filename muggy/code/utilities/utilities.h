@@ -46,6 +46,8 @@ namespace muggy::utils
 }
 #endif
 
+#include "span.h"
+
 #if USE_STL_DEQUE
 #include <deque>
 namespace muggy::utils
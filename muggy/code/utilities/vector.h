@@ -10,17 +10,38 @@
 #define VECTOR_H
 
 #include "../common/common.h"
+#include "allocator.h"
+#include "traits.h"
 
 namespace muggy::utils
 {
-    template <typename T, bool destruct=true>
-    class vector
+    // The memory comes from Allocator, see allocator.h. With the
+    // default allocator the items are aligned to alignof( T )
+    // NOTE(klek): The allocator is a private base, so allocators
+    //             without members don't add to the size of the vector
+    // Items are moved with realloc and memmove when T is trivially
+    // relocatable (see traits.h) or when the vector doesn't destruct its
+    // items, otherwise with their move constructor and assignment
+    template <typename T, bool destruct=true, typename Allocator=default_allocator<T>>
+    class vector : private Allocator
     {
+        static_assert( Allocator::alignment >= alignof( T ),
+                       "Allocator alignment is too small for the type" );
+
     public:
+        using allocator_type = Allocator;
+
         // Constructors
         // Default contstructor, doesn't allocate memory
         vector() = default;
 
+        // Constructor that uses a copy of "allocator" for all memory,
+        // doesn't allocate memory
+        constexpr explicit vector( const Allocator& allocator )
+         :
+            Allocator( allocator )
+        {}
+
         // Constructor resizes the vector and initializes "count" items
         constexpr vector( uint64_t count )
         {
@@ -47,14 +68,17 @@ namespace muggy::utils
         // Copy-constructor, constructs by copying another vector
         // The items in the copied vector must be copyable!
         constexpr vector( const vector& other )
+         :
+            Allocator( other.get_allocator() )
         {
             *this = other;
         }
 
         // Move-constructor, constructs by moving another vector
         // The original vector will be empty after the move
-        constexpr vector( const vector&& other )
+        constexpr vector( vector&& other ) noexcept
          : 
+            Allocator( other.get_allocator() ),
             m_Capacity( other.m_Capacity ),
             m_Size( other.m_Size ),
             m_Data( other.m_Data )
@@ -73,9 +97,11 @@ namespace muggy::utils
             {
                 clear();
                 reserve( other.m_Size );
-                for ( auto& item : other )
+                // NOTE(klek): Index loop, since begin() asserts on an
+                //             empty vector that was never allocated
+                for ( uint64_t i{ 0 }; i < other.m_Size; i++ )
                 {
-                    emplace_back( item );
+                    emplace_back( other.m_Data[ i ] );
                 }
                 assert( m_Size == other.m_Size );
             }
@@ -85,7 +111,7 @@ namespace muggy::utils
 
         // Move-assignment operator, frees all resources in this vector
         // and moves the other vector into this one
-        constexpr vector& operator=( const vector&& other )
+        constexpr vector& operator=( vector&& other ) noexcept
         {
             // Check for assignment to itself, which might not be 
             // what we want!
@@ -170,7 +196,7 @@ namespace muggy::utils
 
         // Resizes the vector and initializes new items with the
         // value provided
-        constexpr void resize( uint64_t newSize, T* value )
+        constexpr void resize( uint64_t newSize, const T& value )
         {
             static_assert( std::is_copy_constructible<T>::value,
                            "Type must be copy-constructible");
@@ -202,15 +228,33 @@ namespace muggy::utils
         // Allocates memory to contain the specified number of items
         constexpr void reserve( uint64_t newCapacity )
         {
-            if ( newCapacity > m_Capacity )
+            // A capacity this large can't be allocated, handle it like a
+            // failed allocation. This happens when a size wraps around,
+            // eg resize( size() - 1 ) on an empty vector
+            assert( newCapacity <= max_capacity );
+            if ( newCapacity > m_Capacity && newCapacity <= max_capacity )
             {
-                // NOTE(klek): realloc() will automatically copy the
-                //             data in the buffer if a new region of 
-                //             memory is allocated
-                void* newBuffer{ realloc( m_Data, newCapacity * sizeof(T) ) };
+                void* newBuffer{ nullptr };
+                if constexpr ( relocate_bytes )
+                {
+                    // NOTE(klek): The allocator copies the items in use
+                    //             if a new region of memory is allocated
+                    newBuffer = Allocator::reallocate( m_Data, 
+                                                       m_Size * sizeof(T),
+                                                       newCapacity * sizeof(T) );
+                }
+                else
+                {
+                    newBuffer = Allocator::allocate( newCapacity * sizeof(T) );
+                    if ( newBuffer )
+                    {
+                        relocate( static_cast<T*>( newBuffer ) );
+                    }
+                }
                 assert( newBuffer );
                 if( newBuffer )
                 {
+                    assert( ( (uintptr_t)newBuffer & ( Allocator::alignment - 1 ) ) == 0 );
                     m_Data = static_cast<T*>( newBuffer );
                     m_Capacity = newCapacity;
                 }
@@ -231,16 +275,31 @@ namespace muggy::utils
                     item >= std::addressof( m_Data[ 0 ] ) && 
                     item < std::addressof( m_Data[ m_Size ] ) );
 
-            if constexpr ( destruct )
+            if constexpr ( relocate_bytes )
             {
-                item->~T();
+                if constexpr ( destruct )
+                {
+                    item->~T();
+                }
+                m_Size--;
+                if ( item < std::addressof( m_Data[ m_Size ] ) )
+                {
+                    memmove( item, 
+                             ( item + 1 ), 
+                             ( std::addressof( m_Data[ m_Size ] ) - item ) * sizeof( T ) );
+                }
             }
-            m_Size--;
-            if ( item < std::addressof( m_Data[ m_Size ] ) )
+            else
             {
-                memcpy( item, 
-                        ( item + 1 ), 
-                        ( std::addressof( m_Data[ m_Size ] ) - item ) * sizeof( T ) );
+                // Shift the following items down and destruct the last
+                // one, which has been moved from
+                T *const last{ std::addressof( m_Data[ m_Size - 1 ] ) };
+                for ( T* p{ item }; p < last; p++ )
+                {
+                    *p = std::move( *( p + 1 ) );
+                }
+                last->~T();
+                m_Size--;
             }
 
             return item;
@@ -262,16 +321,29 @@ namespace muggy::utils
                     item >= std::addressof( m_Data[ 0 ] ) && 
                     item < std::addressof( m_Data[ m_Size ] ) );
 
-            if constexpr ( destruct )
+            if constexpr ( relocate_bytes )
             {
-                item->~T();
+                if constexpr ( destruct )
+                {
+                    item->~T();
+                }
+                m_Size--;
+                if ( item < std::addressof( m_Data[ m_Size ] ) )
+                {
+                    memcpy( item, 
+                            std::addressof( m_Data[ m_Size ] ),
+                            sizeof( T ) );
+                }
             }
-            m_Size--;
-            if ( item < std::addressof( m_Data[ m_Size ] ) )
+            else
             {
-                memcpy( item, 
-                        std::addressof( m_Data[ m_Size ] ),
-                        sizeof( T ) );
+                T *const last{ std::addressof( m_Data[ m_Size - 1 ] ) };
+                if ( item < last )
+                {
+                    *item = std::move( *last );
+                }
+                last->~T();
+                m_Size--;
             }
 
             return item;
@@ -299,6 +371,12 @@ namespace muggy::utils
             }
         }
 
+        // The allocator that the memory of this vector comes from
+        [[nodiscard]] constexpr const Allocator& get_allocator() const
+        {
+            return *this;
+        }
+
         // Pointer to the start of data. This might be null
         [[nodiscard]] constexpr T* data()
         {
@@ -414,9 +492,31 @@ namespace muggy::utils
         }
 
     private:
+        // NOTE(klek): A vector that doesn't destruct its items doesn't
+        //             know which of them are alive, such as the free
+        //             slots of a free_list, so it can only copy bytes
+        static constexpr bool relocate_bytes{ is_trivially_relocatable_v<T> || !destruct };
+        // Largest number of items whose size in bytes fits in a ptrdiff_t
+        static constexpr uint64_t max_capacity{ (uint64_t)PTRDIFF_MAX / sizeof( T ) };
+
+        // Moves the items to "newData" and frees the old memory
+        constexpr void relocate( T *const newData )
+        {
+            for ( uint64_t i{ 0 }; i < m_Size; i++ )
+            {
+                new ( std::addressof( newData[ i ] ) ) T( std::move( m_Data[ i ] ) );
+                m_Data[ i ].~T();
+            }
+            if ( m_Data )
+            {
+                Allocator::deallocate( m_Data );
+            }
+        }
 
         constexpr void move( vector& other )
         {
+            // The memory has to go back to the allocator it came from
+            static_cast<Allocator&>( *this ) = other.get_allocator();
             m_Capacity  = other.m_Capacity;
             m_Size      = other.m_Size;
             m_Data      = other.m_Data;
@@ -457,7 +557,7 @@ namespace muggy::utils
             m_Capacity = 0;
             if ( m_Data ) 
             {
-                free( m_Data );
+                Allocator::deallocate( m_Data );
             }
             m_Data = nullptr;
         }
@@ -467,6 +567,12 @@ namespace muggy::utils
         uint64_t    m_Size{ 0 };
         T*          m_Data{ nullptr };
     };
+
+    // A vector only points to memory outside of itself, so a vector of
+    // vectors can grow without moving the items of the inner vectors
+    template <typename T, bool destruct, typename Allocator>
+    struct is_trivially_relocatable<vector<T, destruct, Allocator>> 
+        : is_trivially_relocatable<Allocator> {};
 } // namespace muggy::utils
 
 
@@ -0,0 +1,120 @@
+//********************************************************************
+//  File:    virtualMemory.cpp
+//  Date:    Wed, 21 Oct 2026: 14:42
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "virtualMemory.h"
+
+#if defined(_WIN64)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace muggy::utils::vm
+{
+    uint64_t getPageSize()
+    {
+#if defined(_WIN64)
+        static const uint64_t pageSize{ []
+            {
+                SYSTEM_INFO info;
+                GetSystemInfo( &info );
+                return (uint64_t)info.dwPageSize;
+            }() };
+#else
+        static const uint64_t pageSize{ (uint64_t)sysconf( _SC_PAGESIZE ) };
+#endif
+        return pageSize;
+    }
+
+    void* reserve( uint64_t size, bool hugePages )
+    {
+        assert( size && ( size % getPageSize() ) == 0 );
+#if defined(_WIN64)
+        // NOTE(klek): Large pages on Windows need a privilege and have
+        //             to be committed up front, so the hint is ignored
+        (void)hugePages;
+        return VirtualAlloc( nullptr, size, MEM_RESERVE, PAGE_NOACCESS );
+#else
+        if ( !hugePages )
+        {
+            void *const address{ mmap( nullptr, size, PROT_NONE, 
+                                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, 
+                                       -1, 0 ) };
+            return ( address == MAP_FAILED ) ? nullptr : address;
+        }
+
+        // Reserve an extra huge page, so an aligned start can be cut
+        // out of the range, and give back what's left on either side
+        const uint64_t paddedSize{ size + huge_page_size };
+        void *const address{ mmap( nullptr, paddedSize, PROT_NONE, 
+                                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, 
+                                   -1, 0 ) };
+        if ( address == MAP_FAILED )
+        {
+            return nullptr;
+        }
+        const uintptr_t first{ (uintptr_t)address };
+        const uintptr_t aligned{ ( first + huge_page_size - 1 ) & ~( huge_page_size - 1 ) };
+        if ( aligned > first )
+        {
+            munmap( address, aligned - first );
+        }
+        const uintptr_t tail{ ( first + paddedSize ) - ( aligned + size ) };
+        if ( tail )
+        {
+            munmap( (void*)( aligned + size ), tail );
+        }
+#if defined(MADV_HUGEPAGE)
+        // Only a hint, transparent huge pages may be disabled
+        madvise( (void*)aligned, size, MADV_HUGEPAGE );
+#endif
+        return (void*)aligned;
+#endif
+    }
+
+    bool commit( void* address, uint64_t size )
+    {
+        assert( ( (uintptr_t)address % getPageSize() ) == 0 && 
+                ( size % getPageSize() ) == 0 );
+#if defined(_WIN64)
+        return VirtualAlloc( address, size, MEM_COMMIT, PAGE_READWRITE ) != nullptr;
+#else
+        return mprotect( address, size, PROT_READ | PROT_WRITE ) == 0;
+#endif
+    }
+
+    void decommit( void* address, uint64_t size )
+    {
+        assert( ( (uintptr_t)address % getPageSize() ) == 0 && 
+                ( size % getPageSize() ) == 0 );
+#if defined(_WIN64)
+        VirtualFree( address, size, MEM_DECOMMIT );
+#else
+        // Dropping the pages first makes them read as zero should the
+        // range be committed again
+        madvise( address, size, MADV_DONTNEED );
+        mprotect( address, size, PROT_NONE );
+#endif
+    }
+
+    void release( void* address, uint64_t size )
+    {
+        if ( !address )
+        {
+            return;
+        }
+#if defined(_WIN64)
+        (void)size;
+        VirtualFree( address, 0, MEM_RELEASE );
+#else
+        munmap( address, size );
+#endif
+    }
+} // namespace muggy::utils::vm
@@ -0,0 +1,41 @@
+//********************************************************************
+//  File:    virtualMemory.h
+//  Date:    Wed, 21 Oct 2026: 14:30
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(VIRTUAL_MEMORY_H)
+#define VIRTUAL_MEMORY_H
+
+#include "../common/common.h"
+
+namespace muggy::utils::vm
+{
+    // Size of the pages that huge page ranges are aligned to
+    constexpr uint64_t huge_page_size{ 2 * 1024 * 1024 };
+
+    // Size of a regular page, which is what commit() and decommit()
+    // work with
+    [[nodiscard]] uint64_t getPageSize();
+
+    // Reserves "size" bytes of address space without backing it with
+    // memory, accessing it faults until it is committed. With 
+    // "hugePages" the range is aligned to huge_page_size and the OS is
+    // asked to back it with huge pages, where that is supported.
+    // Returns nullptr on failure
+    [[nodiscard]] void* reserve( uint64_t size, bool hugePages );
+    // Makes the pages of the range readable and writable. They read as
+    // zero the first time. The range must be page aligned and within a
+    // reserved range
+    [[nodiscard]] bool commit( void* address, uint64_t size );
+    // Gives the memory of the pages back to the OS but keeps the range
+    // reserved
+    void decommit( void* address, uint64_t size );
+    // Releases a range returned by reserve(), with the same size
+    void release( void* address, uint64_t size );
+} // namespace muggy::utils::vm
+
+
+#endif
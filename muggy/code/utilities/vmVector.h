@@ -0,0 +1,395 @@
+//********************************************************************
+//  File:    vmVector.h
+//  Date:    Wed, 21 Oct 2026: 15:20
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(VM_VECTOR_H)
+#define VM_VECTOR_H
+
+#include "../common/common.h"
+#include "virtualMemory.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace muggy::utils
+{
+    // Vector that reserves address space for "maxCount" items up front
+    // and commits memory as it grows. Growing never copies the items,
+    // so pointers to them stay valid until the items are removed.
+    // That makes it the better fit for arrays of millions of items,
+    // where utils::vector would copy everything on each reallocation.
+    // Only address space is taken for the reserved range, so being
+    // generous with maxCount is cheap on 64-bit.
+    // With "hugePages" the OS is asked to back the memory with huge
+    // pages, which helps TLB misses on big columns, and memory is
+    // committed a huge page at a time.
+    // Growing past maxCount, or running out of memory, aborts: the
+    // items can't be moved somewhere else to make room.
+    template <typename T>
+    class vm_vector
+    {
+    public:
+        // Bytes of address space reserved when no maximum is given
+        static constexpr uint64_t default_reserve_size{ uint64_t{ 1 } << 32 };
+
+        vm_vector()
+         :
+            vm_vector( default_reserve_size / sizeof( T ) )
+        {}
+
+        // NOTE(klek): The range is reserved on first use, so creating
+        //             a vector that is never used costs nothing
+        explicit vm_vector( uint64_t maxCount, bool hugePages = false )
+         :
+            m_MaxCount( maxCount ),
+            m_HugePages( hugePages )
+        {
+            assert( maxCount );
+        }
+
+        vm_vector( const vm_vector& ) = delete;
+        vm_vector& operator=( const vm_vector& ) = delete;
+
+        vm_vector( vm_vector&& other ) noexcept
+        {
+            move( other );
+        }
+
+        vm_vector& operator=( vm_vector&& other ) noexcept
+        {
+            assert( this != std::addressof( other ) );
+            if ( this != std::addressof( other ) )
+            {
+                destroy();
+                move( other );
+            }
+            return *this;
+        }
+
+        ~vm_vector()
+        {
+            destroy();
+        }
+
+        constexpr void push_back( const T& value )
+        {
+            emplace_back( value );
+        }
+
+        constexpr void push_back( T&& value )
+        {
+            emplace_back( std::move( value ) );
+        }
+
+        // Constructs an item at the end of the vector. The other items
+        // stay where they are
+        template <typename... params>
+        constexpr decltype( auto ) emplace_back( params&&... p )
+        {
+            if ( m_Size == m_Capacity )
+            {
+                // Commit 50 % more, like utils::vector, to keep the
+                // number of system calls down
+                reserve( std::max( m_Size + 1, 
+                                   std::min( ( m_Capacity * 3 ) >> 1, m_MaxCount ) ) );
+            }
+            // reserve() never returns without room for one more item
+            assert( m_Size < m_Capacity );
+
+            T *const item{ new ( std::addressof( m_Data[ m_Size ] ) ) T( std::forward<params>( p )... ) };
+            m_Size++;
+            return *item;
+        }
+
+        // Resizes the vector and initializes new items with their
+        // default value
+        constexpr void resize( uint64_t newSize )
+        {
+            static_assert( std::is_default_constructible<T>::value,
+                           "Type must be default-constructible");
+            if ( newSize > m_Size )
+            {
+                reserve( newSize );
+                while ( m_Size < newSize )
+                {
+                    emplace_back();
+                }
+            }
+            else
+            {
+                destruct_range( newSize, m_Size );
+                m_Size = newSize;
+            }
+            assert( newSize == m_Size );
+        }
+
+        // Resizes the vector and initializes new items with the
+        // value provided
+        constexpr void resize( uint64_t newSize, const T& value )
+        {
+            static_assert( std::is_copy_constructible<T>::value,
+                           "Type must be copy-constructible");
+            if ( newSize > m_Size )
+            {
+                reserve( newSize );
+                while ( m_Size < newSize )
+                {
+                    emplace_back( value );
+                }
+            }
+            else
+            {
+                destruct_range( newSize, m_Size );
+                m_Size = newSize;
+            }
+            assert( newSize == m_Size );
+        }
+
+        // Commits memory for the specified number of items. This never
+        // moves the items, and it aborts if "newCapacity" is more than
+        // max_size() or the memory can't be reserved or committed
+        constexpr void reserve( uint64_t newCapacity )
+        {
+            if ( newCapacity <= m_Capacity )
+            {
+                return;
+            }
+            if ( newCapacity > m_MaxCount )
+            {
+                fail( "more items than the maximum the vector was made for" );
+            }
+
+            const uint64_t granule{ getGranule() };
+            if ( !m_Data )
+            {
+                const uint64_t reservedBytes{ roundUp( m_MaxCount * sizeof( T ), granule ) };
+                m_Data = static_cast<T*>( vm::reserve( reservedBytes, m_HugePages ) );
+                if ( !m_Data )
+                {
+                    fail( "failed to reserve address space" );
+                }
+                m_ReservedBytes = reservedBytes;
+            }
+
+            const uint64_t newBytes{ std::min( roundUp( newCapacity * sizeof( T ), granule ),
+                                               m_ReservedBytes ) };
+            uint8_t *const first{ (uint8_t*)m_Data + m_CommittedBytes };
+            if ( !vm::commit( first, newBytes - m_CommittedBytes ) )
+            {
+                fail( "failed to commit memory" );
+            }
+            m_CommittedBytes = newBytes;
+            m_Capacity = std::min( newBytes / sizeof( T ), m_MaxCount );
+        }
+
+        // Gives the memory past the last item back to the OS. The items
+        // stay where they are
+        void shrink_to_fit()
+        {
+            const uint64_t keepBytes{ roundUp( m_Size * sizeof( T ), getGranule() ) };
+            if ( keepBytes < m_CommittedBytes )
+            {
+                vm::decommit( (uint8_t*)m_Data + keepBytes, m_CommittedBytes - keepBytes );
+                m_CommittedBytes = keepBytes;
+                m_Capacity = std::min( keepBytes / sizeof( T ), m_MaxCount );
+            }
+        }
+
+        // Removes the last item
+        constexpr void pop_back()
+        {
+            assert( m_Size );
+            m_Size--;
+            m_Data[ m_Size ].~T();
+        }
+
+        // Removes the item by moving the last item into its place. Only
+        // the last item changes address
+        constexpr T* erase_unordered( uint64_t index )
+        {
+            assert( m_Data && index < m_Size );
+            T *const item{ std::addressof( m_Data[ index ] ) };
+            if ( index < m_Size - 1 )
+            {
+                *item = std::move( m_Data[ m_Size - 1 ] );
+            }
+            pop_back();
+            return item;
+        }
+
+        // Destructs all items but keeps the memory committed
+        constexpr void clear()
+        {
+            destruct_range( 0, m_Size );
+            m_Size = 0;
+        }
+
+        // Pointer to the start of data. This is null until the first
+        // item is added, and doesn't change after that
+        [[nodiscard]] constexpr T* data()
+        {
+            return m_Data;
+        }
+
+        [[nodiscard]] constexpr const T* data() const
+        {
+            return m_Data;
+        }
+
+        [[nodiscard]] constexpr bool empty() const
+        {
+            return m_Size == 0;
+        }
+
+        [[nodiscard]] constexpr uint64_t size() const
+        {
+            return m_Size;
+        }
+
+        // Number of items there is committed memory for
+        [[nodiscard]] constexpr uint64_t capacity() const
+        {
+            return m_Capacity;
+        }
+
+        // Number of items the reserved range has room for
+        [[nodiscard]] constexpr uint64_t max_size() const
+        {
+            return m_MaxCount;
+        }
+
+        [[nodiscard]] constexpr T& operator[]( uint64_t index )
+        {
+            assert( m_Data && index < m_Size );
+            return m_Data[ index ];
+        }
+
+        [[nodiscard]] constexpr const T& operator[]( uint64_t index ) const
+        {
+            assert( m_Data && index < m_Size );
+            return m_Data[ index ];
+        }
+
+        [[nodiscard]] constexpr T& front()
+        {
+            assert( m_Data && m_Size );
+            return m_Data[ 0 ];
+        }
+
+        [[nodiscard]] constexpr const T& front() const
+        {
+            assert( m_Data && m_Size );
+            return m_Data[ 0 ];
+        }
+
+        [[nodiscard]] constexpr T& back()
+        {
+            assert( m_Data && m_Size );
+            return m_Data[ m_Size - 1 ];
+        }
+
+        [[nodiscard]] constexpr const T& back() const
+        {
+            assert( m_Data && m_Size );
+            return m_Data[ m_Size - 1 ];
+        }
+
+        [[nodiscard]] constexpr T* begin()
+        {
+            return m_Data;
+        }
+
+        [[nodiscard]] constexpr const T* begin() const
+        {
+            return m_Data;
+        }
+
+        [[nodiscard]] constexpr T* end()
+        {
+            return m_Data + m_Size;
+        }
+
+        [[nodiscard]] constexpr const T* end() const
+        {
+            return m_Data + m_Size;
+        }
+
+    private:
+        // NOTE(klek): The items can't be moved to make room, and writing
+        //             past the committed memory would crash somewhere
+        //             less obvious, so stop here instead
+        [[noreturn]] static void fail( const char* message )
+        {
+            fprintf( stderr, "vm_vector: %s\n", message );
+            std::abort();
+        }
+
+        [[nodiscard]] static constexpr uint64_t roundUp( uint64_t size, uint64_t granule )
+        {
+            return ( size + granule - 1 ) / granule * granule;
+        }
+
+        // Memory is committed in multiples of this
+        [[nodiscard]] uint64_t getGranule() const
+        {
+            // NOTE(klek): 64 KiB is also the allocation granularity on
+            //             Windows
+            return m_HugePages ? vm::huge_page_size
+                               : std::max<uint64_t>( vm::getPageSize(), 64 * 1024 );
+        }
+
+        constexpr void destruct_range( uint64_t first, uint64_t last )
+        {
+            assert( first <= last && last <= m_Size );
+            if constexpr ( !std::is_trivially_destructible<T>::value )
+            {
+                for ( ; first != last; first++ )
+                {
+                    m_Data[ first ].~T();
+                }
+            }
+        }
+
+        void move( vm_vector& other )
+        {
+            m_Data              = other.m_Data;
+            m_Size              = other.m_Size;
+            m_Capacity          = other.m_Capacity;
+            m_CommittedBytes    = other.m_CommittedBytes;
+            m_ReservedBytes     = other.m_ReservedBytes;
+            m_MaxCount          = other.m_MaxCount;
+            m_HugePages         = other.m_HugePages;
+            other.m_Data            = nullptr;
+            other.m_Size            = 0;
+            other.m_Capacity        = 0;
+            other.m_CommittedBytes  = 0;
+            other.m_ReservedBytes   = 0;
+        }
+
+        void destroy()
+        {
+            clear();
+            vm::release( m_Data, m_ReservedBytes );
+            m_Data = nullptr;
+            m_Capacity = 0;
+            m_CommittedBytes = 0;
+            m_ReservedBytes = 0;
+        }
+
+        T*          m_Data{ nullptr };
+        uint64_t    m_Size{ 0 };
+        // Items that fit in the committed memory
+        uint64_t    m_Capacity{ 0 };
+        uint64_t    m_CommittedBytes{ 0 };
+        uint64_t    m_ReservedBytes{ 0 };
+        uint64_t    m_MaxCount{ 0 };
+        bool        m_HugePages{ false };
+    };
+} // namespace muggy::utils
+
+
+#endif
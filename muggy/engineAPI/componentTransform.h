@@ -27,6 +27,14 @@ namespace muggy::transform
         math::fv4d getRotation() const;
         math::fv3d getScale() const;
 
+        // Local position, rotation and scale, ie relative to the parent
+        void setPosition( const math::fv3d& position ) const;
+        void setRotation( const math::fv4d& rotation ) const;
+        void setScale( const math::fv3d& scale ) const;
+
+        // World matrix as of the last transform::updateWorldMatrices()
+        math::fmat4 getWorldMatrix() const;
+
     private:
         transform_id m_Id;
     };
@@ -21,6 +21,40 @@
 #include "tests/testFreelist.h"
 #elif TEST_VECTOR
 #include "tests/testVector.h"
+#elif TEST_ENTITY_BATCH
+#include "tests/testEntityBatch.h"
+#elif TEST_SPATIAL_SORT
+#include "tests/testSpatialSort.h"
+#elif TEST_WORLDS
+#include "tests/testWorlds.h"
+#elif TEST_COMPONENT_POOL
+#include "tests/testComponentPool.h"
+#elif TEST_DENSE_TRANSFORMS
+#include "tests/testDenseTransforms.h"
+#elif TEST_ALIVE
+#include "tests/testAlive.h"
+#elif TEST_WORLDS_STRESS
+#include "tests/testWorldsStress.h"
+#elif TEST_INTERPOLATION
+#include "tests/testInterpolation.h"
+#elif TEST_OBSERVERS
+#include "tests/testObservers.h"
+#elif TEST_NAMES
+#include "tests/testNames.h"
+#elif TEST_TAGS
+#include "tests/testTags.h"
+#elif TEST_SHARED_WORLD
+#include "tests/testSharedWorld.h"
+#elif TEST_SNAPSHOT
+#include "tests/testSnapshot.h"
+#elif TEST_MAT4_BATCH
+#include "tests/testMat4Batch.h"
+#elif TEST_HIERARCHY
+#include "tests/testHierarchy.h"
+#elif TEST_COMMAND_BUFFER
+#include "tests/testCommandBuffer.h"
+#elif TEST_QUERY
+#include "tests/testQuery.h"
 #else
 #error One of the tests have to be enabled in test.h
 #endif
@@ -16,6 +16,23 @@
 #define TEST_WINDOW             1
 #define TEST_FREELIST           0
 #define TEST_VECTOR             0
+#define TEST_ENTITY_BATCH       0
+#define TEST_SPATIAL_SORT       0
+#define TEST_WORLDS             0
+#define TEST_COMPONENT_POOL     0
+#define TEST_DENSE_TRANSFORMS   0
+#define TEST_ALIVE              0
+#define TEST_WORLDS_STRESS      0
+#define TEST_INTERPOLATION      0
+#define TEST_OBSERVERS          0
+#define TEST_NAMES              0
+#define TEST_TAGS               0
+#define TEST_SHARED_WORLD       0
+#define TEST_SNAPSHOT           0
+#define TEST_MAT4_BATCH         0
+#define TEST_HIERARCHY          0
+#define TEST_COMMAND_BUFFER     0
+#define TEST_QUERY              0
 
 class test
 {
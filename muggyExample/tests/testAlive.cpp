@@ -0,0 +1,170 @@
+//********************************************************************
+//  File:    testAlive.cpp
+//  Date:    Sat, 17 Oct 2026: 01:16
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_ALIVE
+#include "testAlive.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+using namespace muggy;
+
+namespace
+{
+    constexpr uint32_t roundCount{ 20 };
+    constexpr uint32_t changesPerRound{ 1'000 };
+    constexpr uint32_t batchSize{ 64 };
+    constexpr uint32_t reservedPerRound{ 50 };
+
+    std::mt19937 rng{ 7 };
+
+    // Removes the entity at "index" from the list and returns it
+    game_entity::entity take( utils::vector<game_entity::entity>& entities, uint32_t index )
+    {
+        const game_entity::entity e{ entities[ index ] };
+        utils::erase_unordered( entities, index );
+        return e;
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    bool ok{ true };
+    for ( uint32_t r{ 0 }; r < roundCount; r++ )
+    {
+        churn();
+        const bool roundOk{ verify() };
+        std::cout << "round " << r << ": " << m_Alive.size() << " alive, " 
+                  << m_Reserved.size() << " reserved, "
+                  << ( roundOk ? "ok" : "FAILED" ) << std::endl;
+        ok = ok && roundOk;
+    }
+    assert( ok );
+}
+
+void engineTest::shutdown( void ) 
+{
+    game_entity::removeGameEntities( m_Alive );
+    for ( game_entity::entity e : m_Reserved )
+    {
+        game_entity::cancelReservedGameEntity( e );
+    }
+    m_Alive.clear();
+    m_Reserved.clear();
+}
+
+void engineTest::churn( void )
+{
+    transform::init_info transformInfo{};
+    const game_entity::entity_info entityInfo{ &transformInfo };
+
+    // The reserved entities of the last round are created now
+    if ( !m_Reserved.empty() )
+    {
+        const utils::vector<game_entity::entity_info> infos( m_Reserved.size(), entityInfo );
+        game_entity::createReservedGameEntities( infos, m_Reserved );
+        for ( game_entity::entity e : m_Reserved )
+        {
+            m_Alive.push_back( e );
+        }
+        m_Reserved.clear();
+    }
+
+    m_Removed.clear();
+    for ( uint32_t i{ 0 }; i < changesPerRound; i++ )
+    {
+        // NOTE(klek): Removal is kept rare enough for indices not to
+        //             run out of generations
+        const uint32_t action{ (uint32_t)( rng() % 32 ) };
+        if ( action < 18 || m_Alive.size() < batchSize )
+        {
+            m_Alive.push_back( game_entity::createGameEntity( entityInfo ) );
+        }
+        else if ( action < 30 )
+        {
+            const game_entity::entity e{ take( m_Alive, (uint32_t)( rng() % m_Alive.size() ) ) };
+            game_entity::removeGameEntity( e );
+            m_Removed.push_back( e );
+        }
+        else
+        {
+            // Batch creation and removal move many rows at once
+            utils::vector<game_entity::entity> batch( batchSize );
+            const utils::vector<game_entity::entity_info> infos( batchSize, entityInfo );
+            game_entity::createGameEntities( infos, batch );
+            for ( game_entity::entity e : batch )
+            {
+                m_Alive.push_back( e );
+            }
+            for ( game_entity::entity& e : batch )
+            {
+                e = take( m_Alive, (uint32_t)( rng() % m_Alive.size() ) );
+                m_Removed.push_back( e );
+            }
+            game_entity::removeGameEntities( batch );
+        }
+    }
+
+    for ( uint32_t i{ 0 }; i < reservedPerRound; i++ )
+    {
+        m_Reserved.push_back( game_entity::reserveGameEntity() );
+    }
+}
+
+bool engineTest::verify( void )
+{
+    bool ok{ true };
+
+    // forEachAlive() visits exactly the alive entities
+    utils::vector<id::id_type> expected;
+    for ( game_entity::entity e : m_Alive )
+    {
+        expected.push_back( e.getId() );
+    }
+    std::sort( expected.begin(), expected.end() );
+    utils::vector<id::id_type> visited;
+    game_entity::forEachAlive( [&visited]( game_entity::entity e )
+        {
+            visited.push_back( e.getId() );
+        } );
+    // Entities are visited in order of their index
+    ok = ok && std::is_sorted( visited.begin(), visited.end(),
+                               []( id::id_type a, id::id_type b )
+                               {
+                                   return id::index( a ) < id::index( b );
+                               } );
+    std::sort( visited.begin(), visited.end() );
+    ok = ok && visited.size() == expected.size() &&
+         std::equal( visited.begin(), visited.end(), expected.begin() );
+
+    // areAlive() and isAlive() agree on a mixed list of handles, where
+    // only the first m_Alive.size() ones are alive
+    utils::vector<game_entity::entity> handles;
+    for ( game_entity::entity e : m_Alive ) handles.push_back( e );
+    for ( game_entity::entity e : m_Removed ) handles.push_back( e );
+    for ( game_entity::entity e : m_Reserved ) handles.push_back( e );
+    utils::bitset alive;
+    const uint32_t aliveCount{ game_entity::areAlive( handles, alive ) };
+    ok = ok && aliveCount == m_Alive.size();
+    for ( uint32_t i{ 0 }; i < handles.size(); i++ )
+    {
+        const bool expectAlive{ i < m_Alive.size() };
+        ok = ok && alive.test( i ) == expectAlive &&
+             game_entity::isAlive( handles[ i ] ) == expectAlive;
+    }
+    return ok;
+}
+
+#endif
@@ -0,0 +1,38 @@
+//********************************************************************
+//  File:    testAlive.h
+//  Date:    Sat, 17 Oct 2026: 01:10
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_ALIVE_H)
+#define TEST_ALIVE_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Creates and removes random entities, one at a time and in 
+    // batches, and reserves a few that are created later
+    void churn( void );
+    // Checks that isAlive(), areAlive() and forEachAlive() agree on
+    // the alive, removed and reserved entities
+    bool verify( void );
+
+    muggy::utils::vector<muggy::game_entity::entity>    m_Alive;
+    muggy::utils::vector<muggy::game_entity::entity>    m_Removed;
+    muggy::utils::vector<muggy::game_entity::entity>    m_Reserved;
+};
+
+
+#endif
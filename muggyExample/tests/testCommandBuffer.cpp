@@ -0,0 +1,240 @@
+//********************************************************************
+//  File:    testCommandBuffer.cpp
+//  Date:    Sun, 18 Oct 2026: 13:08
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_COMMAND_BUFFER
+#include "testCommandBuffer.h"
+#include "../../muggy/code/components/commandBuffer.h"
+#include "../../muggy/code/components/idAllocator.h"
+#include "../../muggy/code/components/world.h"
+
+#include <iostream>
+#include <thread>
+
+using namespace muggy;
+
+namespace
+{
+    constexpr uint32_t threadCount{ 8 };
+    constexpr uint32_t createdPerThread{ 1'000 };
+    constexpr uint32_t existingCount{ threadCount * 100 };
+
+    struct health
+    {
+        uint32_t    value;
+    };
+
+    struct armor
+    {
+        uint32_t    value;
+    };
+
+    // What a thread recorded for one of its created entities
+    struct created_entity
+    {
+        game_entity::entity e;
+        bool                hasHealth;
+        uint32_t            health;
+        bool                removed;
+    };
+
+    game_entity::entity createNow()
+    {
+        transform::init_info info{};
+        return game_entity::createGameEntity( { &info } );
+    }
+
+    bool report( const char* name, bool ok )
+    {
+        std::cout << name << ": " << ( ok ? "ok" : "FAILED" ) << std::endl;
+        return ok;
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    bool ok{ true };
+    ok = report( "threads", checkThreads() ) && ok;
+    ok = report( "order", checkOrder() ) && ok;
+    ok = report( "clear", checkClear() ) && ok;
+    assert( ok );
+}
+
+void engineTest::shutdown( void ) 
+{
+}
+
+bool engineTest::checkThreads( void )
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    utils::vector<game_entity::entity> existing;
+    for ( uint32_t i{ 0 }; i < existingCount; i++ )
+    {
+        existing.push_back( createNow() );
+    }
+
+    // Each thread removes its share of the existing entities, and the
+    // first of every share is removed by the next thread as well
+    utils::vector<created_entity> created[ threadCount ];
+    bool recordedOk[ threadCount ]{ };
+    utils::vector<std::thread> threads;
+    for ( uint32_t t{ 0 }; t < threadCount; t++ )
+    {
+        threads.emplace_back( [&, t]()
+        {
+            ecs::world_scope threadScope{ world };
+            game_entity::command_buffer& commands{ game_entity::getCommandBuffer() };
+            transform::init_info info{};
+            info.position[ 0 ] = (float)t;
+            bool ok{ true };
+            for ( uint32_t i{ 0 }; i < createdPerThread; i++ )
+            {
+                created_entity c{ commands.create( info ), false, 0, false };
+                // Nothing is in the storage before the flush
+                ok = ok && c.e.isValid() && !game_entity::isAlive( c.e );
+                switch ( i % 4 )
+                {
+                case 1:
+                    c.hasHealth = true;
+                    c.health = t * createdPerThread + i;
+                    commands.addComponent<health>( c.e, health{ c.health } );
+                    break;
+                case 2:
+                    // Added and removed again
+                    commands.addComponent<health>( c.e, health{ i } );
+                    commands.removeComponent<health>( c.e );
+                    break;
+                case 3:
+                    // Created, changed and removed in one go
+                    commands.addComponent<health>( c.e, health{ i } );
+                    commands.remove( c.e );
+                    c.removed = true;
+                    break;
+                }
+                created[ t ].push_back( c );
+            }
+
+            const uint32_t share{ existingCount / threadCount };
+            for ( uint32_t i{ 0 }; i < share; i++ )
+            {
+                commands.remove( existing[ t * share + i ] );
+            }
+            commands.remove( existing[ ( ( t + 1 ) % threadCount ) * share ] );
+            recordedOk[ t ] = ok;
+        } );
+    }
+    for ( std::thread& thread : threads )
+    {
+        thread.join();
+    }
+    game_entity::flushCommandBuffers();
+
+    bool ok{ true };
+    for ( uint32_t t{ 0 }; t < threadCount; t++ )
+    {
+        ok = ok && recordedOk[ t ];
+        for ( const created_entity& c : created[ t ] )
+        {
+            const bool alive{ game_entity::isAlive( c.e ) };
+            ok = ok && alive == !c.removed;
+            if ( !ok || !alive )
+            {
+                continue;
+            }
+            ok = c.e.getTransform().getPosition().x == (float)t &&
+                 ecs::hasComponent<health>( c.e.getId() ) == c.hasHealth &&
+                 ( !c.hasHealth || ecs::getComponent<health>( c.e.getId() )->value == c.health );
+        }
+    }
+    for ( const game_entity::entity e : existing )
+    {
+        ok = ok && !game_entity::isAlive( e );
+    }
+    const uint32_t expected{ threadCount * createdPerThread * 3 / 4 };
+    return ok && transform::getTransformCount() == expected;
+}
+
+bool engineTest::checkOrder( void )
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    const game_entity::entity target{ createNow() };
+    const game_entity::entity doomed{ createNow() };
+    ecs::addComponent<armor>( target.getId(), armor{ 1 } );
+
+    game_entity::command_buffer& commands{ game_entity::getCommandBuffer() };
+    // The last value recorded for a component wins
+    commands.addComponent<health>( target, health{ 1 } );
+    commands.addComponent<health>( target, health{ 2 } );
+    // Removed and added again ends up added
+    commands.removeComponent<armor>( target );
+    commands.addComponent<armor>( target, armor{ 3 } );
+    // Changes to an entity that is removed in the same flush are fine
+    commands.addComponent<health>( doomed, health{ 4 } );
+    commands.remove( doomed );
+    commands.remove( doomed );
+    // A new entity can be parented to another new entity and get
+    // components before it exists
+    transform::init_info info{};
+    const game_entity::entity parent{ commands.create( info ) };
+    // The transform shares its id with the entity, which isn't alive
+    // yet so getTransform() can't be used
+    info.parent = transform::component{ transform::transform_id{ parent.getId() } };
+    const game_entity::entity child{ commands.create( info ) };
+    commands.addComponent<armor>( child, armor{ 5 } );
+    game_entity::flushCommandBuffers();
+
+    bool ok{ commands.empty() };
+    ok = ok && ecs::getComponent<health>( target.getId() )->value == 2 &&
+         ecs::getComponent<armor>( target.getId() )->value == 3;
+    ok = ok && !game_entity::isAlive( doomed );
+    ok = ok && game_entity::isAlive( parent ) && game_entity::isAlive( child ) &&
+         transform::getParent( child.getTransform() ).getId() == parent.getTransform().getId() &&
+         ecs::getComponent<armor>( child.getId() )->value == 5;
+
+    // Removing an entity that is already gone does nothing
+    commands.remove( doomed );
+    game_entity::flushCommandBuffers();
+    return ok && transform::getTransformCount() == 3;
+}
+
+bool engineTest::checkClear( void )
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    const game_entity::entity kept{ createNow() };
+
+    game_entity::command_buffer& commands{ game_entity::getCommandBuffer() };
+    transform::init_info info{};
+    utils::vector<game_entity::entity> reserved;
+    for ( uint32_t i{ 0 }; i < 10; i++ )
+    {
+        reserved.push_back( commands.create( info ) );
+        commands.addComponent<health>( reserved.back(), health{ i } );
+    }
+    commands.remove( kept );
+    commands.clear();
+    game_entity::flushCommandBuffers();
+
+    // The reserved ids are stale now, and nothing else happened
+    const id::id_allocator& ids{ game_entity::detail::getIdAllocator() };
+    bool ok{ commands.empty() && game_entity::isAlive( kept ) };
+    for ( const game_entity::entity e : reserved )
+    {
+        ok = ok && !game_entity::isAlive( e ) && !ids.isCurrent( e.getId() );
+    }
+    return ok && transform::getTransformCount() == 1;
+}
+
+#endif
@@ -0,0 +1,37 @@
+//********************************************************************
+//  File:    testCommandBuffer.h
+//  Date:    Sun, 18 Oct 2026: 13:02
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_COMMAND_BUFFER_H)
+#define TEST_COMMAND_BUFFER_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Several threads record creates, component changes and removes
+    // into their own buffers, which are flushed together
+    bool checkThreads( void );
+    // Creates are applied before component changes and removes come
+    // last, with duplicate removes and several changes of the same
+    // component in one buffer
+    bool checkOrder( void );
+    // Clearing a buffer gives the reserved entities back
+    bool checkClear( void );
+};
+
+
+#endif
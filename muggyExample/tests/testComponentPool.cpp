@@ -0,0 +1,150 @@
+//********************************************************************
+//  File:    testComponentPool.cpp
+//  Date:    Sat, 17 Oct 2026: 11:12
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_COMPONENT_POOL
+#include "testComponentPool.h"
+
+#include <iostream>
+
+using namespace muggy;
+
+namespace
+{
+    constexpr uint32_t entityCount{ 1'000 };
+
+    bool report( const char* name, bool ok )
+    {
+        std::cout << name << ": " << ( ok ? "ok" : "FAILED" ) << std::endl;
+        return ok;
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    transform::init_info transformInfo{};
+    game_entity::entity_info entityInfo{ &transformInfo };
+    for ( uint32_t i{ 0 }; i < entityCount; i++ )
+    {
+        m_Entities.push_back( game_entity::createGameEntity( entityInfo ) );
+    }
+    m_Pool = new ecs::component_pool<health>{};
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    bool ok{ true };
+    ok = report( "add", checkAdd() ) && ok;
+    ok = report( "swap and pop remove", checkRemove() ) && ok;
+    ok = report( "dense iteration", checkIteration() ) && ok;
+    ok = report( "entity removal", checkEntityRemoval() ) && ok;
+    assert( ok );
+}
+
+void engineTest::shutdown( void ) 
+{
+    for ( game_entity::entity e : m_Entities )
+    {
+        if ( game_entity::isAlive( e ) )
+        {
+            game_entity::removeGameEntity( e );
+        }
+    }
+    delete m_Pool;
+}
+
+bool engineTest::checkAdd( void )
+{
+    bool ok{ true };
+    for ( uint32_t i{ 0 }; i < entityCount; i += 2 )
+    {
+        const id::id_type id{ m_Entities[ i ].getId() };
+        health& h{ m_Pool->add( id, health{ i, (float)i } ) };
+        ok = ok && h.owner == i;
+    }
+    ok = ok && m_Pool->size() == entityCount / 2;
+    for ( uint32_t i{ 0 }; i < entityCount; i++ )
+    {
+        const id::id_type id{ m_Entities[ i ].getId() };
+        const bool expected{ ( i % 2 ) == 0 };
+        ok = ok && m_Pool->contains( id ) == expected;
+        ok = ok && ( !expected || m_Pool->get( id ).owner == i );
+    }
+    return ok;
+}
+
+bool engineTest::checkRemove( void )
+{
+    bool ok{ true };
+    // The values were added in order, so the first one is at dense 
+    // position 0 and the last one at the end
+    const id::id_type first{ m_Entities[ 0 ].getId() };
+    const id::id_type last{ m_Entities[ entityCount - 2 ].getId() };
+    const uint32_t before{ m_Pool->size() };
+    ok = ok && m_Pool->entities()[ 0 ] == first;
+    ok = ok && m_Pool->entities()[ before - 1 ] == last;
+
+    // Removing from the middle moves the last value into the hole
+    m_Pool->remove( first );
+    ok = ok && !m_Pool->contains( first );
+    ok = ok && m_Pool->size() == before - 1;
+    ok = ok && m_Pool->entities()[ 0 ] == last;
+    ok = ok && m_Pool->data()[ 0 ].owner == entityCount - 2;
+    ok = ok && m_Pool->get( last ).owner == entityCount - 2;
+
+    // Removing the last value doesn't move anything
+    const id::id_type tail{ m_Pool->entities()[ m_Pool->size() - 1 ] };
+    const uint32_t owner{ m_Pool->get( tail ).owner };
+    m_Pool->remove( tail );
+    ok = ok && !m_Pool->contains( tail ) && m_Pool->size() == before - 2;
+    ok = ok && m_Entities[ owner ].getId() == tail;
+    return ok;
+}
+
+bool engineTest::checkIteration( void )
+{
+    bool ok{ true };
+    uint32_t count{ 0 };
+    const id::id_type *const ids{ m_Pool->entities() };
+    for ( const health& h : *m_Pool )
+    {
+        // Every value is owned by the entity at the same position
+        ok = ok && m_Entities[ h.owner ].getId() == ids[ count ];
+        ok = ok && m_Pool->contains( ids[ count ] );
+        count++;
+    }
+    ok = ok && count == m_Pool->size();
+
+    // Every entity that still has a value must have been visited
+    uint32_t expected{ 0 };
+    for ( uint32_t i{ 0 }; i < entityCount; i++ )
+    {
+        expected += m_Pool->contains( m_Entities[ i ].getId() );
+    }
+    return ok && expected == count;
+}
+
+bool engineTest::checkEntityRemoval( void )
+{
+    bool ok{ true };
+    const game_entity::entity e{ m_Entities[ 2 ] };
+    ok = ok && m_Pool->contains( e.getId() );
+    game_entity::removeGameEntity( e );
+    ok = ok && !m_Pool->contains( e.getId() );
+
+    // New entities may get the index of the removed one, but with a
+    // newer generation
+    transform::init_info transformInfo{};
+    game_entity::entity_info entityInfo{ &transformInfo };
+    m_Entities[ 2 ] = game_entity::createGameEntity( entityInfo );
+    ok = ok && !m_Pool->contains( m_Entities[ 2 ].getId() );
+    return ok;
+}
+
+#endif
@@ -0,0 +1,48 @@
+//********************************************************************
+//  File:    testComponentPool.h
+//  Date:    Sat, 17 Oct 2026: 11:05
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_COMPONENT_POOL_H)
+#define TEST_COMPONENT_POOL_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+#include "../../muggy/code/components/componentPool.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Adds values for every other entity and checks lookups
+    bool checkAdd( void );
+    // Removes values from the middle and the end of the dense array
+    // and checks that the last value is swapped into the hole
+    bool checkRemove( void );
+    // Checks that the dense arrays hold exactly the expected values
+    bool checkIteration( void );
+    // Removing an entity has to remove it from the pool as well, and
+    // a recycled id must not see the value of the old entity
+    bool checkEntityRemoval( void );
+
+    struct health
+    {
+        uint32_t    owner;
+        float       value;
+    };
+
+    muggy::utils::vector<muggy::game_entity::entity>    m_Entities;
+    muggy::ecs::component_pool<health>*                 m_Pool{ nullptr };
+};
+
+
+#endif
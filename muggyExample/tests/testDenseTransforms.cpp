@@ -0,0 +1,102 @@
+//********************************************************************
+//  File:    testDenseTransforms.cpp
+//  Date:    Fri, 16 Oct 2026: 23:46
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_DENSE_TRANSFORMS
+#include "testDenseTransforms.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+using namespace muggy;
+
+namespace
+{
+    constexpr uint32_t roundCount{ 20 };
+    constexpr uint32_t changesPerRound{ 5'000 };
+
+    std::mt19937 rng{ 3 };
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    bool ok{ true };
+    for ( uint32_t r{ 0 }; r < roundCount; r++ )
+    {
+        churn( r );
+        const bool roundOk{ verify() };
+        std::cout << "round " << r << ": " << m_Entities.size() << " entities, "
+                  << transform::getTransformCount() << " transforms stored, "
+                  << ( roundOk ? "ok" : "FAILED" ) << std::endl;
+        ok = ok && roundOk;
+    }
+    assert( ok );
+}
+
+void engineTest::shutdown( void ) 
+{
+    for ( game_entity::entity e : m_Entities )
+    {
+        game_entity::removeGameEntity( e );
+    }
+    m_Entities.clear();
+}
+
+void engineTest::churn( uint32_t round )
+{
+    for ( uint32_t i{ 0 }; i < changesPerRound; i++ )
+    {
+        // Grow during the first half of the rounds, shrink after
+        const bool create{ ( rng() % 4 ) < ( round < roundCount / 2 ? 3u : 1u ) };
+        if ( create || m_Entities.empty() )
+        {
+            // The position identifies the entity that owns a row
+            transform::init_info transformInfo{};
+            game_entity::entity_info entityInfo{ &transformInfo };
+            game_entity::entity e{ game_entity::createGameEntity( entityInfo ) };
+            e.getTransform().setPosition( math::fv3d{ (float)id::index( e.getId() ), 0.0f, 0.0f } );
+            m_Entities.push_back( e );
+        }
+        else
+        {
+            const uint32_t index{ (uint32_t)( rng() % m_Entities.size() ) };
+            game_entity::removeGameEntity( m_Entities[ index ] );
+            utils::erase_unordered( m_Entities, index );
+        }
+    }
+}
+
+bool engineTest::verify( void )
+{
+    bool ok{ transform::getTransformCount() == m_Entities.size() };
+    utils::vector<id::id_type> visited;
+    transform::forEachTransform( [&]( const id::id_type* ids, const math::fv3d* positions,
+                                      const math::fv4d*, const math::fv3d*, uint32_t count )
+        {
+            for ( uint32_t i{ 0 }; i < count; i++ )
+            {
+                const game_entity::entity e{ game_entity::entity_id{ ids[ i ] } };
+                ok = ok && game_entity::isAlive( e );
+                ok = ok && positions[ i ].x == (float)id::index( ids[ i ] );
+                visited.push_back( ids[ i ] );
+            }
+        } );
+
+    // Every entity must have been visited exactly once
+    std::sort( visited.begin(), visited.end() );
+    ok = ok && std::adjacent_find( visited.begin(), visited.end() ) == visited.end();
+    return ok && visited.size() == m_Entities.size();
+}
+
+#endif
@@ -0,0 +1,36 @@
+//********************************************************************
+//  File:    testDenseTransforms.h
+//  Date:    Fri, 16 Oct 2026: 23:40
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_DENSE_TRANSFORMS_H)
+#define TEST_DENSE_TRANSFORMS_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Creates and removes random entities, which moves rows around in
+    // the chunk storage
+    void churn( uint32_t round );
+    // Checks that forEachTransform() visits every alive entity exactly
+    // once, with its own transform, and nothing else
+    bool verify( void );
+
+    muggy::utils::vector<muggy::game_entity::entity>    m_Entities;
+};
+
+
+#endif
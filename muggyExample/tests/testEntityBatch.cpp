@@ -0,0 +1,144 @@
+//********************************************************************
+//  File:    testEntityBatch.cpp
+//  Date:    Sat, 17 Oct 2026: 03:14
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_ENTITY_BATCH
+#include "testEntityBatch.h"
+
+#include <iostream>
+#include <chrono>
+
+using namespace muggy;
+
+namespace
+{
+    using clock_type = std::chrono::high_resolution_clock;
+
+    constexpr uint32_t entityCounts[]{ 50'000, 100'000, 200'000 };
+    constexpr uint32_t maxEntityCount{ 200'000 };
+
+    double elapsedNs( clock_type::time_point start )
+    {
+        return (double)std::chrono::duration_cast<std::chrono::nanoseconds>( 
+                            clock_type::now() - start ).count();
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    m_TransformInfos.resize( maxEntityCount );
+    m_EntityInfos.resize( maxEntityCount );
+    m_Entities.resize( maxEntityCount );
+    for ( uint32_t i{ 0 }; i < maxEntityCount; i++ )
+    {
+        m_TransformInfos[ i ].position[ 0 ] = (float)i;
+        m_EntityInfos[ i ].transform = &m_TransformInfos[ i ];
+    }
+
+    game_entity::prefab p;
+    p.addNode( transform::init_info{ } );
+    m_Prefab = game_entity::registerPrefab( p );
+
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    // Warm up, so that both paths run with the id free list and the
+    // storage in the same state
+    runSingle( maxEntityCount );
+    runBatch( maxEntityCount );
+    runPrefab( maxEntityCount );
+
+    for ( uint32_t count : entityCounts )
+    {
+        runSingle( count );
+        runBatch( count );
+        runPrefab( count );
+    }
+}
+
+void engineTest::shutdown( void ) 
+{
+    game_entity::unregisterPrefab( m_Prefab );
+
+}
+
+void engineTest::runSingle( uint32_t count )
+{
+    clock_type::time_point start{ clock_type::now() };
+    for ( uint32_t i{ 0 }; i < count; i++ )
+    {
+        m_Entities[ i ] = game_entity::createGameEntity( m_EntityInfos[ i ] );
+    }
+    const double createTime{ elapsedNs( start ) };
+
+    start = clock_type::now();
+    for ( uint32_t i{ 0 }; i < count; i++ )
+    {
+        game_entity::removeGameEntity( m_Entities[ i ] );
+    }
+    const double removeTime{ elapsedNs( start ) };
+
+    printResult( "single", count, createTime, removeTime );
+}
+
+void engineTest::runBatch( uint32_t count )
+{
+    const utils::span<const game_entity::entity_info> infos{ m_EntityInfos.data(), count };
+    const utils::span<game_entity::entity> entities{ m_Entities.data(), count };
+
+    clock_type::time_point start{ clock_type::now() };
+    game_entity::createGameEntities( infos, entities );
+    const double createTime{ elapsedNs( start ) };
+
+    // Check that the batch created the same thing as the single path
+    for ( uint32_t i{ 0 }; i < count; i++ )
+    {
+        assert( game_entity::isAlive( entities[ i ] ) );
+        assert( entities[ i ].getTransform().getPosition().x == (float)i );
+    }
+
+    start = clock_type::now();
+    game_entity::removeGameEntities( entities );
+    const double removeTime{ elapsedNs( start ) };
+
+    printResult( "batch", count, createTime, removeTime );
+}
+
+void engineTest::runPrefab( uint32_t count )
+{
+    const utils::span<const transform::init_info> transforms{ m_TransformInfos.data(), count };
+    const utils::span<game_entity::entity> entities{ m_Entities.data(), count };
+
+    clock_type::time_point start{ clock_type::now() };
+    game_entity::instantiate( m_Prefab, count, transforms, entities );
+    const double createTime{ elapsedNs( start ) };
+
+    for ( uint32_t i{ 0 }; i < count; i++ )
+    {
+        assert( game_entity::isAlive( entities[ i ] ) );
+        assert( entities[ i ].getTransform().getPosition().x == (float)i );
+    }
+
+    start = clock_type::now();
+    game_entity::removeGameEntities( entities );
+    const double removeTime{ elapsedNs( start ) };
+
+    printResult( "prefab", count, createTime, removeTime );
+}
+
+void engineTest::printResult( const char* name, uint32_t count, 
+                              double createTime, double removeTime )
+{
+    std::cout << name << " (" << count << " entities): "
+              << "create " << createTime / count << " ns/entity, "
+              << "remove " << removeTime / count << " ns/entity\n";
+}
+
+#endif
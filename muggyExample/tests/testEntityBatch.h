@@ -0,0 +1,42 @@
+//********************************************************************
+//  File:    testEntityBatch.h
+//  Date:    Sat, 17 Oct 2026: 03:10
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_ENTITY_BATCH_H)
+#define TEST_ENTITY_BATCH_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+#include "../../muggy/code/components/prefab.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Creates and removes "count" entities one at a time
+    void runSingle( uint32_t count );
+    // Creates and removes "count" entities with the batch functions
+    void runBatch( uint32_t count );
+    // Creates and removes "count" instances of a single entity prefab
+    void runPrefab( uint32_t count );
+    void printResult( const char* name, uint32_t count, 
+                      double createTime, double removeTime );
+
+    muggy::utils::vector<muggy::transform::init_info>       m_TransformInfos;
+    muggy::utils::vector<muggy::game_entity::entity_info>   m_EntityInfos;
+    muggy::utils::vector<muggy::game_entity::entity>        m_Entities;
+    muggy::game_entity::prefab_id                           m_Prefab{ };
+};
+
+
+#endif
@@ -0,0 +1,316 @@
+//********************************************************************
+//  File:    testHierarchy.cpp
+//  Date:    Sun, 18 Oct 2026: 12:16
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_HIERARCHY
+#include "testHierarchy.h"
+#include "../../muggy/code/components/world.h"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace muggy;
+
+namespace
+{
+    constexpr uint32_t randomCount{ 1'000 };
+    constexpr uint32_t randomRounds{ 10 };
+
+    std::mt19937 rng{ 13 };
+
+    float random( float min, float max )
+    {
+        return std::uniform_real_distribution<float>{ min, max }( rng );
+    }
+
+    // A transform with a random position, rotation and scale
+    transform::init_info randomInfo( transform::component parent = {} )
+    {
+        transform::init_info info{};
+        for ( uint32_t i{ 0 }; i < 3; i++ )
+        {
+            info.position[ i ] = random( -10.0f, 10.0f );
+            info.scale[ i ] = random( 0.5f, 2.0f );
+        }
+        float length{ 0.0f };
+        for ( uint32_t i{ 0 }; i < 4; i++ )
+        {
+            info.rotation[ i ] = random( -1.0f, 1.0f );
+            length += info.rotation[ i ] * info.rotation[ i ];
+        }
+        length = std::sqrt( length );
+        for ( uint32_t i{ 0 }; i < 4; i++ )
+        {
+            info.rotation[ i ] /= length;
+        }
+        info.parent = parent;
+        return info;
+    }
+
+    game_entity::entity create( transform::component parent = {} )
+    {
+        transform::init_info info{ randomInfo( parent ) };
+        return game_entity::createGameEntity( { &info } );
+    }
+
+    math::fmat4 localMatrix( game_entity::entity e )
+    {
+        const transform::component t{ e.getTransform() };
+        return math::fmat4::transformation( t.getPosition(), t.getRotation(), t.getScale() );
+    }
+
+    // The world matrix built by walking up to the root
+    math::fmat4 expectedMatrix( game_entity::entity e )
+    {
+        math::fmat4 result{ localMatrix( e ) };
+        for ( transform::component p{ transform::getParent( e.getTransform() ) }; 
+              p.isValid(); p = transform::getParent( p ) )
+        {
+            math::fmat4 parent{ math::fmat4::transformation( p.getPosition(), p.getRotation(), 
+                                                             p.getScale() ) };
+            parent.multiply( result );
+            result = parent;
+        }
+        return result;
+    }
+
+    bool isClose( const math::fmat4& a, const math::fmat4& b )
+    {
+        for ( uint32_t i{ 0 }; i < 16; i++ )
+        {
+            if ( std::fabs( a.elements[ i ] - b.elements[ i ] ) > 
+                 1e-3f * std::max( 1.0f, std::fabs( b.elements[ i ] ) ) )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isSame( const math::fmat4& a, const math::fmat4& b )
+    {
+        for ( uint32_t i{ 0 }; i < 16; i++ )
+        {
+            if ( a.elements[ i ] != b.elements[ i ] )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isUpToDate( game_entity::entity e )
+    {
+        return isClose( e.getTransform().getWorldMatrix(), expectedMatrix( e ) );
+    }
+
+    void move( game_entity::entity e )
+    {
+        const transform::component t{ e.getTransform() };
+        math::fv3d p{ t.getPosition() };
+        p.x += 1.0f;
+        t.setPosition( p );
+    }
+
+    bool report( const char* name, bool ok )
+    {
+        std::cout << name << ": " << ( ok ? "ok" : "FAILED" ) << std::endl;
+        return ok;
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    bool ok{ true };
+    ok = report( "chain", checkChain() ) && ok;
+    ok = report( "reparent", checkReparent() ) && ok;
+    ok = report( "subtree", checkSubtree() ) && ok;
+    ok = report( "removed parent", checkRemovedParent() ) && ok;
+    ok = report( "cycles", checkCycles() ) && ok;
+    ok = report( "random", checkRandom() ) && ok;
+    assert( ok );
+}
+
+void engineTest::shutdown( void ) 
+{
+}
+
+bool engineTest::checkChain( void )
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    const game_entity::entity root{ create() };
+    const game_entity::entity child{ create( root.getTransform() ) };
+    const game_entity::entity grandchild{ create( child.getTransform() ) };
+    transform::updateWorldMatrices();
+
+    math::fmat4 expected{ localMatrix( root ) };
+    bool ok{ isClose( root.getTransform().getWorldMatrix(), expected ) };
+    expected.multiply( localMatrix( child ) );
+    ok = ok && isClose( child.getTransform().getWorldMatrix(), expected );
+    expected.multiply( localMatrix( grandchild ) );
+    ok = ok && isClose( grandchild.getTransform().getWorldMatrix(), expected );
+    return ok && transform::getParent( grandchild.getTransform() ).getId() == 
+                 child.getTransform().getId();
+}
+
+bool engineTest::checkReparent( void )
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    // The children come first, so their parents end up after them
+    const game_entity::entity child{ create() };
+    const game_entity::entity grandchild{ create( child.getTransform() ) };
+    const game_entity::entity root{ create() };
+    transform::updateWorldMatrices();
+
+    bool ok{ transform::setParent( child.getTransform(), root.getTransform() ) };
+    transform::updateWorldMatrices();
+    ok = ok && isUpToDate( root ) && isUpToDate( child ) && isUpToDate( grandchild );
+
+    // And detached again
+    ok = ok && transform::setParent( child.getTransform(), {} );
+    transform::updateWorldMatrices();
+    return ok && !transform::getParent( child.getTransform() ).isValid() &&
+           isSame( child.getTransform().getWorldMatrix(), localMatrix( child ) ) &&
+           isUpToDate( grandchild );
+}
+
+bool engineTest::checkSubtree( void )
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    const game_entity::entity root{ create() };
+    const game_entity::entity child{ create( root.getTransform() ) };
+    const game_entity::entity grandchild{ create( child.getTransform() ) };
+    const game_entity::entity other{ create() };
+    const game_entity::entity otherChild{ create( other.getTransform() ) };
+    transform::updateWorldMatrices();
+    const math::fmat4 otherWorld{ otherChild.getTransform().getWorldMatrix() };
+    const math::fmat4 grandchildWorld{ grandchild.getTransform().getWorldMatrix() };
+
+    // Only the root is written, the rest of the chain follows
+    move( root );
+    transform::updateWorldMatrices();
+    bool ok{ isUpToDate( root ) && isUpToDate( child ) && isUpToDate( grandchild ) &&
+             !isClose( grandchild.getTransform().getWorldMatrix(), grandchildWorld ) };
+    ok = ok && isSame( otherChild.getTransform().getWorldMatrix(), otherWorld );
+
+    // A leaf moves alone
+    const math::fmat4 childWorld{ child.getTransform().getWorldMatrix() };
+    move( grandchild );
+    transform::updateWorldMatrices();
+    return ok && isUpToDate( grandchild ) && 
+           isSame( child.getTransform().getWorldMatrix(), childWorld );
+}
+
+bool engineTest::checkRemovedParent( void )
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    const game_entity::entity root{ create() };
+    const game_entity::entity child{ create( root.getTransform() ) };
+    const game_entity::entity grandchild{ create( child.getTransform() ) };
+    const game_entity::entity sibling{ create( child.getTransform() ) };
+    transform::updateWorldMatrices();
+
+    game_entity::removeGameEntity( child );
+    transform::updateWorldMatrices();
+    bool ok{ !transform::getParent( grandchild.getTransform() ).isValid() &&
+             !transform::getParent( sibling.getTransform() ).isValid() };
+    ok = ok && isSame( grandchild.getTransform().getWorldMatrix(), localMatrix( grandchild ) ) &&
+         isSame( sibling.getTransform().getWorldMatrix(), localMatrix( sibling ) );
+
+    // Moving the old root doesn't touch them any more
+    const math::fmat4 grandchildWorld{ grandchild.getTransform().getWorldMatrix() };
+    move( root );
+    transform::updateWorldMatrices();
+    return ok && isSame( grandchild.getTransform().getWorldMatrix(), grandchildWorld ) &&
+           transform::getTransformCount() == 3;
+}
+
+bool engineTest::checkCycles( void )
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    const game_entity::entity root{ create() };
+    const game_entity::entity child{ create( root.getTransform() ) };
+    const game_entity::entity grandchild{ create( child.getTransform() ) };
+    transform::updateWorldMatrices();
+
+    bool ok{ !transform::setParent( root.getTransform(), grandchild.getTransform() ) };
+    ok = ok && !transform::setParent( child.getTransform(), child.getTransform() );
+    ok = ok && !transform::setParent( root.getTransform(), child.getTransform() );
+    ok = ok && !transform::getParent( root.getTransform() ).isValid() &&
+         transform::getParent( child.getTransform() ).getId() == root.getTransform().getId();
+
+    // Below a removed node the old links don't count
+    const game_entity::entity other{ create() };
+    ok = ok && transform::setParent( other.getTransform(), grandchild.getTransform() );
+    game_entity::removeGameEntity( child );
+    ok = ok && transform::setParent( root.getTransform(), other.getTransform() );
+
+    // This has to return
+    transform::updateWorldMatrices();
+    return ok && isUpToDate( root ) && isUpToDate( grandchild ) && isUpToDate( other );
+}
+
+bool engineTest::checkRandom( void )
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    utils::vector<game_entity::entity> entities;
+    for ( uint32_t i{ 0 }; i < randomCount; i++ )
+    {
+        const bool isRoot{ entities.empty() || rng() % 4 == 0 };
+        entities.push_back( create( isRoot ? transform::component{} :
+                                    entities[ rng() % entities.size() ].getTransform() ) );
+    }
+
+    bool ok{ true };
+    for ( uint32_t r{ 0 }; r < randomRounds && ok; r++ )
+    {
+        for ( uint32_t i{ 0 }; i < randomCount / 10; i++ )
+        {
+            const game_entity::entity a{ entities[ rng() % entities.size() ] };
+            const game_entity::entity b{ entities[ rng() % entities.size() ] };
+            // Refused when b is below a, which the test doesn't track
+            transform::setParent( a.getTransform(), 
+                                  rng() % 8 ? b.getTransform() : transform::component{} );
+        }
+        for ( uint32_t i{ 0 }; i < randomCount / 10; i++ )
+        {
+            move( entities[ rng() % entities.size() ] );
+        }
+        for ( uint32_t i{ 0 }; i < randomCount / 100 && entities.size() > 1; i++ )
+        {
+            const uint32_t index{ (uint32_t)( rng() % entities.size() ) };
+            game_entity::removeGameEntity( entities[ index ] );
+            utils::erase_unordered( entities, index );
+        }
+        for ( uint32_t i{ 0 }; i < randomCount / 100; i++ )
+        {
+            entities.push_back( create( entities[ rng() % entities.size() ].getTransform() ) );
+        }
+
+        transform::updateWorldMatrices();
+        for ( const game_entity::entity e : entities )
+        {
+            ok = ok && isUpToDate( e );
+        }
+    }
+    return ok;
+}
+
+#endif
@@ -0,0 +1,43 @@
+//********************************************************************
+//  File:    testHierarchy.h
+//  Date:    Sun, 18 Oct 2026: 12:10
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_HIERARCHY_H)
+#define TEST_HIERARCHY_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // World matrices of a three level chain are the products of the
+    // local matrices down the chain
+    bool checkChain( void );
+    // Attaching a child to a parent that was created after it, which
+    // makes the update sort the nodes again
+    bool checkReparent( void );
+    // Moving a parent updates its whole subtree and nothing else
+    bool checkSubtree( void );
+    // Children of a removed parent become roots
+    bool checkRemovedParent( void );
+    // Parents that would make a cycle are refused
+    bool checkCycles( void );
+    // A random forest that is reparented, moved and pruned for a few
+    // rounds, compared with matrices built by walking up each chain
+    bool checkRandom( void );
+};
+
+
+#endif
@@ -0,0 +1,165 @@
+//********************************************************************
+//  File:    testInterpolation.cpp
+//  Date:    Sat, 17 Oct 2026: 21:48
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_INTERPOLATION
+#include "testInterpolation.h"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+
+using namespace muggy;
+
+namespace
+{
+    constexpr uint32_t tickCount{ 300 };
+    constexpr uint32_t createdPerTick{ 200 };
+    constexpr uint32_t removedPerTick{ 50 };
+    // Sort often enough that rows move between captures
+    constexpr uint32_t ticksPerSort{ 50 };
+    constexpr float alpha{ 0.25f };
+
+    bool report( const char* name, bool ok )
+    {
+        std::cout << name << ": " << ( ok ? "ok" : "FAILED" ) << std::endl;
+        return ok;
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    m_World = new ecs::world{};
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    // The simulation and the render thread share nothing but the world,
+    // which hands frames over through its triple buffer
+    uint32_t frameCount{ 0 };
+    uint32_t badFrames{ 0 };
+    std::thread simulation{ [this]() { simulate(); } };
+    std::thread renderer{ [this, &frameCount, &badFrames]() 
+                          { 
+                              badFrames = render( frameCount ); 
+                          } };
+    simulation.join();
+    renderer.join();
+
+    std::cout << frameCount << " frames rendered during " << tickCount << " ticks" << std::endl;
+    bool ok{ true };
+    ok = report( "frames match their tick", !badFrames ) && ok;
+
+    // The render side has finished, so this thread can take over as
+    // the reader and must be handed the last capture
+    ecs::world_scope scope{ *m_World };
+    const transform::interpolation_frame* last{ transform::acquireInterpolationFrame() };
+    ok = report( "last capture published", 
+                 last && last->tick == tickCount && checkFrame( *last ) ) && ok;
+    assert( ok );
+}
+
+void engineTest::shutdown( void ) 
+{
+    delete m_World;
+    m_World = nullptr;
+}
+
+void engineTest::simulate( void )
+{
+    ecs::world_scope scope{ *m_World };
+    std::mt19937 rng{ 3 };
+    utils::vector<math::fv3d> positions;
+    for ( uint32_t tick{ 1 }; tick <= tickCount; tick++ )
+    {
+        // New entities start at the current tick, so they have nothing
+        // to interpolate from
+        transform::init_info transformInfo{};
+        transformInfo.position[ 0 ] = (float)tick;
+        transformInfo.position[ 1 ] = (float)tick;
+        transformInfo.position[ 2 ] = (float)tick;
+        transformInfo.rotation[ 3 ] = 1.0f;
+        const game_entity::entity_info entityInfo{ &transformInfo };
+        for ( uint32_t i{ 0 }; i < createdPerTick; i++ )
+        {
+            m_Entities.push_back( game_entity::createGameEntity( entityInfo ) );
+        }
+        for ( uint32_t i{ 0 }; i < removedPerTick; i++ )
+        {
+            const uint32_t index{ (uint32_t)( rng() % m_Entities.size() ) };
+            game_entity::removeGameEntity( m_Entities[ index ] );
+            utils::erase_unordered( m_Entities, index );
+        }
+
+        positions.resize( m_Entities.size() );
+        for ( math::fv3d& p : positions )
+        {
+            p = math::fv3d{ (float)tick, (float)tick, (float)tick };
+        }
+        transform::setPositions( m_Entities, positions );
+        if ( !( tick % ticksPerSort ) )
+        {
+            while ( !transform::spatialSortStep( 100'000 ) ) { }
+        }
+        transform::captureTransforms();
+    }
+    m_Done.store( true, std::memory_order_release );
+}
+
+uint32_t engineTest::render( uint32_t& frameCount )
+{
+    ecs::world_scope scope{ *m_World };
+    uint32_t badFrames{ 0 };
+    uint64_t lastTick{ 0 };
+    while ( !m_Done.load( std::memory_order_acquire ) )
+    {
+        const transform::interpolation_frame* frame{ transform::acquireInterpolationFrame() };
+        if ( !frame )
+        {
+            continue;
+        }
+        // Ticks never go backwards, and every frame has to be complete
+        // even though the simulation keeps writing the next one
+        if ( frame->tick < lastTick || !checkFrame( *frame ) )
+        {
+            badFrames++;
+        }
+        lastTick = frame->tick;
+        frameCount++;
+    }
+    return badFrames;
+}
+
+bool engineTest::checkFrame( const transform::interpolation_frame& frame )
+{
+    const uint32_t count{ (uint32_t)frame.ids.size() };
+    utils::vector<math::fv3d> positions( count );
+    utils::vector<math::fv4d> rotations( count );
+    utils::vector<math::fv3d> scales( count );
+    transform::interpolateTransforms( frame, alpha, 0, positions, rotations, scales );
+
+    // Entities that existed in the previous tick move from tick - 1 to
+    // tick, new ones stay at tick
+    const float tick{ (float)frame.tick };
+    bool ok{ count == frame.tick * ( createdPerTick - removedPerTick ) };
+    for ( uint32_t i{ 0 }; i < count && ok; i++ )
+    {
+        const bool isNew{ frame.previousPositions[ i ].x == tick };
+        const float expected{ isNew ? tick : tick - 1.0f + alpha };
+        ok = frame.positions[ i ].x == tick &&
+             std::fabs( positions[ i ].x - expected ) < 1e-4f &&
+             positions[ i ].x == positions[ i ].z &&
+             rotations[ i ].w == 1.0f &&
+             scales[ i ].y == 1.0f;
+    }
+    return ok;
+}
+
+#endif
@@ -0,0 +1,43 @@
+//********************************************************************
+//  File:    testInterpolation.h
+//  Date:    Sat, 17 Oct 2026: 21:40
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_INTERPOLATION_H)
+#define TEST_INTERPOLATION_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+#include "../../muggy/code/components/world.h"
+
+#include <atomic>
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Runs the fixed ticks of the world: creates and removes entities,
+    // moves all of them to the tick number and captures the transforms
+    void simulate( void );
+    // Acquires and interpolates frames until the simulation is done.
+    // Returns the number of frames that didn't match their tick
+    uint32_t render( uint32_t& frameCount );
+    // Checks a single frame, see render()
+    static bool checkFrame( const muggy::transform::interpolation_frame& frame );
+
+    muggy::ecs::world*                                  m_World{ nullptr };
+    muggy::utils::vector<muggy::game_entity::entity>    m_Entities;
+    std::atomic<bool>                                   m_Done{ false };
+};
+
+
+#endif
@@ -0,0 +1,163 @@
+//********************************************************************
+//  File:    testMat4Batch.cpp
+//  Date:    Sun, 18 Oct 2026: 11:26
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_MAT4_BATCH
+#include "testMat4Batch.h"
+#include "../../muggy/code/math/mat4Batch.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace muggy;
+
+namespace
+{
+    using clock_type = std::chrono::high_resolution_clock;
+
+    constexpr uint32_t transformCount{ 1'000'000 };
+    // Not a multiple of four, so the scalar tail runs as well
+    constexpr uint32_t checkedCount{ 1'003 };
+    constexpr uint32_t timingRuns{ 10 };
+
+    std::mt19937 rng{ 3 };
+
+    float random( float min, float max )
+    {
+        return std::uniform_real_distribution<float>{ min, max }( rng );
+    }
+
+    double elapsedMs( clock_type::time_point start )
+    {
+        return std::chrono::duration<double, std::milli>( 
+                    clock_type::now() - start ).count();
+    }
+
+    bool isClose( const math::fmat4& a, const math::fmat4& b )
+    {
+        for ( uint32_t i{ 0 }; i < 16; i++ )
+        {
+            if ( std::fabs( a.elements[ i ] - b.elements[ i ] ) > 
+                 1e-5f * std::max( 1.0f, std::fabs( b.elements[ i ] ) ) )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Builds "count" matrices starting at "first" with the batch
+    // builder and checks them against fmat4::transformation(). The
+    // matrix after the last one must not be written
+    bool matches( const math::fv3d* positions, const math::fv4d* rotations,
+                  const math::fv3d* scales, uint32_t count )
+    {
+        utils::vector<math::fmat4> matrices( count + 1, math::fmat4{ -1.0f } );
+        math::buildTransformMatrices( positions, rotations, scales, matrices.data(), count );
+        bool ok{ true };
+        for ( uint32_t i{ 0 }; i < count && ok; i++ )
+        {
+            ok = isClose( matrices[ i ], math::fmat4::transformation( 
+                                            positions[ i ], rotations[ i ], scales[ i ] ) );
+        }
+        return ok && isClose( matrices[ count ], math::fmat4{ -1.0f } );
+    }
+
+    bool report( const char* name, bool ok )
+    {
+        std::cout << name << ": " << ( ok ? "ok" : "FAILED" ) << std::endl;
+        return ok;
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    m_Positions.resize( transformCount );
+    m_Rotations.resize( transformCount );
+    m_Scales.resize( transformCount );
+    for ( uint32_t i{ 0 }; i < transformCount; i++ )
+    {
+        m_Positions[ i ] = math::fv3d{ random( -1000.0f, 1000.0f ), random( -1000.0f, 1000.0f ),
+                                       random( -1000.0f, 1000.0f ) };
+        math::fv4d q{ random( -1.0f, 1.0f ), random( -1.0f, 1.0f ), 
+                      random( -1.0f, 1.0f ), random( -1.0f, 1.0f ) };
+        const float length{ std::sqrt( q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w ) };
+        m_Rotations[ i ] = math::fv4d{ q.x / length, q.y / length, q.z / length, q.w / length };
+        m_Scales[ i ] = math::fv3d{ random( 0.1f, 10.0f ), random( 0.1f, 10.0f ), 
+                                    random( 0.1f, 10.0f ) };
+    }
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    bool ok{ true };
+    ok = report( "matches transformation", checkMatches() ) && ok;
+    ok = report( "timing", checkTiming() ) && ok;
+    assert( ok );
+}
+
+void engineTest::shutdown( void ) 
+{
+}
+
+bool engineTest::checkMatches( void )
+{
+    bool ok{ true };
+    for ( uint32_t count{ 0 }; count <= 12; count++ )
+    {
+        ok = ok && matches( m_Positions.data(), m_Rotations.data(), m_Scales.data(), count );
+    }
+    ok = ok && matches( m_Positions.data(), m_Rotations.data(), m_Scales.data(), checkedCount );
+    // Every offset from a 16 byte boundary of the vec3 streams
+    for ( uint32_t first{ 1 }; first < 4; first++ )
+    {
+        ok = ok && matches( m_Positions.data() + first, m_Rotations.data() + first, 
+                            m_Scales.data() + first, checkedCount );
+    }
+    return ok;
+}
+
+bool engineTest::checkTiming( void )
+{
+    utils::vector<math::fmat4> batched( transformCount );
+    utils::vector<math::fmat4> scalar( transformCount );
+
+    // Best of a few runs, the first one also faults in the pages
+    double batchMs{ 1e9 };
+    double scalarMs{ 1e9 };
+    for ( uint32_t r{ 0 }; r < timingRuns; r++ )
+    {
+        clock_type::time_point start{ clock_type::now() };
+        math::buildTransformMatrices( m_Positions.data(), m_Rotations.data(), m_Scales.data(),
+                                      batched.data(), transformCount );
+        batchMs = std::min( batchMs, elapsedMs( start ) );
+
+        start = clock_type::now();
+        for ( uint32_t i{ 0 }; i < transformCount; i++ )
+        {
+            scalar[ i ] = math::fmat4::transformation( m_Positions[ i ], m_Rotations[ i ], 
+                                                       m_Scales[ i ] );
+        }
+        scalarMs = std::min( scalarMs, elapsedMs( start ) );
+    }
+    std::cout << "    " << transformCount << " matrices: batch " << batchMs 
+              << " ms, transformation() " << scalarMs << " ms" << std::endl;
+
+    // Both loops must have built the same matrices
+    bool ok{ true };
+    for ( uint32_t i{ 0 }; i < transformCount && ok; i += 997 )
+    {
+        ok = isClose( batched[ i ], scalar[ i ] );
+    }
+    return ok;
+}
+
+#endif
@@ -0,0 +1,38 @@
+//********************************************************************
+//  File:    testMat4Batch.h
+//  Date:    Sun, 18 Oct 2026: 11:20
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_MAT4_BATCH_H)
+#define TEST_MAT4_BATCH_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Compares buildTransformMatrices() with fmat4::transformation()
+    // for every count up to a few batches of four, for a large count
+    // that ends in a partial batch and for streams that don't start
+    // on a 16 byte boundary
+    bool checkMatches( void );
+    // Times a million matrices with the batch builder and with
+    // fmat4::transformation()
+    bool checkTiming( void );
+
+    muggy::utils::vector<muggy::math::fv3d>     m_Positions;
+    muggy::utils::vector<muggy::math::fv4d>     m_Rotations;
+    muggy::utils::vector<muggy::math::fv3d>     m_Scales;
+};
+
+
+#endif
@@ -0,0 +1,164 @@
+//********************************************************************
+//  File:    testNames.cpp
+//  Date:    Sat, 17 Oct 2026: 23:18
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_NAMES
+#include "testNames.h"
+
+#include <iostream>
+#include <random>
+
+using namespace muggy;
+using namespace muggy::game_entity::literals;
+
+namespace
+{
+    constexpr uint32_t entityCount{ 1'000 };
+    constexpr uint32_t roundCount{ 20 };
+    constexpr uint32_t renamesPerRound{ 500 };
+
+    std::mt19937 rng{ 11 };
+
+    std::string makeName( const char* prefix, uint32_t i )
+    {
+        return std::string{ prefix } + "_" + std::to_string( i );
+    }
+
+    bool report( const char* name, bool ok )
+    {
+        std::cout << name << ": " << ( ok ? "ok" : "FAILED" ) << std::endl;
+        return ok;
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    for ( uint32_t i{ 0 }; i < entityCount; i++ )
+    {
+        m_Entities.push_back( createEntity() );
+    }
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    bool ok{ true };
+    ok = report( "lookup", checkLookup() ) && ok;
+    ok = report( "removal", checkRemoval() ) && ok;
+    ok = report( "compaction", checkCompaction() ) && ok;
+    assert( ok );
+}
+
+void engineTest::shutdown( void ) 
+{
+    game_entity::removeGameEntities( m_Entities );
+    m_Entities.clear();
+    m_Expected.clear();
+}
+
+game_entity::entity engineTest::createEntity( void )
+{
+    transform::init_info transformInfo{};
+    return game_entity::createGameEntity( game_entity::entity_info{ &transformInfo } );
+}
+
+bool engineTest::checkLookup( void )
+{
+    bool ok{ true };
+    for ( uint32_t i{ 0 }; i < entityCount; i++ )
+    {
+        const std::string name{ makeName( "entity", i ) };
+        ok = game_entity::setName( m_Entities[ i ], name ) && ok;
+        m_Expected[ name ] = m_Entities[ i ];
+    }
+    ok = verify() && ok;
+
+    // Hashed at compile time, and the same hash as the runtime string
+    constexpr game_entity::entity_name first{ "entity_0" };
+    static_assert( first.hash == utils::hashString( "entity_0" ) );
+    ok = ok && game_entity::findEntity( first ).getId() == m_Entities[ 0 ].getId();
+    ok = ok && game_entity::findEntity( "entity_999"_name ).getId() == m_Entities[ 999 ].getId();
+    ok = ok && !game_entity::findEntity( "entity_1000"_name ).isValid();
+    return ok;
+}
+
+bool engineTest::checkRemoval( void )
+{
+    // Taken by another entity, or already the name of this one
+    bool ok{ !game_entity::setName( m_Entities[ 1 ], "entity_2" ) };
+    ok = ok && game_entity::setName( m_Entities[ 2 ], "entity_2" );
+    ok = ok && game_entity::getName( m_Entities[ 1 ] ) == "entity_1";
+
+    // Cleared names are free for others
+    game_entity::clearName( m_Entities[ 3 ] );
+    m_Expected.erase( "entity_3" );
+    ok = ok && game_entity::getName( m_Entities[ 3 ] ).empty();
+    ok = ok && !game_entity::findEntity( "entity_3"_name ).isValid();
+    ok = ok && game_entity::setName( m_Entities[ 4 ], "entity_3" );
+    m_Expected.erase( "entity_4" );
+    m_Expected[ "entity_3" ] = m_Entities[ 4 ];
+
+    // So are the names of removed entities, also when the entity that
+    // takes them reuses the id
+    for ( uint32_t i{ 10 }; i < 20; i++ )
+    {
+        game_entity::removeGameEntity( m_Entities[ i ] );
+        m_Expected.erase( makeName( "entity", i ) );
+        m_Entities[ i ] = createEntity();
+        ok = ok && game_entity::getName( m_Entities[ i ] ).empty();
+    }
+    for ( uint32_t i{ 10 }; i < 20; i++ )
+    {
+        const std::string name{ makeName( "entity", 29 - i ) };
+        ok = ok && game_entity::setName( m_Entities[ i ], name );
+        m_Expected[ name ] = m_Entities[ i ];
+    }
+    return verify() && ok;
+}
+
+bool engineTest::checkCompaction( void )
+{
+    bool ok{ true };
+    uint32_t next{ 0 };
+    for ( uint32_t r{ 0 }; r < roundCount; r++ )
+    {
+        // Long names fill the arena with dead entries quickly
+        for ( uint32_t i{ 0 }; i < renamesPerRound; i++ )
+        {
+            const game_entity::entity e{ m_Entities[ rng() % entityCount ] };
+            const std::string_view old{ game_entity::getName( e ) };
+            if ( !old.empty() )
+            {
+                m_Expected.erase( std::string{ old } );
+            }
+            const std::string name{ makeName( "a_rather_long_name_for_an_entity", next++ ) };
+            ok = game_entity::setName( e, name ) && ok;
+            m_Expected[ name ] = e;
+        }
+        ok = verify() && ok;
+    }
+    return ok;
+}
+
+bool engineTest::verify( void )
+{
+    bool ok{ true };
+    for ( const auto& [name, e] : m_Expected )
+    {
+        ok = ok && game_entity::findEntity( name ).getId() == e.getId() &&
+             game_entity::getName( e ) == name;
+    }
+    uint32_t named{ 0 };
+    for ( const game_entity::entity e : m_Entities )
+    {
+        named += !game_entity::getName( e ).empty();
+    }
+    return ok && named == m_Expected.size();
+}
+
+#endif
@@ -0,0 +1,49 @@
+//********************************************************************
+//  File:    testNames.h
+//  Date:    Sat, 17 Oct 2026: 23:10
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_NAMES_H)
+#define TEST_NAMES_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+#include "../../muggy/code/components/names.h"
+
+#include <string>
+#include <unordered_map>
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Names every entity and finds them again, by literal, by
+    // constexpr name and by string
+    bool checkLookup( void );
+    // Taken names are refused, and names of cleared or removed
+    // entities can be taken again
+    bool checkRemoval( void );
+    // Renames entities until the arena has been compacted many times
+    // and checks every name after each round
+    bool checkCompaction( void );
+    // Checks that the names match m_Expected both ways
+    bool verify( void );
+
+    muggy::game_entity::entity createEntity( void );
+
+    muggy::utils::vector<muggy::game_entity::entity>                m_Entities;
+    // Name of every named entity
+    std::unordered_map<std::string, muggy::game_entity::entity>     m_Expected;
+};
+
+
+#endif
@@ -0,0 +1,218 @@
+//********************************************************************
+//  File:    testObservers.cpp
+//  Date:    Sat, 17 Oct 2026: 22:41
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_OBSERVERS
+#include "testObservers.h"
+#include "../../muggy/code/components/archetype.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace muggy;
+
+namespace
+{
+    constexpr uint32_t batchCount{ 8 };
+    constexpr uint32_t singleCount{ 4 };
+
+    struct health
+    {
+        uint32_t    value;
+    };
+
+    using log_type = utils::vector<engineTest::delivery>;
+
+    void record( ecs::entity_event event, utils::span<const id::id_type> ids, void* context )
+    {
+        engineTest::delivery d{ event, {} };
+        for ( const id::id_type id : ids )
+        {
+            d.ids.push_back( id );
+        }
+        ( (log_type*)context )->push_back( d );
+    }
+
+    void onCreated( utils::span<const id::id_type> ids, void* context )
+    {
+        record( ecs::entity_event::created, ids, context );
+    }
+
+    void onRemoved( utils::span<const id::id_type> ids, void* context )
+    {
+        record( ecs::entity_event::removed, ids, context );
+    }
+
+    void onHealthAdded( utils::span<const id::id_type> ids, void* context )
+    {
+        record( ecs::entity_event::component_added, ids, context );
+    }
+
+    // Creates one entity the first time it is called
+    void onCreatedSpawn( utils::span<const id::id_type> ids, void* context )
+    {
+        onCreated( ids, context );
+        if ( ( (log_type*)context )->size() == 1 )
+        {
+            transform::init_info transformInfo{};
+            game_entity::createGameEntity( game_entity::entity_info{ &transformInfo } );
+        }
+    }
+
+    bool isDelivery( const engineTest::delivery& d, ecs::entity_event event,
+                     const utils::vector<id::id_type>& ids )
+    {
+        return d.event == event && d.ids.size() == ids.size() &&
+               std::equal( ids.begin(), ids.end(), d.ids.begin() );
+    }
+
+    bool isDelivery( const engineTest::delivery& d, ecs::entity_event event, id::id_type id )
+    {
+        return d.event == event && d.ids.size() == 1 && d.ids[ 0 ] == id;
+    }
+
+    bool report( const char* name, bool ok )
+    {
+        std::cout << name << ": " << ( ok ? "ok" : "FAILED" ) << std::endl;
+        return ok;
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    bool ok{ true };
+    ok = report( "batched delivery", checkBatches() ) && ok;
+    ok = report( "events of observers delivered next", checkNextDelivery() ) && ok;
+    ok = report( "unobserved events dropped", checkDropped() ) && ok;
+    assert( ok );
+}
+
+void engineTest::shutdown( void ) 
+{
+    game_entity::forEachAlive( [this]( game_entity::entity e ) { m_Entities.push_back( e ); } );
+    game_entity::removeGameEntities( m_Entities );
+    m_Entities.clear();
+}
+
+game_entity::entity engineTest::createEntity( void )
+{
+    transform::init_info transformInfo{};
+    return game_entity::createGameEntity( game_entity::entity_info{ &transformInfo } );
+}
+
+bool engineTest::checkBatches( void )
+{
+    m_Log.clear();
+    const ecs::observer_id observers[]{
+        ecs::addObserver( ecs::entity_event::removed, onRemoved, &m_Log ),
+        ecs::addComponentObserver<health>( onHealthAdded, &m_Log ),
+        ecs::addObserver( ecs::entity_event::created, onCreated, &m_Log ),
+    };
+
+    // Created in a batch and one by one
+    transform::init_info transformInfo{};
+    const utils::vector<game_entity::entity_info> infos( batchCount, 
+                                                         game_entity::entity_info{ &transformInfo } );
+    utils::vector<game_entity::entity> entities( batchCount );
+    game_entity::createGameEntities( infos, entities );
+    for ( uint32_t i{ 0 }; i < singleCount; i++ )
+    {
+        entities.push_back( createEntity() );
+    }
+    utils::vector<id::id_type> created;
+    for ( const game_entity::entity e : entities )
+    {
+        created.push_back( e.getId() );
+    }
+
+    // Components are added out of order, and to an entity that is
+    // removed before the delivery
+    const uint32_t addedOrder[]{ 3, 1, 9, 5 };
+    utils::vector<id::id_type> added;
+    for ( const uint32_t i : addedOrder )
+    {
+        ecs::addComponent<health>( created[ i ], health{ i } );
+        added.push_back( created[ i ] );
+    }
+    const uint32_t removedOrder[]{ 9, 0, 2 };
+    utils::vector<id::id_type> removed;
+    for ( const uint32_t i : removedOrder )
+    {
+        game_entity::removeGameEntity( entities[ i ] );
+        removed.push_back( created[ i ] );
+    }
+
+    // Nothing is delivered before deliverEvents(), and then every
+    // observer is called once in the documented order
+    bool ok{ m_Log.empty() };
+    ecs::deliverEvents();
+    ok = ok && m_Log.size() == 3 &&
+         isDelivery( m_Log[ 0 ], ecs::entity_event::created, created ) &&
+         isDelivery( m_Log[ 1 ], ecs::entity_event::component_added, added ) &&
+         isDelivery( m_Log[ 2 ], ecs::entity_event::removed, removed );
+
+    // Delivered events are gone
+    ecs::deliverEvents();
+    ok = ok && m_Log.size() == 3;
+
+    for ( const ecs::observer_id o : observers )
+    {
+        ecs::removeObserver( o );
+    }
+    return ok;
+}
+
+bool engineTest::checkNextDelivery( void )
+{
+    m_Log.clear();
+    const ecs::observer_id observer{ 
+        ecs::addObserver( ecs::entity_event::created, onCreatedSpawn, &m_Log ) };
+    const game_entity::entity e{ createEntity() };
+
+    ecs::deliverEvents();
+    bool ok{ m_Log.size() == 1 && 
+             isDelivery( m_Log[ 0 ], ecs::entity_event::created, e.getId() ) };
+
+    // The entity the observer created
+    ecs::deliverEvents();
+    ok = ok && m_Log.size() == 2 && m_Log[ 1 ].ids.size() == 1 &&
+         m_Log[ 1 ].ids[ 0 ] != e.getId() &&
+         game_entity::isAlive( game_entity::entity{ game_entity::entity_id{ m_Log[ 1 ].ids[ 0 ] } } );
+
+    ecs::removeObserver( observer );
+    return ok;
+}
+
+bool engineTest::checkDropped( void )
+{
+    m_Log.clear();
+    ecs::observer_id observer{ ecs::addObserver( ecs::entity_event::removed, onRemoved, &m_Log ) };
+    for ( uint32_t i{ 0 }; i < batchCount; i++ )
+    {
+        game_entity::removeGameEntity( createEntity() );
+    }
+    ecs::removeObserver( observer );
+
+    // A new observer only hears about what happens after it was added
+    observer = ecs::addObserver( ecs::entity_event::removed, onRemoved, &m_Log );
+    const game_entity::entity e{ createEntity() };
+    game_entity::removeGameEntity( e );
+    ecs::deliverEvents();
+    const bool ok{ m_Log.size() == 1 && 
+                   isDelivery( m_Log[ 0 ], ecs::entity_event::removed, e.getId() ) };
+
+    ecs::removeObserver( observer );
+    return ok;
+}
+
+#endif
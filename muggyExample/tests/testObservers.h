@@ -0,0 +1,51 @@
+//********************************************************************
+//  File:    testObservers.h
+//  Date:    Sat, 17 Oct 2026: 22:30
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_OBSERVERS_H)
+#define TEST_OBSERVERS_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+#include "../../muggy/code/components/observer.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+    // One call of an observer
+    struct delivery
+    {
+        muggy::ecs::entity_event                    event;
+        muggy::utils::vector<muggy::id::id_type>    ids;
+    };
+
+private:
+    // Creates, changes and removes entities and checks that one
+    // delivery hands every observer its whole batch, in the order the
+    // events happened: created first, then added components, removed
+    // last
+    bool checkBatches( void );
+    // Entities created by an observer are delivered by the next call
+    bool checkNextDelivery( void );
+    // Removing the last observer of an event drops what was queued
+    // for it
+    bool checkDropped( void );
+
+    muggy::game_entity::entity createEntity( void );
+
+    muggy::utils::vector<delivery>                      m_Log;
+    muggy::utils::vector<muggy::game_entity::entity>    m_Entities;
+};
+
+
+#endif
@@ -0,0 +1,255 @@
+//********************************************************************
+//  File:    testQuery.cpp
+//  Date:    Sun, 18 Oct 2026: 14:06
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_QUERY
+#include "testQuery.h"
+#include "../../muggy/code/components/idAllocator.h"
+#include "../../muggy/code/components/query.h"
+#include "../../muggy/code/components/world.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+using namespace muggy;
+
+namespace
+{
+    constexpr uint32_t entityCount{ 20'000 };
+    constexpr uint32_t writtenCount{ 200 };
+
+    struct health
+    {
+        uint32_t    value;
+    };
+
+    struct armor
+    {
+        uint32_t    value;
+    };
+
+    struct speed
+    {
+        float       value;
+    };
+
+    std::mt19937 rng{ 17 };
+
+    // Entities with health, half of them with armor as well, so there
+    // are two archetypes of many chunks each
+    utils::vector<game_entity::entity> createEntities()
+    {
+        utils::vector<game_entity::entity> entities;
+        transform::init_info info{};
+        for ( uint32_t i{ 0 }; i < entityCount; i++ )
+        {
+            const game_entity::entity e{ game_entity::createGameEntity( { &info } ) };
+            ecs::addComponent<health>( e.getId(), health{ i } );
+            if ( i % 2 )
+            {
+                ecs::addComponent<armor>( e.getId(), armor{ i } );
+            }
+            entities.push_back( e );
+        }
+        return entities;
+    }
+
+    // Chunk of the entity as a single number
+    uint64_t chunkKey( game_entity::entity e )
+    {
+        const ecs::entity_location& location{ ecs::getLocation( e.getId() ) };
+        const uint32_t capacity{ ecs::getArchetypeFromId( location.archetype ).getChunkCapacity() };
+        return ( (uint64_t)location.archetype << 32 ) | ( location.row / capacity );
+    }
+
+    bool report( const char* name, bool ok )
+    {
+        std::cout << name << ": " << ( ok ? "ok" : "FAILED" ) << std::endl;
+        return ok;
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    bool ok{ true };
+    ok = report( "changed since", checkChanged() ) && ok;
+    ok = report( "wraparound", checkWraparound() ) && ok;
+    ok = report( "cached query", checkCache() ) && ok;
+    assert( ok );
+}
+
+void engineTest::shutdown( void ) 
+{
+}
+
+bool engineTest::checkChanged( void )
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    const utils::vector<game_entity::entity> entities{ createEntities() };
+    const uint32_t since{ ecs::advanceVersion() };
+
+    // Write health of a random subset and armor of a few others
+    utils::vector<uint8_t> written( entityCount, 0 );
+    utils::vector<uint64_t> writtenChunks;
+    for ( uint32_t i{ 0 }; i < writtenCount; i++ )
+    {
+        const uint32_t index{ (uint32_t)( rng() % entityCount ) };
+        ecs::writeComponent<health>( entities[ index ].getId() )->value += 1;
+        written[ index ] = 1;
+        writtenChunks.push_back( chunkKey( entities[ index ] ) );
+    }
+    // Only odd entities have armor
+    for ( uint32_t i{ 1 }; i < entityCount; i += 1'002 )
+    {
+        ecs::writeComponent<armor>( entities[ i ].getId() )->value += 1;
+        written[ i ] |= 2;
+    }
+    std::sort( writtenChunks.begin(), writtenChunks.end() );
+    writtenChunks.resize( std::unique( writtenChunks.begin(), writtenChunks.end() ) - 
+                          writtenChunks.begin() );
+
+    // Rows
+    utils::vector<uint32_t> order( game_entity::detail::getIdAllocator().getIndexCount(), 
+                                   uint32_invalid_id );
+    for ( uint32_t i{ 0 }; i < entityCount; i++ )
+    {
+        order[ id::index( entities[ i ].getId() ) ] = i;
+    }
+    utils::vector<uint8_t> visited( entityCount, 0 );
+    uint32_t visitedCount{ 0 };
+    bool ok{ true };
+    ecs::view<health>().changedSince<health>( since ).each( 
+        [&]( id::id_type id, const health& )
+        {
+            const uint32_t i{ order[ id::index( id ) ] };
+            ok = ok && i != uint32_invalid_id && ( written[ i ] & 1 ) && !visited[ i ];
+            visited[ i ] = 1;
+            visitedCount++;
+        } );
+    uint32_t expected{ 0 };
+    for ( uint32_t i{ 0 }; i < entityCount; i++ )
+    {
+        expected += written[ i ] & 1;
+    }
+    ok = ok && visitedCount == expected &&
+         ecs::view<health>().changedSince<health>( since ).count() == expected;
+
+    // Either of two components
+    uint32_t either{ 0 };
+    for ( uint32_t i{ 0 }; i < entityCount; i++ )
+    {
+        either += ( i % 2 ) && written[ i ];
+    }
+    ok = ok && ecs::view<health, armor>().changedSince<health, armor>( since ).count() == either;
+
+    // Chunks
+    utils::vector<uint64_t> chunks;
+    ecs::view<health>().changedSince<health>( since ).eachChunk(
+        [&]( uint32_t count, const id::id_type* ids, const health* )
+        {
+            ok = ok && count;
+            chunks.push_back( chunkKey( game_entity::entity{ game_entity::entity_id{ ids[ 0 ] } } ) );
+        } );
+    ok = ok && chunks.size() == writtenChunks.size();
+    std::sort( chunks.begin(), chunks.end() );
+    for ( uint32_t i{ 0 }; i < chunks.size() && ok; i++ )
+    {
+        ok = chunks[ i ] == writtenChunks[ i ];
+    }
+
+    // Nothing was written since the next version
+    const uint32_t next{ ecs::advanceVersion() };
+    ok = ok && !ecs::view<health>().changedSince<health>( next ).count();
+
+    // Writes through a view are seen as well
+    ecs::view<health>().eachWrite<health>( []( id::id_type, health& h ) { h.value++; } );
+    return ok && ecs::view<health>().changedSince<health>( next ).count() == entityCount;
+}
+
+bool engineTest::checkWraparound( void )
+{
+    // The comparison itself
+    bool ok{ ecs::isNewer( 1, 0xffff'ffffu ) && !ecs::isNewer( 0xffff'ffffu, 1 ) &&
+             ecs::isNewer( 0x8000'0000u, 0x0000'0001u ) && !ecs::isNewer( 5, 5 ) };
+
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    const utils::vector<game_entity::entity> entities{ createEntities() };
+
+    // A system that last ran just before the counter wrapped around
+    // sees every row written after that
+    const uint32_t beforeWrap{ 0u - 16u };
+    ok = ok && ecs::view<health>().changedSince<health>( beforeWrap ).count() == entityCount;
+    uint32_t chunks{ 0 };
+    ecs::view<health>().changedSince<health>( beforeWrap ).eachChunk(
+        [&]( uint32_t, const id::id_type*, const health* ) { chunks++; } );
+    ok = ok && chunks;
+
+    // And a version that is newer than the current one sees nothing
+    const uint32_t ahead{ ecs::getVersion() + 16u };
+    return ok && !ecs::view<health>().changedSince<health>( ahead ).count();
+}
+
+bool engineTest::checkCache( void )
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    const utils::vector<game_entity::entity> entities{ createEntities() };
+
+    // Transform + health and transform + health + armor
+    ecs::query<health> withHealth;
+    bool ok{ withHealth.count() == entityCount };
+    ecs::query_cache direct;
+    uint32_t visited{ 0 };
+    const ecs::component_mask mask{ ecs::componentMask<health>() };
+    direct.forEachChunk( mask, 0, [&]( ecs::archetype&, uint32_t, uint32_t count ) 
+                                  { 
+                                      visited += count; 
+                                  } );
+    ok = ok && visited == entityCount && direct.getMatchCount() == 2;
+
+    // New archetypes, one that matches and one that doesn't
+    ecs::addComponent<speed>( entities[ 0 ].getId(), speed{ 1.0f } );
+    transform::init_info info{};
+    const game_entity::entity plain{ game_entity::createGameEntity( { &info } ) };
+    ecs::addComponent<armor>( plain.getId(), armor{ 0 } );
+
+    visited = 0;
+    direct.forEachChunk( mask, 0, [&]( ecs::archetype&, uint32_t, uint32_t count ) 
+                                  { 
+                                      visited += count; 
+                                  } );
+    ok = ok && visited == entityCount && direct.getMatchCount() == 3;
+    ok = ok && withHealth.count() == entityCount && 
+         withHealth.count() == ecs::view<health>().count();
+
+    // Using it a second time without new archetypes changes nothing
+    direct.forEachChunk( mask, 0, []( ecs::archetype&, uint32_t, uint32_t ) {} );
+    ok = ok && direct.getMatchCount() == 3;
+
+    // Other masks and other worlds start over
+    direct.forEachChunk( mask, ecs::componentMask<armor>(), 
+                         []( ecs::archetype&, uint32_t, uint32_t ) {} );
+    ok = ok && direct.getMatchCount() == 2;
+    {
+        ecs::world other{};
+        ecs::world_scope otherScope{ other };
+        direct.forEachChunk( mask, 0, []( ecs::archetype&, uint32_t, uint32_t ) {} );
+        ok = ok && direct.getMatchCount() == 0 && !withHealth.count();
+    }
+    return ok && withHealth.count() == entityCount;
+}
+
+#endif
@@ -0,0 +1,37 @@
+//********************************************************************
+//  File:    testQuery.h
+//  Date:    Sun, 18 Oct 2026: 14:00
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_QUERY_H)
+#define TEST_QUERY_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // changedSince() visits exactly the rows, and eachChunk() exactly
+    // the chunks, that were written after the version
+    bool checkChanged( void );
+    // A version from before the counter wrapped around is older than
+    // every version after it
+    bool checkWraparound( void );
+    // A cached query picks up archetypes created after it was built
+    // without matching the old ones again
+    bool checkCache( void );
+};
+
+
+#endif
@@ -0,0 +1,176 @@
+//********************************************************************
+//  File:    testSharedWorld.cpp
+//  Date:    Sat, 17 Oct 2026: 23:46
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_SHARED_WORLD
+#include "testSharedWorld.h"
+#include "../../muggy/code/components/idAllocator.h"
+
+#include <iostream>
+#include <random>
+#include <thread>
+
+using namespace muggy;
+
+namespace
+{
+    // All threads work on one world. Single entities are created and
+    // removed all the time, so recycled indices are handed out while
+    // other threads remove entities. Every round also frees more ids
+    // at once than the lock-free batch queue holds
+    constexpr uint32_t roundCount{ 4 };
+    constexpr uint32_t threadCount{ 8 };
+    constexpr uint32_t framesPerRound{ 200 };
+    constexpr uint32_t changesPerFrame{ 200 };
+    constexpr uint32_t batchSize{ 64 };
+    constexpr uint32_t bulkCount{ 50'000 };
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    utils::vector<game_entity::entity> kept[ threadCount ];
+    bool ok{ true };
+    for ( uint32_t r{ 0 }; r < roundCount; r++ )
+    {
+        bool threadOk[ threadCount ]{ };
+        utils::vector<std::thread> threads;
+        for ( uint32_t t{ 0 }; t < threadCount; t++ )
+        {
+            threads.emplace_back( [&world, &kept, &threadOk, t]()
+                                  {
+                                      churn( world, t, kept[ t ], threadOk[ t ] );
+                                  } );
+        }
+        for ( std::thread& t : threads )
+        {
+            t.join();
+        }
+
+        bool roundOk{ verify( kept ) };
+        uint32_t keptCount{ 0 };
+        for ( uint32_t t{ 0 }; t < threadCount; t++ )
+        {
+            roundOk = roundOk && threadOk[ t ];
+            keptCount += (uint32_t)kept[ t ].size();
+        }
+        std::cout << "round " << r << ": " << threadCount << " threads, " 
+                  << keptCount << " entities alive, "
+                  << ( roundOk ? "ok" : "FAILED" ) << std::endl;
+        ok = ok && roundOk;
+    }
+    assert( ok );
+}
+
+void engineTest::shutdown( void ) 
+{
+}
+
+void engineTest::churn( ecs::world& world, uint32_t thread, 
+                        utils::vector<game_entity::entity>& kept, bool& ok )
+{
+    ecs::world_scope scope{ world };
+    std::mt19937 rng{ thread + 1 };
+    ok = true;
+
+    // The position tells which thread an entity belongs to
+    transform::init_info transformInfo{};
+    transformInfo.position[ 0 ] = (float)thread;
+    const game_entity::entity_info entityInfo{ &transformInfo };
+    utils::vector<game_entity::entity> removed;
+    for ( uint32_t f{ 0 }; f < framesPerRound; f++ )
+    {
+        for ( uint32_t i{ 0 }; i < changesPerFrame; i++ )
+        {
+            if ( kept.empty() || rng() % 2 )
+            {
+                const game_entity::entity e{ game_entity::createGameEntity( entityInfo ) };
+                ok = ok && e.isValid() && game_entity::isAlive( e );
+                kept.push_back( e );
+            }
+            else
+            {
+                const uint32_t index{ (uint32_t)( rng() % kept.size() ) };
+                const game_entity::entity e{ kept[ index ] };
+                utils::erase_unordered( kept, index );
+                game_entity::removeGameEntity( e );
+                ok = ok && !game_entity::isAlive( e );
+                removed.push_back( e );
+            }
+        }
+
+        // Batches, with an entity twice in the removed one
+        utils::vector<game_entity::entity_info> batchInfos( batchSize, entityInfo );
+        utils::vector<game_entity::entity> batch( batchSize );
+        game_entity::createGameEntities( batchInfos, batch );
+        for ( const game_entity::entity e : batch )
+        {
+            ok = ok && game_entity::isAlive( e );
+        }
+        const game_entity::entity first{ batch[ 0 ] };
+        batch.push_back( first );
+        game_entity::removeGameEntities( batch );
+        for ( const game_entity::entity e : batch )
+        {
+            ok = ok && !game_entity::isAlive( e );
+        }
+    }
+
+    // Free more ids at once than fit in the lock-free queue
+    utils::vector<game_entity::entity_info> bulkInfos( bulkCount, entityInfo );
+    utils::vector<game_entity::entity> bulk( bulkCount );
+    game_entity::createGameEntities( bulkInfos, bulk );
+    game_entity::removeGameEntities( bulk );
+
+    // Removed entities stay dead even though their indices are reused
+    for ( const game_entity::entity e : removed )
+    {
+        ok = ok && !game_entity::isAlive( e );
+    }
+}
+
+bool engineTest::verify( const utils::vector<game_entity::entity>* kept )
+{
+    bool ok{ true };
+    uint64_t keptCount{ 0 };
+    const id::id_type indexCount{ game_entity::detail::getIdAllocator().getIndexCount() };
+    utils::vector<uint32_t> owner( indexCount, uint32_invalid_id );
+    utils::vector<id::id_type> ids( indexCount, id::invalid_id );
+    for ( uint32_t t{ 0 }; t < threadCount; t++ )
+    {
+        for ( const game_entity::entity e : kept[ t ] )
+        {
+            // No index may be alive twice
+            const id::id_type index{ id::index( e.getId() ) };
+            ok = ok && game_entity::isAlive( e ) && owner[ index ] == uint32_invalid_id;
+            owner[ index ] = t;
+            ids[ index ] = e.getId();
+            ok = ok && e.getTransform().getPosition().x == (float)t;
+        }
+        keptCount += kept[ t ].size();
+    }
+
+    uint64_t aliveCount{ 0 };
+    game_entity::forEachAlive( [&]( game_entity::entity e )
+                               {
+                                   aliveCount++;
+                                   const id::id_type index{ id::index( e.getId() ) };
+                                   const uint32_t t{ owner[ index ] };
+                                   ok = ok && ids[ index ] == e.getId() &&
+                                        e.getTransform().getPosition().x == (float)t;
+                               } );
+    return ok && aliveCount == keptCount;
+}
+
+#endif
@@ -0,0 +1,38 @@
+//********************************************************************
+//  File:    testSharedWorld.h
+//  Date:    Sat, 17 Oct 2026: 23:40
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_SHARED_WORLD_H)
+#define TEST_SHARED_WORLD_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+#include "../../muggy/code/components/world.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Creates and removes entities in the shared world from the
+    // calling thread, one at a time and in batches. Returns the
+    // entities it left alive in "kept"
+    static void churn( muggy::ecs::world& world, uint32_t thread, 
+                       muggy::utils::vector<muggy::game_entity::entity>& kept,
+                       bool& ok );
+    // Checks that isAlive() and forEachAlive() agree on the entities
+    // that the threads kept and that each one is still their own
+    static bool verify( const muggy::utils::vector<muggy::game_entity::entity>* kept );
+};
+
+
+#endif
@@ -0,0 +1,489 @@
+//********************************************************************
+//  File:    testSnapshot.cpp
+//  Date:    Sun, 18 Oct 2026: 10:12
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_SNAPSHOT
+#include "testSnapshot.h"
+#include "../../muggy/code/components/names.h"
+#include "../../muggy/code/components/snapshot.h"
+#include "../../muggy/code/components/world.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace muggy;
+
+namespace
+{
+    constexpr uint32_t rootCount{ 200 };
+    constexpr uint32_t maxDepth{ 3 };
+    const char* const snapshotPath{ "testSnapshot.snapshot" };
+    const char* const damagedPath{ "testSnapshotDamaged.snapshot" };
+
+    struct health
+    {
+        uint32_t    value;
+    };
+
+    // NOTE(klek): Mirrors the header, the start of the archetype records
+    //             and the other records in snapshot.cpp, so files can
+    //             be damaged on purpose. Keep in sync with the file
+    //             format
+    struct snapshot_header
+    {
+        uint32_t    magic;
+        uint32_t    version;
+        uint32_t    idSize;
+        uint32_t    generationBits;
+        uint64_t    fileSize;
+        uint64_t    indexCount;
+        uint64_t    generationsOffset;
+        uint64_t    freeIdCount;
+        uint64_t    freeIdsOffset;
+        uint64_t    parentCount;
+        uint64_t    parentsOffset;
+        uint32_t    componentCount;
+        uint32_t    archetypeCount;
+        uint64_t    componentsOffset;
+        uint64_t    archetypesOffset;
+        uint32_t    tagTypeCount;
+        uint32_t    reserved;
+        uint64_t    tagTypesOffset;
+        uint64_t    tagsOffset;
+        uint64_t    nameCount;
+        uint64_t    namesOffset;
+        uint64_t    nameTextSize;
+        uint64_t    nameTextOffset;
+    };
+
+    struct archetype_record
+    {
+        ecs::component_mask mask;
+        uint64_t            count;
+        uint64_t            idsOffset;
+    };
+
+    struct parent_record
+    {
+        id::id_type child;
+        id::id_type parent;
+    };
+
+    struct name_record
+    {
+        id::id_type id;
+        uint32_t    length;
+        uint64_t    textOffset;
+    };
+
+    // What a saved entity looked like
+    struct saved_entity
+    {
+        game_entity::entity e;
+        bool                alive;
+        math::fv3d          position;
+        math::fv4d          rotation;
+        math::fv3d          scale;
+        math::fmat4         world;
+        id::id_type         parent;
+        bool                hasHealth;
+        uint32_t            health;
+        std::string         name;
+    };
+
+    std::mt19937 rng{ 11 };
+
+    float random( float min, float max )
+    {
+        return std::uniform_real_distribution<float>{ min, max }( rng );
+    }
+
+    bool isClose( const math::fmat4& a, const math::fmat4& b )
+    {
+        for ( uint32_t i{ 0 }; i < 16; i++ )
+        {
+            if ( std::fabs( a.elements[ i ] - b.elements[ i ] ) > 1e-4f )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isSame( const math::fv3d& a, const math::fv3d& b )
+    {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+
+    bool isSame( const math::fv4d& a, const math::fv4d& b )
+    {
+        return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+    }
+
+    utils::vector<uint8_t> readFile( const char* path )
+    {
+        utils::vector<uint8_t> bytes;
+        FILE* file{ fopen( path, "rb" ) };
+        if ( !file )
+        {
+            return bytes;
+        }
+        fseek( file, 0, SEEK_END );
+        bytes.resize( (uint64_t)ftell( file ) );
+        fseek( file, 0, SEEK_SET );
+        const bool ok{ fread( bytes.data(), 1, bytes.size(), file ) == bytes.size() };
+        fclose( file );
+        if ( !ok )
+        {
+            bytes.clear();
+        }
+        return bytes;
+    }
+
+    void writeFile( const char* path, const utils::vector<uint8_t>& bytes )
+    {
+        FILE* file{ fopen( path, "wb" ) };
+        assert( file );
+        fwrite( bytes.data(), 1, bytes.size(), file );
+        fclose( file );
+    }
+
+    template <typename T>
+    T* at( utils::vector<uint8_t>& bytes, uint64_t offset )
+    {
+        return (T*)( bytes.data() + offset );
+    }
+
+    bool report( const char* name, bool ok )
+    {
+        std::cout << name << ": " << ( ok ? "ok" : "FAILED" ) << std::endl;
+        return ok;
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    bool ok{ true };
+    ok = report( "round trip", checkRoundTrip() ) && ok;
+    ok = report( "rejected files", checkRejected() ) && ok;
+    assert( ok );
+}
+
+void engineTest::shutdown( void ) 
+{
+    std::remove( snapshotPath );
+    std::remove( damagedPath );
+}
+
+bool engineTest::checkRoundTrip( void )
+{
+    utils::vector<saved_entity> saved;
+    {
+        ecs::world world{};
+        ecs::world_scope scope{ world };
+
+        // Chains of up to maxDepth children below every root
+        utils::vector<game_entity::entity> entities;
+        for ( uint32_t r{ 0 }; r < rootCount; r++ )
+        {
+            transform::component parent{ };
+            const uint32_t depth{ (uint32_t)( rng() % ( maxDepth + 1 ) ) };
+            for ( uint32_t d{ 0 }; d <= depth; d++ )
+            {
+                transform::init_info info{};
+                for ( uint32_t i{ 0 }; i < 3; i++ )
+                {
+                    info.position[ i ] = random( -100.0f, 100.0f );
+                    info.scale[ i ] = random( 0.5f, 2.0f );
+                }
+                math::fv4d q{ random( -1.0f, 1.0f ), random( -1.0f, 1.0f ), 
+                              random( -1.0f, 1.0f ), random( -1.0f, 1.0f ) };
+                const float length{ std::sqrt( q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w ) };
+                info.rotation[ 0 ] = q.x / length;
+                info.rotation[ 1 ] = q.y / length;
+                info.rotation[ 2 ] = q.z / length;
+                info.rotation[ 3 ] = q.w / length;
+                info.parent = parent;
+                const game_entity::entity e{ game_entity::createGameEntity( { &info } ) };
+                entities.push_back( e );
+                parent = e.getTransform();
+            }
+        }
+
+        // Components on some of them, a few moved to a later root and
+        // a few removed, which leaves holes and orphans
+        for ( uint32_t i{ 0 }; i < entities.size(); i += 3 )
+        {
+            ecs::addComponent<health>( entities[ i ].getId(), health{ i } );
+        }
+        for ( uint32_t i{ 0 }; i < entities.size() / 2; i += 17 )
+        {
+            const game_entity::entity later{ entities[ entities.size() - 1 - i ] };
+            if ( !transform::getParent( entities[ i ].getTransform() ).isValid() )
+            {
+                transform::setParent( entities[ i ].getTransform(), later.getTransform() );
+            }
+        }
+        for ( uint32_t i{ 0 }; i < entities.size(); i += 4 )
+        {
+            game_entity::setName( entities[ i ], "entity_" + std::to_string( i ) );
+        }
+        for ( uint32_t i{ 5 }; i < entities.size(); i += 11 )
+        {
+            game_entity::removeGameEntity( entities[ i ] );
+        }
+        transform::updateWorldMatrices();
+
+        for ( const game_entity::entity e : entities )
+        {
+            saved_entity s{ };
+            s.e = e;
+            s.alive = game_entity::isAlive( e );
+            if ( s.alive )
+            {
+                const transform::component t{ e.getTransform() };
+                s.position = t.getPosition();
+                s.rotation = t.getRotation();
+                s.scale = t.getScale();
+                s.world = t.getWorldMatrix();
+                s.parent = transform::getParent( t ).getId();
+                s.hasHealth = ecs::hasComponent<health>( e.getId() );
+                s.health = s.hasHealth ? ecs::getComponent<health>( e.getId() )->value : 0;
+                s.name = game_entity::getName( e );
+            }
+            saved.push_back( s );
+        }
+        if ( !game_entity::saveSnapshot( snapshotPath ) )
+        {
+            return false;
+        }
+    }
+
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    ecs::componentType<health>();
+    if ( !game_entity::loadSnapshot( snapshotPath ) )
+    {
+        return false;
+    }
+    transform::updateWorldMatrices();
+
+    bool ok{ true };
+    uint32_t aliveCount{ 0 };
+    for ( const saved_entity& s : saved )
+    {
+        ok = ok && game_entity::isAlive( s.e ) == s.alive;
+        if ( !ok || !s.alive )
+        {
+            continue;
+        }
+        aliveCount++;
+        const transform::component t{ s.e.getTransform() };
+        ok = isSame( t.getPosition(), s.position ) && isSame( t.getRotation(), s.rotation ) &&
+             isSame( t.getScale(), s.scale ) && isClose( t.getWorldMatrix(), s.world ) &&
+             transform::getParent( t ).getId() == s.parent &&
+             ecs::hasComponent<health>( s.e.getId() ) == s.hasHealth &&
+             ( !s.hasHealth || ecs::getComponent<health>( s.e.getId() )->value == s.health ) &&
+             game_entity::getName( s.e ) == s.name &&
+             ( s.name.empty() || game_entity::findEntity( s.name ).getId() == s.e.getId() );
+    }
+    ok = ok && transform::getTransformCount() == aliveCount;
+
+    // Moving a loaded root moves its subtree
+    for ( const saved_entity& s : saved )
+    {
+        if ( !ok || !s.alive || !id::isValid( s.parent ) )
+        {
+            continue;
+        }
+        const transform::component parent{ transform::transform_id{ s.parent } };
+        math::fv3d p{ parent.getPosition() };
+        p.x += 10.0f;
+        parent.setPosition( p );
+        transform::updateWorldMatrices();
+        math::fmat4 expected{ parent.getWorldMatrix() };
+        expected.multiply( math::fmat4::transformation( s.position, s.rotation, s.scale ) );
+        ok = isClose( s.e.getTransform().getWorldMatrix(), expected );
+        break;
+    }
+
+    // New entities reuse the free indices without touching loaded ones
+    transform::init_info info{};
+    utils::vector<game_entity::entity> created;
+    for ( uint32_t i{ 0 }; i < 100; i++ )
+    {
+        created.push_back( game_entity::createGameEntity( { &info } ) );
+    }
+    for ( const saved_entity& s : saved )
+    {
+        ok = ok && game_entity::isAlive( s.e ) == s.alive;
+    }
+    for ( const game_entity::entity e : created )
+    {
+        ok = ok && game_entity::isAlive( e );
+    }
+    return ok && transform::getTransformCount() == aliveCount + created.size();
+}
+
+bool engineTest::checkRejected( void )
+{
+    // Two named roots with a child each, one free index and a component
+    {
+        ecs::world world{};
+        ecs::world_scope scope{ world };
+        transform::init_info info{};
+        const game_entity::entity a{ game_entity::createGameEntity( { &info } ) };
+        const game_entity::entity b{ game_entity::createGameEntity( { &info } ) };
+        info.parent = a.getTransform();
+        game_entity::createGameEntity( { &info } );
+        info.parent = b.getTransform();
+        game_entity::createGameEntity( { &info } );
+        info.parent = {};
+        game_entity::removeGameEntity( game_entity::createGameEntity( { &info } ) );
+        ecs::addComponent<health>( a.getId(), health{ 1 } );
+        game_entity::setName( a, "first" );
+        game_entity::setName( b, "second" );
+        if ( !game_entity::saveSnapshot( snapshotPath ) )
+        {
+            return false;
+        }
+    }
+
+    const utils::vector<uint8_t> original{ readFile( snapshotPath ) };
+    if ( original.size() < sizeof( snapshot_header ) )
+    {
+        return false;
+    }
+    const snapshot_header& header{ *(const snapshot_header*)original.data() };
+    if ( header.parentCount != 2 || header.freeIdCount < 1 || !header.archetypeCount ||
+         header.nameCount != 2 )
+    {
+        return false;
+    }
+
+    // Each damage is applied to a fresh copy of the valid file
+    struct damage
+    {
+        const char* name;
+        void      (*apply)( utils::vector<uint8_t>& bytes );
+    };
+    const damage damages[]
+    {
+        { "truncated", []( utils::vector<uint8_t>& bytes ) 
+            { 
+                bytes.resize( bytes.size() - 8 ); 
+            } },
+        { "parent cycle", []( utils::vector<uint8_t>& bytes )
+            {
+                // The children become each other's parent
+                const snapshot_header& h{ *at<snapshot_header>( bytes, 0 ) };
+                parent_record* parents{ at<parent_record>( bytes, h.parentsOffset ) };
+                const parent_record first{ parents[ 0 ] };
+                parents[ 0 ].parent = parents[ 1 ].child;
+                parents[ 1 ].parent = first.child;
+            } },
+        { "own parent", []( utils::vector<uint8_t>& bytes )
+            {
+                const snapshot_header& h{ *at<snapshot_header>( bytes, 0 ) };
+                parent_record* parents{ at<parent_record>( bytes, h.parentsOffset ) };
+                parents[ 0 ].parent = parents[ 0 ].child;
+            } },
+        { "two parents", []( utils::vector<uint8_t>& bytes )
+            {
+                const snapshot_header& h{ *at<snapshot_header>( bytes, 0 ) };
+                parent_record* parents{ at<parent_record>( bytes, h.parentsOffset ) };
+                parents[ 1 ].child = parents[ 0 ].child;
+            } },
+        { "free parent", []( utils::vector<uint8_t>& bytes )
+            {
+                const snapshot_header& h{ *at<snapshot_header>( bytes, 0 ) };
+                parent_record* parents{ at<parent_record>( bytes, h.parentsOffset ) };
+                parents[ 0 ].parent = *at<id::id_type>( bytes, h.freeIdsOffset );
+            } },
+        { "duplicate id", []( utils::vector<uint8_t>& bytes )
+            {
+                const snapshot_header& h{ *at<snapshot_header>( bytes, 0 ) };
+                const archetype_record& a{ *at<archetype_record>( bytes, h.archetypesOffset ) };
+                id::id_type* ids{ at<id::id_type>( bytes, a.idsOffset ) };
+                ids[ a.count - 1 ] = ids[ 0 ];
+            } },
+        { "stored and free", []( utils::vector<uint8_t>& bytes )
+            {
+                const snapshot_header& h{ *at<snapshot_header>( bytes, 0 ) };
+                const archetype_record& a{ *at<archetype_record>( bytes, h.archetypesOffset ) };
+                *at<id::id_type>( bytes, h.freeIdsOffset ) = *at<id::id_type>( bytes, a.idsOffset );
+            } },
+        { "stale id", []( utils::vector<uint8_t>& bytes )
+            {
+                const snapshot_header& h{ *at<snapshot_header>( bytes, 0 ) };
+                const archetype_record& a{ *at<archetype_record>( bytes, h.archetypesOffset ) };
+                id::id_type& id{ *at<id::id_type>( bytes, a.idsOffset ) };
+                id = id::newGeneration( id );
+            } },
+        { "duplicate name", []( utils::vector<uint8_t>& bytes )
+            {
+                const snapshot_header& h{ *at<snapshot_header>( bytes, 0 ) };
+                name_record* names{ at<name_record>( bytes, h.namesOffset ) };
+                names[ 1 ].length = names[ 0 ].length;
+                names[ 1 ].textOffset = names[ 0 ].textOffset;
+            } },
+        { "two names", []( utils::vector<uint8_t>& bytes )
+            {
+                const snapshot_header& h{ *at<snapshot_header>( bytes, 0 ) };
+                name_record* names{ at<name_record>( bytes, h.namesOffset ) };
+                names[ 1 ].id = names[ 0 ].id;
+            } },
+        { "free name", []( utils::vector<uint8_t>& bytes )
+            {
+                const snapshot_header& h{ *at<snapshot_header>( bytes, 0 ) };
+                name_record* names{ at<name_record>( bytes, h.namesOffset ) };
+                names[ 0 ].id = *at<id::id_type>( bytes, h.freeIdsOffset );
+            } },
+        { "name past text", []( utils::vector<uint8_t>& bytes )
+            {
+                const snapshot_header& h{ *at<snapshot_header>( bytes, 0 ) };
+                name_record* names{ at<name_record>( bytes, h.namesOffset ) };
+                names[ 0 ].length = (uint32_t)h.nameTextSize + 1;
+            } },
+    };
+
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    ecs::componentType<health>();
+    bool ok{ true };
+    for ( const damage& d : damages )
+    {
+        utils::vector<uint8_t> bytes{ original };
+        d.apply( bytes );
+        writeFile( damagedPath, bytes );
+        const bool rejected{ !game_entity::loadSnapshot( damagedPath ) &&
+                             !transform::getTransformCount() };
+        if ( !rejected )
+        {
+            std::cout << "    not rejected: " << d.name << std::endl;
+        }
+        ok = ok && rejected;
+    }
+
+    // The world is still empty, so the valid file loads
+    return ok && game_entity::loadSnapshot( snapshotPath ) && 
+           transform::getTransformCount() == 4 &&
+           game_entity::findEntity( "first" ).isValid() &&
+           game_entity::findEntity( "second" ).isValid();
+}
+
+#endif
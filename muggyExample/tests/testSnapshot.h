@@ -0,0 +1,35 @@
+//********************************************************************
+//  File:    testSnapshot.h
+//  Date:    Sun, 18 Oct 2026: 10:05
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_SNAPSHOT_H)
+#define TEST_SNAPSHOT_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Saves a world with a hierarchy, components and removed entities
+    // and checks that every transform, parent, world matrix and
+    // component comes back when it is loaded into another world
+    bool checkRoundTrip( void );
+    // Damages a valid snapshot in several ways and checks that each
+    // file is rejected without loading anything
+    bool checkRejected( void );
+};
+
+
+#endif
@@ -0,0 +1,171 @@
+//********************************************************************
+//  File:    testSpatialSort.cpp
+//  Date:    Sun, 18 Oct 2026: 11:12
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_SPATIAL_SORT
+#include "testSpatialSort.h"
+
+#include <iostream>
+#include <chrono>
+#include <random>
+
+using namespace muggy;
+
+namespace
+{
+    using clock_type = std::chrono::high_resolution_clock;
+
+    constexpr uint32_t entityCount{ 500'000 };
+    // Entities are spread over a cube of this size, with cells of the
+    // same size as the query radius
+    constexpr float    worldSize{ 200.0f };
+    constexpr float    radius{ 2.0f };
+    constexpr uint32_t gridSize{ (uint32_t)( worldSize / radius ) };
+    // Rows reordered per simulated frame
+    constexpr uint32_t rowsPerFrame{ 32 * 1024 };
+
+    double elapsedMs( clock_type::time_point start )
+    {
+        return std::chrono::duration<double, std::milli>( 
+                    clock_type::now() - start ).count();
+    }
+
+    uint32_t cellCoord( float v )
+    {
+        return std::min( (uint32_t)( v / radius ), gridSize - 1 );
+    }
+
+    uint32_t cellIndex( uint32_t x, uint32_t y, uint32_t z )
+    {
+        return ( z * gridSize + y ) * gridSize + x;
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    std::mt19937 rng{ 1234 };
+    std::uniform_real_distribution<float> dist{ 0.0f, worldSize };
+
+    utils::vector<transform::init_info> transforms( entityCount );
+    utils::vector<game_entity::entity_info> infos( entityCount );
+    for ( uint32_t i{ 0 }; i < entityCount; i++ )
+    {
+        transforms[ i ].position[ 0 ] = dist( rng );
+        transforms[ i ].position[ 1 ] = dist( rng );
+        transforms[ i ].position[ 2 ] = dist( rng );
+        infos[ i ].transform = &transforms[ i ];
+    }
+
+    m_Entities.resize( entityCount );
+    game_entity::createGameEntities( infos, m_Entities );
+    buildGrid();
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    clock_type::time_point start{ clock_type::now() };
+    const uint64_t before{ queryNeighbours() };
+    const double unsortedTime{ elapsedMs( start ) };
+
+    // Spread the reordering over frames like a background task would
+    uint32_t frames{ 0 };
+    start = clock_type::now();
+    while ( !transform::spatialSortStep( rowsPerFrame ) )
+    {
+        frames++;
+    }
+    const double sortTime{ elapsedMs( start ) };
+
+    start = clock_type::now();
+    const uint64_t after{ queryNeighbours() };
+    const double sortedTime{ elapsedMs( start ) };
+
+    // The entities didn't change, only where they are stored
+    assert( before == after );
+    for ( uint32_t i{ 0 }; i < entityCount; i++ )
+    {
+        assert( game_entity::isAlive( m_Entities[ i ] ) );
+    }
+
+    std::cout << "neighbour query (" << entityCount << " entities, " 
+              << after << " pairs)\n"
+              << "  creation order: " << unsortedTime << " ms\n"
+              << "  morton order:   " << sortedTime << " ms\n"
+              << "  reordering took " << frames + 1 << " frames of " 
+              << rowsPerFrame << " rows, " << sortTime << " ms\n";
+
+    // A second pass finds everything in order
+    start = clock_type::now();
+    while ( !transform::spatialSortStep( rowsPerFrame ) ) { }
+    std::cout << "  sorted pass:    " << elapsedMs( start ) << " ms\n";
+}
+
+void engineTest::shutdown( void ) 
+{
+    game_entity::removeGameEntities( m_Entities );
+}
+
+void engineTest::buildGrid( void )
+{
+    const uint32_t cellCount{ gridSize * gridSize * gridSize };
+    utils::vector<uint32_t> cells( entityCount );
+    m_CellStart.resize( cellCount + 1, 0 );
+    for ( uint32_t i{ 0 }; i < entityCount; i++ )
+    {
+        const math::fv3d p{ m_Entities[ i ].getTransform().getPosition() };
+        cells[ i ] = cellIndex( cellCoord( p.x ), cellCoord( p.y ), cellCoord( p.z ) );
+        m_CellStart[ cells[ i ] + 1 ]++;
+    }
+    for ( uint32_t c{ 0 }; c < cellCount; c++ )
+    {
+        m_CellStart[ c + 1 ] += m_CellStart[ c ];
+    }
+
+    utils::vector<uint32_t> offsets{ m_CellStart };
+    m_CellEntities.resize( entityCount );
+    for ( uint32_t i{ 0 }; i < entityCount; i++ )
+    {
+        m_CellEntities[ offsets[ cells[ i ] ]++ ] = m_Entities[ i ].getId();
+    }
+}
+
+uint64_t engineTest::queryNeighbours( void )
+{
+    uint64_t pairs{ 0 };
+    transform::forEachTransform( 
+        [&]( const id::id_type*, const math::fv3d* positions, 
+             const math::fv4d*, const math::fv3d*, uint32_t count )
+        {
+            for ( uint32_t i{ 0 }; i < count; i++ )
+            {
+                const math::fv3d& p{ positions[ i ] };
+                const uint32_t cx{ cellCoord( p.x ) };
+                const uint32_t cy{ cellCoord( p.y ) };
+                const uint32_t cz{ cellCoord( p.z ) };
+                for ( uint32_t z{ cz ? cz - 1 : 0 }; z <= std::min( cz + 1, gridSize - 1 ); z++ )
+                for ( uint32_t y{ cy ? cy - 1 : 0 }; y <= std::min( cy + 1, gridSize - 1 ); y++ )
+                for ( uint32_t x{ cx ? cx - 1 : 0 }; x <= std::min( cx + 1, gridSize - 1 ); x++ )
+                {
+                    const uint32_t c{ cellIndex( x, y, z ) };
+                    for ( uint32_t n{ m_CellStart[ c ] }; n < m_CellStart[ c + 1 ]; n++ )
+                    {
+                        const math::fv3d& q{ *ecs::getComponent<transform::position>( 
+                                                    m_CellEntities[ n ] ) };
+                        const float dx{ q.x - p.x };
+                        const float dy{ q.y - p.y };
+                        const float dz{ q.z - p.z };
+                        pairs += ( dx * dx + dy * dy + dz * dz ) < radius * radius;
+                    }
+                }
+            }
+        } );
+    return pairs;
+}
+
+#endif
@@ -0,0 +1,40 @@
+//********************************************************************
+//  File:    testSpatialSort.h
+//  Date:    Sun, 18 Oct 2026: 11:05
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_SPATIAL_SORT_H)
+#define TEST_SPATIAL_SORT_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Buckets all entities into a uniform grid by position
+    void buildGrid( void );
+    // Counts the neighbours within the query radius of every entity,
+    // visiting the entities in storage order. Positions of neighbours
+    // are read through the entity, ie with random access into storage
+    uint64_t queryNeighbours( void );
+
+    muggy::utils::vector<muggy::game_entity::entity>    m_Entities;
+    // Entities sorted by grid cell, where the entities of cell c are
+    // m_CellEntities[ m_CellStart[ c ] ] until m_CellStart[ c + 1 ]
+    muggy::utils::vector<uint32_t>                      m_CellStart;
+    muggy::utils::vector<muggy::id::id_type>            m_CellEntities;
+};
+
+
+#endif
@@ -0,0 +1,289 @@
+//********************************************************************
+//  File:    testTags.cpp
+//  Date:    Sun, 18 Oct 2026: 00:31
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_TAGS
+#include "testTags.h"
+#include "../../muggy/code/components/commandBuffer.h"
+#include "../../muggy/code/components/prefab.h"
+#include "../../muggy/code/components/snapshot.h"
+#include "../../muggy/code/components/world.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+using namespace muggy;
+
+namespace
+{
+    using clock_type = std::chrono::high_resolution_clock;
+
+    constexpr uint32_t entityCount{ 1'000'000 };
+    constexpr uint32_t recycledCount{ 50'000 };
+    constexpr uint32_t instanceCount{ 100 };
+    constexpr uint32_t timingRuns{ 10 };
+    const char* const snapshotPath{ "testTags.snapshot" };
+
+    struct enemy {};
+    struct networked {};
+    struct static_geometry {};
+
+    std::mt19937 rng{ 5 };
+
+    double elapsedMs( clock_type::time_point start )
+    {
+        return std::chrono::duration<double, std::milli>( 
+                    clock_type::now() - start ).count();
+    }
+
+    // Counts the alive entities with all tags of "all" and none of
+    // "none", one getTags() at a time
+    uint32_t countByEntity( ecs::tag_mask all, ecs::tag_mask none )
+    {
+        uint32_t count{ 0 };
+        game_entity::forEachAlive( [&]( game_entity::entity e )
+                                   {
+                                       const ecs::tag_mask tags{ ecs::getTags( e.getId() ) };
+                                       count += ( tags & all ) == all && !( tags & none );
+                                   } );
+        return count;
+    }
+
+    bool report( const char* name, bool ok )
+    {
+        std::cout << name << ": " << ( ok ? "ok" : "FAILED" ) << std::endl;
+        return ok;
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    // Every entity gets a random combination of the three tags
+    const ecs::tag_mask tagMasks[]{ ecs::tagMask<enemy>(), ecs::tagMask<networked>(),
+                                    ecs::tagMask<static_geometry>() };
+    utils::vector<transform::init_info> transforms( entityCount );
+    utils::vector<game_entity::entity_info> infos( entityCount );
+    for ( uint32_t i{ 0 }; i < entityCount; i++ )
+    {
+        const uint32_t r{ (uint32_t)rng() };
+        infos[ i ].transform = &transforms[ i ];
+        for ( uint32_t t{ 0 }; t < 3; t++ )
+        {
+            infos[ i ].tags |= ( ( r >> t ) & 1 ) ? tagMasks[ t ] : 0;
+        }
+    }
+    m_Entities.resize( entityCount );
+    game_entity::createGameEntities( infos, m_Entities );
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    bool ok{ true };
+    ok = report( "filter", checkFilter() ) && ok;
+    ok = report( "command buffer", checkCommandBuffer() ) && ok;
+    ok = report( "prefab", checkPrefab() ) && ok;
+    ok = report( "snapshot", checkSnapshot() ) && ok;
+    assert( ok );
+}
+
+void engineTest::shutdown( void ) 
+{
+    utils::vector<game_entity::entity> alive;
+    game_entity::forEachAlive( [&]( game_entity::entity e ) { alive.push_back( e ); } );
+    game_entity::removeGameEntities( alive );
+    m_Entities.clear();
+}
+
+bool engineTest::checkFilter( void )
+{
+    const ecs::tag_mask all{ ecs::tagMask<enemy, networked>() };
+    const ecs::tag_mask none{ ecs::tagMask<static_geometry>() };
+
+    // Remove some entities and tag some others
+    for ( uint32_t i{ 0 }; i < entityCount / 10; i++ )
+    {
+        const game_entity::entity e{ m_Entities[ rng() % entityCount ] };
+        if ( game_entity::isAlive( e ) )
+        {
+            game_entity::removeGameEntity( e );
+        }
+    }
+    for ( uint32_t i{ 0 }; i < entityCount / 10; i++ )
+    {
+        const game_entity::entity e{ m_Entities[ rng() % entityCount ] };
+        if ( game_entity::isAlive( e ) )
+        {
+            ecs::addTag<enemy>( e.getId() );
+        }
+    }
+
+    // Removed entities lose their tags, so recycled ids start untagged
+    transform::init_info transformInfo{};
+    const utils::vector<game_entity::entity_info> infos( recycledCount, 
+                                                         game_entity::entity_info{ &transformInfo } );
+    utils::vector<game_entity::entity> recycled( recycledCount );
+    game_entity::createGameEntities( infos, recycled );
+    bool ok{ true };
+    for ( const game_entity::entity e : recycled )
+    {
+        ok = ok && !ecs::getTags( e.getId() );
+    }
+
+    const uint32_t expected{ countByEntity( all, none ) };
+    uint32_t visited{ 0 };
+    game_entity::forEachTagged( all, none, [&]( game_entity::entity e )
+                                {
+                                    const ecs::tag_mask tags{ ecs::getTags( e.getId() ) };
+                                    ok = ok && ( tags & all ) == all && !( tags & none );
+                                    visited++;
+                                } );
+    ok = ok && visited == expected && ecs::countTagged( all, none ) == expected &&
+         ecs::countTagged( 0 ) == countByEntity( 0, 0 );
+
+    // The same filter over one byte of flags per entity index, ie
+    // what a bool per tag in a component would cost at best
+    utils::vector<uint8_t> flags( entityCount );
+    for ( uint32_t i{ 0 }; i < entityCount; i++ )
+    {
+        const game_entity::entity e{ m_Entities[ i ] };
+        flags[ i ] = game_entity::isAlive( e ) ? (uint8_t)ecs::getTags( e.getId() ) : 0;
+    }
+
+    clock_type::time_point start{ clock_type::now() };
+    uint32_t counted{ 0 };
+    for ( uint32_t r{ 0 }; r < timingRuns; r++ )
+    {
+        counted += ecs::countTagged( all, none );
+    }
+    const double countTime{ elapsedMs( start ) / timingRuns };
+
+    utils::bitset filtered;
+    start = clock_type::now();
+    for ( uint32_t r{ 0 }; r < timingRuns; r++ )
+    {
+        ecs::filterTags( all, none, filtered );
+    }
+    const double filterTime{ elapsedMs( start ) / timingRuns };
+
+    start = clock_type::now();
+    uint32_t flagged{ 0 };
+    for ( uint32_t r{ 0 }; r < timingRuns; r++ )
+    {
+        for ( uint32_t i{ 0 }; i < entityCount; i++ )
+        {
+            const uint8_t f{ flags[ i ] };
+            if ( ( f & all ) == all && !( f & none ) )
+            {
+                flagged++;
+            }
+        }
+    }
+    const double flagTime{ elapsedMs( start ) / timingRuns };
+
+    start = clock_type::now();
+    const uint32_t byEntity{ countByEntity( all, none ) };
+    const double byEntityTime{ elapsedMs( start ) };
+
+    std::cout << entityCount << " entities, " << expected << " tagged enemy and networked "
+              << "but not static\n"
+              << "  countTagged():          " << countTime << " ms\n"
+              << "  filterTags():           " << filterTime << " ms\n"
+              << "  flag byte per entity:   " << flagTime << " ms\n"
+              << "  getTags() per entity:   " << byEntityTime << " ms" << std::endl;
+
+    // Recycled entities have no flags in the byte array, but can't
+    // match anyway since they are untagged
+    return ok && counted == expected * timingRuns && flagged == expected * timingRuns &&
+           byEntity == expected;
+}
+
+bool engineTest::checkCommandBuffer( void )
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    const ecs::tag_mask tags{ ecs::tagMask<enemy, networked>() };
+    transform::init_info transformInfo{};
+    game_entity::command_buffer& commands{ game_entity::getCommandBuffer() };
+    const game_entity::entity tagged{ commands.create( transformInfo, tags ) };
+    const game_entity::entity untagged{ commands.create( transformInfo ) };
+    game_entity::flushCommandBuffers();
+    return ecs::getTags( tagged.getId() ) == tags && !ecs::getTags( untagged.getId() ) &&
+           ecs::countTagged( tags ) == 1;
+}
+
+bool engineTest::checkPrefab( void )
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    game_entity::prefab p{};
+    transform::init_info transformInfo{};
+    const uint32_t root{ p.addNode( transformInfo ) };
+    const uint32_t child{ p.addNode( transformInfo, root ) };
+    p.setTags( root, ecs::tagMask<enemy>() );
+    p.setTags( child, ecs::tagMask<networked, static_geometry>() );
+    const game_entity::prefab_id id{ game_entity::registerPrefab( p ) };
+
+    utils::vector<game_entity::entity> entities( instanceCount * 2 );
+    game_entity::instantiate( id, instanceCount, {}, entities );
+    game_entity::unregisterPrefab( id );
+
+    bool ok{ true };
+    for ( uint32_t i{ 0 }; i < instanceCount; i++ )
+    {
+        ok = ok && ecs::getTags( entities[ i * 2 + root ].getId() ) == ecs::tagMask<enemy>() &&
+             ecs::getTags( entities[ i * 2 + child ].getId() ) == 
+                ecs::tagMask<networked, static_geometry>();
+    }
+    return ok && ecs::countTagged( ecs::tagMask<enemy>() ) == instanceCount;
+}
+
+bool engineTest::checkSnapshot( void )
+{
+    // A small world with a random tag mix and some holes
+    utils::vector<game_entity::entity> saved;
+    utils::vector<ecs::tag_mask> savedTags;
+    {
+        ecs::world world{};
+        ecs::world_scope scope{ world };
+        transform::init_info transformInfo{};
+        for ( uint32_t i{ 0 }; i < 1'000; i++ )
+        {
+            game_entity::entity_info info{ &transformInfo };
+            info.tags = rng() & ecs::tagMask<enemy, networked, static_geometry>();
+            saved.push_back( game_entity::createGameEntity( info ) );
+        }
+        for ( uint32_t i{ 0 }; i < saved.size(); i += 3 )
+        {
+            game_entity::removeGameEntity( saved[ i ] );
+        }
+        for ( const game_entity::entity e : saved )
+        {
+            savedTags.push_back( game_entity::isAlive( e ) ? ecs::getTags( e.getId() ) : 0 );
+        }
+        if ( !game_entity::saveSnapshot( snapshotPath ) )
+        {
+            return false;
+        }
+    }
+
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    bool ok{ game_entity::loadSnapshot( snapshotPath ) };
+    std::remove( snapshotPath );
+    for ( uint32_t i{ 0 }; i < saved.size() && ok; i++ )
+    {
+        const bool alive{ game_entity::isAlive( saved[ i ] ) };
+        ok = alive == ( i % 3 != 0 ) && ( !alive || ecs::getTags( saved[ i ].getId() ) == savedTags[ i ] );
+    }
+    return ok;
+}
+
+#endif
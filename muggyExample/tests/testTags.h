@@ -0,0 +1,41 @@
+//********************************************************************
+//  File:    testTags.h
+//  Date:    Sun, 18 Oct 2026: 00:20
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_TAGS_H)
+#define TEST_TAGS_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+#include "../../muggy/code/components/tags.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Compares countTagged() and forEachTagged() with getTags() on
+    // every alive entity, and times them against a loop over one flag
+    // byte per entity
+    bool checkFilter( void );
+    // Tags recorded with command_buffer::create() are set on flush
+    bool checkCommandBuffer( void );
+    // Every instance of a prefab node gets the tags of the node
+    bool checkPrefab( void );
+    // Tags survive saving and loading a snapshot
+    bool checkSnapshot( void );
+
+    muggy::utils::vector<muggy::game_entity::entity>    m_Entities;
+};
+
+
+#endif
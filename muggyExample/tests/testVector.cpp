@@ -0,0 +1,406 @@
+//********************************************************************
+//  File:    testVector.cpp
+//  Date:    Tue, 20 Oct 2026: 17:12
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_VECTOR
+#include "testVector.h"
+
+#include <iostream>
+#include <chrono>
+#include <iterator>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define USE_SSE_SWEEP       1
+#include <immintrin.h>
+#else
+#define USE_SSE_SWEEP       0
+#endif
+
+using namespace muggy;
+
+namespace
+{
+    using clock_type = std::chrono::high_resolution_clock;
+
+    // From L1 resident to well past the last level cache
+    constexpr uint32_t vectorCounts[]{ 1'024, 64 * 1'024, 4 * 1'024 * 1'024 };
+    // Every sweep touches about this many vectors in total
+    constexpr uint64_t sweepVectors{ 64 * 1'024 * 1'024 };
+    // Positions in the growth test, 192 MiB per column
+    constexpr uint32_t growthCount{ 16 * 1'024 * 1'024 };
+    constexpr uint32_t randomReads{ 4 * 1'024 * 1'024 };
+
+    double elapsedNs( clock_type::time_point start )
+    {
+        return (double)std::chrono::duration_cast<std::chrono::nanoseconds>( 
+                            clock_type::now() - start ).count();
+    }
+
+    // Allocator that counts its calls, standing in for an arena
+    struct counting_allocator : utils::heap_allocator<32>
+    {
+        uint32_t* calls{ nullptr };
+
+        void* reallocate( void* data, uint64_t used, uint64_t size )
+        {
+            ( *calls )++;
+            return heap_allocator::reallocate( data, used, size );
+        }
+    };
+
+    // Item that points to itself, so an item that is moved as bytes
+    // is caught, and that counts what happens to it
+    struct tracked
+    {
+        static inline int64_t   live{ 0 };
+        static inline uint32_t  copies{ 0 };
+        static inline uint32_t  moves{ 0 };
+
+        tracked( uint32_t v = 0 ) : value( v ) { live++; }
+        tracked( const tracked& other ) : value( other.value ) { live++; copies++; }
+        tracked( tracked&& other ) noexcept : value( other.value ) { live++; moves++; }
+        tracked& operator=( const tracked& other ) { value = other.value; copies++; return *this; }
+        tracked& operator=( tracked&& other ) noexcept { value = other.value; moves++; return *this; }
+        ~tracked() { assert( self == this ); live--; }
+
+        [[nodiscard]] bool isValid() const { return self == this; }
+
+        uint32_t        value{ 0 };
+        const tracked*  self{ this };
+    };
+
+    static_assert( !utils::is_trivially_relocatable_v<tracked> );
+
+    utils::vector<tracked> makeTracked( uint32_t count )
+    {
+        utils::vector<tracked> v;
+        for ( uint32_t i{ 0 }; i < count; i++ )
+        {
+            v.emplace_back( i );
+        }
+        return v;
+    }
+
+    // Items are valid and hold the expected values in order
+    template <typename F>
+    bool isIntact( const utils::vector<tracked>& v, F&& expected )
+    {
+        bool ok{ (int64_t)v.size() <= tracked::live };
+        for ( uint32_t i{ 0 }; i < v.size(); i++ )
+        {
+            ok &= v[ i ].isValid() && v[ i ].value == expected( i );
+        }
+        return ok;
+    }
+
+    template <typename V>
+    bool isAligned( const V& v, uint32_t alignment )
+    {
+        return ( (uintptr_t)v.data() & ( alignment - 1 ) ) == 0;
+    }
+
+    template <bool aligned>
+    void sweep( const float* a, const float* b, float* out, uint32_t floatCount )
+    {
+        uint32_t i{ 0 };
+#if USE_SSE_SWEEP
+#if defined(__AVX__)
+        const __m256 s8{ _mm256_set1_ps( 0.5f ) };
+        for ( ; i + 8 <= floatCount; i += 8 )
+        {
+            if constexpr ( aligned )
+            {
+                _mm256_store_ps( out + i, _mm256_add_ps( _mm256_mul_ps( _mm256_load_ps( a + i ), s8 ),
+                                                         _mm256_load_ps( b + i ) ) );
+            }
+            else
+            {
+                _mm256_storeu_ps( out + i, _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( a + i ), s8 ),
+                                                          _mm256_loadu_ps( b + i ) ) );
+            }
+        }
+#endif
+        const __m128 s4{ _mm_set1_ps( 0.5f ) };
+        for ( ; i + 4 <= floatCount; i += 4 )
+        {
+            if constexpr ( aligned )
+            {
+                _mm_store_ps( out + i, _mm_add_ps( _mm_mul_ps( _mm_load_ps( a + i ), s4 ),
+                                                   _mm_load_ps( b + i ) ) );
+            }
+            else
+            {
+                _mm_storeu_ps( out + i, _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( a + i ), s4 ),
+                                                    _mm_loadu_ps( b + i ) ) );
+            }
+        }
+#endif
+        for ( ; i < floatCount; i++ )
+        {
+            out[ i ] = a[ i ] * 0.5f + b[ i ];
+        }
+    }
+
+    // Sums "randomReads" positions at pseudo random indices, which
+    // mostly miss both the cache and the TLB
+    template <typename V>
+    double timeRandomReads( const V& v, float& sum )
+    {
+        clock_type::time_point start{ clock_type::now() };
+        uint32_t index{ 1 };
+        const uint32_t mask{ (uint32_t)v.size() - 1 };
+        for ( uint32_t i{ 0 }; i < randomReads; i++ )
+        {
+            index = index * 1'664'525u + 1'013'904'223u;
+            sum += v[ index & mask ].x;
+        }
+        return elapsedNs( start ) / randomReads;
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    if ( !checkAllocators() )
+    {
+        std::cout << "Allocator checks failed" << std::endl;
+        return false;
+    }
+    if ( !checkRelocation() )
+    {
+        std::cout << "Relocation checks failed" << std::endl;
+        return false;
+    }
+
+    // One extra item, so the misaligned sweep can start a float in
+    const uint32_t maxCount{ vectorCounts[ std::size( vectorCounts ) - 1 ] + 1 };
+    m_A.resize( maxCount );
+    m_B.resize( maxCount );
+    m_Out.resize( maxCount );
+    for ( uint32_t i{ 0 }; i < maxCount; i++ )
+    {
+        m_A[ i ] = math::fv4d( (float)i, 1.0f, 2.0f, 3.0f );
+        m_B[ i ] = math::fv4d( 1.0f, (float)i, 3.0f, 4.0f );
+    }
+
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+#if defined(__AVX__)
+    std::cout << "Sweeps use AVX\n";
+#elif USE_SSE_SWEEP
+    std::cout << "Sweeps use SSE\n";
+#endif
+    for ( uint32_t count : vectorCounts )
+    {
+        runSweeps( count );
+    }
+    runGrowth( growthCount );
+}
+
+void engineTest::shutdown( void ) 
+{
+}
+
+bool engineTest::checkAllocators()
+{
+    bool ok{ true };
+
+    // Growing must keep the items and the alignment
+    aligned_vector v;
+    for ( uint32_t i{ 0 }; i < 10'000; i++ )
+    {
+        v.emplace_back( (float)i, 0.0f, 0.0f, 0.0f );
+        ok &= isAligned( v, 64 );
+    }
+    for ( uint32_t i{ 0 }; i < v.size(); i++ )
+    {
+        ok &= ( v[ i ].x == (float)i );
+    }
+
+    // Over-aligned types get their alignment with the default allocator
+    struct alignas( 64 ) cache_line { uint32_t value; };
+    utils::vector<cache_line> lines;
+    for ( uint32_t i{ 0 }; i < 1'000; i++ )
+    {
+        lines.push_back( { i } );
+        ok &= isAligned( lines, 64 );
+    }
+    for ( uint32_t i{ 0 }; i < lines.size(); i++ )
+    {
+        ok &= ( lines[ i ].value == i );
+    }
+
+    // A stateful allocator is copied into the vector and used for all
+    // allocations
+    uint32_t calls{ 0 };
+    counting_allocator allocator;
+    allocator.calls = &calls;
+    utils::vector<float, true, counting_allocator> counted( allocator );
+    counted.resize( 100 );
+    counted.reserve( 1'000 );
+    ok &= ( calls == 2 ) && isAligned( counted, 32 );
+    utils::vector<float, true, counting_allocator> copy( counted );
+    ok &= ( calls == 3 ) && ( copy.size() == 100 );
+
+    // Growing a vm_vector never moves the items
+    utils::vm_vector<uint32_t> stable( 1'000'000 );
+    stable.push_back( 0 );
+    const uint32_t *const first{ &stable[ 0 ] };
+    for ( uint32_t i{ 1 }; i < 1'000'000; i++ )
+    {
+        stable.push_back( i );
+    }
+    ok &= ( first == stable.data() ) && ( stable.back() == 999'999 );
+    stable.resize( 10 );
+    stable.shrink_to_fit();
+    ok &= ( stable.capacity() >= 10 ) && ( stable.capacity() < 1'000'000 );
+
+    return ok;
+}
+
+bool engineTest::checkRelocation()
+{
+    bool ok{ true };
+    {
+        // Growing moves the items, it never copies them
+        utils::vector<tracked> v;
+        for ( uint32_t i{ 0 }; i < 1'000; i++ )
+        {
+            v.push_back( tracked{ i } );
+        }
+        ok &= isIntact( v, []( uint32_t i ) { return i; } ) && 
+              !tracked::copies && tracked::live == 1'000;
+
+        // Erasing in the middle keeps the order
+        tracked *const next{ v.erase( 10 ) };
+        ok &= next == &v[ 10 ] && v.size() == 999 && tracked::live == 999;
+        ok &= isIntact( v, []( uint32_t i ) { return i < 10 ? i : i + 1; } );
+
+        // Erasing unordered moves the last item into the hole
+        tracked *const hole{ v.erase_unordered( 5 ) };
+        ok &= hole == &v[ 5 ] && v[ 5 ].value == 999 && v.size() == 998 && 
+              tracked::live == 998;
+        ok &= isIntact( v, []( uint32_t i ) { return i == 5 ? 999 : ( i < 10 ? i : i + 1 ); } );
+        v.erase_unordered( v.size() - 1 );
+        v.erase( v.size() - 1 );
+        ok &= v.size() == 996 && tracked::live == 996 && !tracked::copies;
+
+        // Moving from a temporary takes over its items
+        tracked::moves = 0;
+        utils::vector<tracked> moved{ makeTracked( 100 ) };
+        const uint32_t growMoves{ tracked::moves };
+        moved = makeTracked( 100 );
+        ok &= tracked::moves == growMoves * 2 && !tracked::copies;
+        ok &= isIntact( moved, []( uint32_t i ) { return i; } ) && tracked::live == 1'096;
+
+        // Copies copy every item
+        const utils::vector<tracked> copy{ moved };
+        ok &= tracked::copies == 100 && isIntact( copy, []( uint32_t i ) { return i; } );
+    }
+    ok &= !tracked::live;
+
+    // Short strings keep their characters inside the object, so they
+    // can't be moved as bytes either
+    utils::vector<std::string> strings;
+    for ( uint32_t i{ 0 }; i < 1'000; i++ )
+    {
+        strings.push_back( std::to_string( i ) );
+    }
+    strings.erase( uint64_t{ 0 } );
+    strings.erase_unordered( uint64_t{ 0 } );
+    ok &= strings.size() == 998 && strings[ 0 ] == "999" && strings[ 1 ] == "2" &&
+          strings[ 997 ] == "998";
+    for ( uint32_t i{ 1 }; i < strings.size() - 1; i++ )
+    {
+        ok &= strings[ i ] == std::to_string( i + 1 );
+    }
+    return ok;
+}
+
+void engineTest::runSweeps( uint32_t count )
+{
+    const uint32_t floatCount{ count * 4 };
+    const uint32_t repeats{ (uint32_t)std::max<uint64_t>( sweepVectors / count, 1 ) };
+    const float *const a{ (const float*)m_A.data() };
+    const float *const b{ (const float*)m_B.data() };
+    float *const out{ (float*)m_Out.data() };
+
+    clock_type::time_point start{ clock_type::now() };
+    for ( uint32_t r{ 0 }; r < repeats; r++ )
+    {
+        sweep<true>( a, b, out, floatCount );
+    }
+    const double alignedTime{ elapsedNs( start ) };
+
+    start = clock_type::now();
+    for ( uint32_t r{ 0 }; r < repeats; r++ )
+    {
+        sweep<false>( a, b, out, floatCount );
+    }
+    const double unalignedLoadTime{ elapsedNs( start ) };
+
+    // Starting one float in makes every 32-byte load straddle two 
+    // vectors and every other 64-byte line
+    start = clock_type::now();
+    for ( uint32_t r{ 0 }; r < repeats; r++ )
+    {
+        sweep<false>( a + 1, b + 1, out + 1, floatCount );
+    }
+    const double misalignedTime{ elapsedNs( start ) };
+
+    const double vectors{ (double)count * repeats };
+    std::cout << count << " vectors: "
+              << "aligned " << alignedTime / vectors << " ns/vector, "
+              << "unaligned loads " << unalignedLoadTime / vectors << " ns/vector, "
+              << "misaligned data " << misalignedTime / vectors << " ns/vector\n";
+}
+
+void engineTest::runGrowth( uint32_t count )
+{
+    // Must be a power of two for the random reads
+    assert( ( count & ( count - 1 ) ) == 0 );
+    float sum{ 0.0f };
+
+    {
+        utils::vector<math::fv3d> v;
+        uint32_t moves{ 0 };
+        clock_type::time_point start{ clock_type::now() };
+        for ( uint32_t i{ 0 }; i < count; i++ )
+        {
+            const math::fv3d *const data{ v.data() };
+            v.emplace_back( (float)i, 0.0f, 0.0f );
+            moves += ( data && data != v.data() );
+        }
+        const double growTime{ elapsedNs( start ) };
+        std::cout << "vector growth: " << growTime / count << " ns/item, "
+                  << moves << " moves, random reads " 
+                  << timeRandomReads( v, sum ) << " ns\n";
+    }
+
+    for ( bool hugePages : { false, true } )
+    {
+        utils::vm_vector<math::fv3d> v( count, hugePages );
+        clock_type::time_point start{ clock_type::now() };
+        for ( uint32_t i{ 0 }; i < count; i++ )
+        {
+            v.emplace_back( (float)i, 0.0f, 0.0f );
+        }
+        const double growTime{ elapsedNs( start ) };
+        std::cout << ( hugePages ? "vm_vector growth, huge pages: " : "vm_vector growth: " )
+                  << growTime / count << " ns/item, random reads " 
+                  << timeRandomReads( v, sum ) << " ns\n";
+    }
+
+    // Keeps the reads from being optimized away
+    std::cout << "(" << sum << ")\n";
+}
+
+#endif
@@ -0,0 +1,50 @@
+//********************************************************************
+//  File:    testVector.h
+//  Date:    Tue, 20 Oct 2026: 17:05
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_VECTOR_H)
+#define TEST_VECTOR_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/utilities/vector.h"
+#include "../../muggy/code/utilities/vmVector.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Grows vectors with different allocators and checks that the
+    // items are aligned and kept
+    bool checkAllocators();
+    // Grows, erases from and moves vectors of items that aren't
+    // trivially relocatable and checks that every item is moved with
+    // its move constructor or assignment and destructed exactly once
+    bool checkRelocation();
+    // Times out[ i ] = a[ i ] * s + b[ i ] over "count" vectors with
+    // aligned loads, unaligned loads of aligned data and unaligned
+    // loads of data that is off by one float
+    void runSweeps( uint32_t count );
+    // Times growing a column of "count" positions one at a time with
+    // utils::vector and with vm_vector, with and without huge pages,
+    // and then random reads from the filled columns
+    void runGrowth( uint32_t count );
+
+    // Columns aligned for AVX loads and to cache lines
+    using aligned_vector = muggy::utils::vector<muggy::math::fv4d, true, 
+                                                muggy::utils::heap_allocator<64>>;
+    aligned_vector  m_A;
+    aligned_vector  m_B;
+    aligned_vector  m_Out;
+};
+
+
+#endif
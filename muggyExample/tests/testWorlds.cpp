@@ -0,0 +1,160 @@
+//********************************************************************
+//  File:    testWorlds.cpp
+//  Date:    Sun, 18 Oct 2026: 18:52
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_WORLDS
+#include "testWorlds.h"
+#include "../../muggy/code/components/commandBuffer.h"
+
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <thread>
+
+using namespace muggy;
+
+namespace
+{
+    using clock_type = std::chrono::high_resolution_clock;
+
+    constexpr uint32_t matchCount{ 8 };
+    constexpr uint32_t entitiesPerMatch{ 20'000 };
+    constexpr uint32_t framesPerRun{ 60 };
+    // Entities spawned and despawned per frame in every match
+    constexpr uint32_t churnPerFrame{ 100 };
+
+    double elapsedMs( clock_type::time_point start )
+    {
+        return std::chrono::duration<double, std::milli>( 
+                    clock_type::now() - start ).count();
+    }
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    for ( uint32_t m{ 0 }; m < matchCount; m++ )
+    {
+        m_Worlds.push_back( new ecs::world{} );
+        ecs::world_scope scope{ *m_Worlds[ m ] };
+        populate( m );
+    }
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    // All matches one after the other on this thread
+    clock_type::time_point start{ clock_type::now() };
+    for ( uint32_t m{ 0 }; m < matchCount; m++ )
+    {
+        ecs::world_scope scope{ *m_Worlds[ m ] };
+        tick( m );
+    }
+    const double serialTime{ elapsedMs( start ) };
+
+    // One thread per match
+    start = clock_type::now();
+    utils::vector<std::thread> threads;
+    for ( uint32_t m{ 0 }; m < matchCount; m++ )
+    {
+        threads.emplace_back( [this, m]()
+                              {
+                                  ecs::world_scope scope{ *m_Worlds[ m ] };
+                                  tick( m );
+                              } );
+    }
+    for ( std::thread& t : threads )
+    {
+        t.join();
+    }
+    const double parallelTime{ elapsedMs( start ) };
+
+    bool ok{ true };
+    for ( uint32_t m{ 0 }; m < matchCount; m++ )
+    {
+        ecs::world_scope scope{ *m_Worlds[ m ] };
+        ok = verify( m ) && ok;
+    }
+    assert( ok );
+
+    std::cout << matchCount << " matches of " << entitiesPerMatch 
+              << " entities, " << framesPerRun << " frames each\n"
+              << "  one thread:         " << serialTime << " ms\n"
+              << "  thread per match:   " << parallelTime << " ms\n"
+              << "  worlds independent: " << ( ok ? "yes" : "NO" ) << "\n";
+}
+
+void engineTest::shutdown( void ) 
+{
+    for ( ecs::world* w : m_Worlds )
+    {
+        delete w;
+    }
+    m_Worlds.clear();
+}
+
+void engineTest::populate( uint32_t match )
+{
+    // Every entity of a match is placed on the x = match plane, so
+    // entities leaking into another world are easy to spot
+    utils::vector<transform::init_info> transforms( entitiesPerMatch );
+    utils::vector<game_entity::entity_info> infos( entitiesPerMatch );
+    for ( uint32_t i{ 0 }; i < entitiesPerMatch; i++ )
+    {
+        transforms[ i ].position[ 0 ] = (float)match;
+        transforms[ i ].position[ 1 ] = (float)i;
+        infos[ i ].transform = &transforms[ i ];
+    }
+    utils::vector<game_entity::entity> entities( entitiesPerMatch );
+    game_entity::createGameEntities( infos, entities );
+}
+
+void engineTest::tick( uint32_t match )
+{
+    std::mt19937 rng{ match };
+    utils::vector<game_entity::entity> entities;
+    utils::vector<math::fv3d> positions;
+    for ( uint32_t f{ 0 }; f < framesPerRun; f++ )
+    {
+        entities.clear();
+        game_entity::forEachAlive( [&]( game_entity::entity e )
+                                   {
+                                       entities.push_back( e );
+                                   } );
+        positions.resize( entities.size() );
+        transform::getPositions( entities, positions );
+        for ( math::fv3d& p : positions )
+        {
+            p.z += 1.0f;
+        }
+        transform::setPositions( entities, positions );
+
+        game_entity::command_buffer& commands{ game_entity::getCommandBuffer() };
+        for ( uint32_t i{ 0 }; i < churnPerFrame; i++ )
+        {
+            commands.remove( entities[ rng() % entities.size() ] );
+            transform::init_info info{};
+            info.position[ 0 ] = (float)match;
+            commands.create( info );
+        }
+        game_entity::flushCommandBuffers();
+        transform::updateWorldMatrices();
+    }
+}
+
+bool engineTest::verify( uint32_t match )
+{
+    bool ok{ true };
+    game_entity::forEachAlive( [&]( game_entity::entity e )
+                               {
+                                   ok = ok && e.getTransform().getPosition().x == (float)match;
+                               } );
+    return ok;
+}
+
+#endif
@@ -0,0 +1,40 @@
+//********************************************************************
+//  File:    testWorlds.h
+//  Date:    Sun, 18 Oct 2026: 18:40
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_WORLDS_H)
+#define TEST_WORLDS_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+#include "../../muggy/code/components/world.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Creates the entities of one match in the world bound to the
+    // calling thread
+    void populate( uint32_t match );
+    // Simulates a number of frames of one match: moves every entity,
+    // spawns and despawns some through the command buffer and updates
+    // the world matrices
+    void tick( uint32_t match );
+    // Checks that the match only contains its own entities
+    bool verify( uint32_t match );
+
+    muggy::utils::vector<muggy::ecs::world*>        m_Worlds;
+};
+
+
+#endif
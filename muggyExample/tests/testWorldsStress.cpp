@@ -0,0 +1,144 @@
+//********************************************************************
+//  File:    testWorldsStress.cpp
+//  Date:    Sat, 17 Oct 2026: 21:12
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#include "test.h"
+#if TEST_WORLDS_STRESS
+#include "testWorldsStress.h"
+#include "../../muggy/code/components/commandBuffer.h"
+#include "../../muggy/code/components/componentPool.h"
+#include "../../muggy/code/components/query.h"
+
+#include <iostream>
+#include <random>
+#include <thread>
+
+using namespace muggy;
+
+namespace
+{
+    // Worlds live on threads of their own and are created and
+    // destroyed every round, so the id allocators and storages of
+    // several worlds are set up and torn down at the same time
+    constexpr uint32_t roundCount{ 8 };
+    constexpr uint32_t worldCount{ 8 };
+    constexpr uint32_t framesPerRound{ 100 };
+    constexpr uint32_t createdPerFrame{ 50 };
+    constexpr uint32_t commandsPerFrame{ 10 };
+    constexpr uint32_t removedPerFrame{ 20 };
+
+    struct health
+    {
+        uint32_t    value;
+    };
+} // namespace anonymous
+
+bool engineTest::initialize( void ) 
+{
+    return true;
+}
+
+void engineTest::run ( void ) 
+{
+    bool ok{ true };
+    for ( uint32_t r{ 0 }; r < roundCount; r++ )
+    {
+        bool worldOk[ worldCount ]{ };
+        uint32_t alive[ worldCount ]{ };
+        utils::vector<std::thread> threads;
+        for ( uint32_t w{ 0 }; w < worldCount; w++ )
+        {
+            threads.emplace_back( [&worldOk, &alive, w, r]()
+                                  {
+                                      alive[ w ] = simulate( r * worldCount + w + 1, worldOk[ w ] );
+                                  } );
+        }
+        for ( std::thread& t : threads )
+        {
+            t.join();
+        }
+
+        bool roundOk{ true };
+        for ( uint32_t w{ 0 }; w < worldCount; w++ )
+        {
+            roundOk = roundOk && worldOk[ w ];
+        }
+        // None of it may have ended up in the world of this thread
+        uint32_t defaultAlive{ 0 };
+        game_entity::forEachAlive( [&]( game_entity::entity ) { defaultAlive++; } );
+        roundOk = roundOk && !defaultAlive;
+
+        std::cout << "round " << r << ": " << worldCount << " worlds, " 
+                  << alive[ 0 ] << " entities in the first, "
+                  << ( roundOk ? "ok" : "FAILED" ) << std::endl;
+        ok = ok && roundOk;
+    }
+    assert( ok );
+}
+
+void engineTest::shutdown( void ) 
+{
+}
+
+uint32_t engineTest::simulate( uint32_t seed, bool& ok )
+{
+    ecs::world world{};
+    ecs::world_scope scope{ world };
+    ecs::component_pool<uint32_t> pool{};
+    std::mt19937 rng{ seed };
+    utils::vector<game_entity::entity> entities;
+
+    // Everything in this world carries the seed, in its position and
+    // in its components, so entities from other worlds stand out
+    transform::init_info transformInfo{};
+    transformInfo.position[ 0 ] = (float)seed;
+    const game_entity::entity_info entityInfo{ &transformInfo };
+    for ( uint32_t f{ 0 }; f < framesPerRound; f++ )
+    {
+        for ( uint32_t i{ 0 }; i < createdPerFrame; i++ )
+        {
+            const game_entity::entity e{ game_entity::createGameEntity( entityInfo ) };
+            entities.push_back( e );
+            pool.add( e.getId(), seed );
+            ecs::addComponent<health>( e.getId(), health{ seed } );
+        }
+
+        game_entity::command_buffer& commands{ game_entity::getCommandBuffer() };
+        for ( uint32_t i{ 0 }; i < commandsPerFrame; i++ )
+        {
+            commands.create( transformInfo );
+        }
+        for ( uint32_t i{ 0 }; i < removedPerFrame && !entities.empty(); i++ )
+        {
+            const uint32_t index{ (uint32_t)( rng() % entities.size() ) };
+            commands.remove( entities[ index ] );
+            utils::erase_unordered( entities, index );
+        }
+        game_entity::flushCommandBuffers();
+        transform::spatialSortStep( 1'000 );
+        transform::updateWorldMatrices();
+    }
+
+    ok = true;
+    uint32_t alive{ 0 };
+    game_entity::forEachAlive( [&]( game_entity::entity e )
+                               {
+                                   alive++;
+                                   ok = ok && e.getTransform().getPosition().x == (float)seed;
+                               } );
+    uint32_t healthCount{ 0 };
+    ecs::view<health>().each( [&]( id::id_type id, const health& h )
+                              {
+                                  healthCount++;
+                                  ok = ok && h.value == seed && pool.get( id ) == seed;
+                              } );
+    ok = ok && healthCount == entities.size() && pool.size() == entities.size();
+    ok = ok && alive == entities.size() + framesPerRound * commandsPerFrame;
+    return alive;
+}
+
+#endif
@@ -0,0 +1,34 @@
+//********************************************************************
+//  File:    testWorldsStress.h
+//  Date:    Sat, 17 Oct 2026: 21:05
+//  Version: 
+//  Author:  klek
+//  Notes:   
+//********************************************************************
+
+#if !defined(TEST_WORLDS_STRESS_H)
+#define TEST_WORLDS_STRESS_H
+
+#include "test.h"
+#include "../../muggy/code/common/common.h"
+#include "../../muggy/code/components/entity.h"
+#include "../../muggy/code/components/transform.h"
+#include "../../muggy/code/components/world.h"
+
+class engineTest : public test
+{
+public:
+    bool initialize( void ) override;
+    void run ( void ) override;
+    void shutdown( void ) override;
+
+private:
+    // Creates a world on the calling thread, churns entities, 
+    // components and command buffers in it and checks that it only
+    // holds its own entities before destroying it again. Returns the
+    // number of entities that were alive at the end
+    static uint32_t simulate( uint32_t seed, bool& ok );
+};
+
+
+#endif